@@ -0,0 +1,72 @@
+#ifndef IDSP_BENCHMARK_HELPERS_H
+#define IDSP_BENCHMARK_HELPERS_H
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace idsp
+{
+
+namespace _bench
+{
+    /** Stops the optimiser from discarding the computation of @a value. */
+    template<typename T>
+    inline void keep(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+} // namespace _bench
+
+/** Times @a iterations calls of @a func and prints the mean cost per call and
+ * per item, where each call processes @a items_per_call items (e.g. samples).
+ * The iterations are split into several rounds and the fastest round is
+ * reported, to reduce noise from the host scheduler.
+ * @returns The mean time per item in nanoseconds.
+ */
+template<typename F>
+static inline double benchmark(const std::string& name, size_t iterations, F&& func, size_t items_per_call = 1)
+{
+    using Clock = std::chrono::steady_clock;
+    constexpr size_t rounds = 8;
+    const size_t per_round = iterations / rounds + 1;
+
+    // Warm caches and branch predictors
+    for (size_t i = 0; i < per_round; i++)
+        func();
+
+    double best_ns = 0;
+    for (size_t r = 0; r < rounds; r++)
+    {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < per_round; i++)
+            func();
+        const auto end = Clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (r == 0 || ns < best_ns)
+            best_ns = ns;
+    }
+
+    const double per_call = best_ns / static_cast<double>(per_round);
+    const double per_item = per_call / static_cast<double>(items_per_call);
+
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << per_call << " ns/call"
+              << std::setw(10) << per_item << " ns/item"
+              << std::endl;
+
+    return per_item;
+}
+
+/** Prints a section header for a group of benchmarks. */
+static inline void benchmark_header(const std::string& title)
+{
+    std::cout << std::endl << "== " << title << " ==" << std::endl;
+}
+
+} // namespace idsp
+
+#endif
@@ -0,0 +1,375 @@
+// Per-sample vs block processing of the delay-line based processors.
+// The per-sample rows use the processor's single-sample call where it has
+// one, which is what every block call did before the block read/write API
+// existed. WowFlutter and VarispeedDelay only have block calls, so their
+// per-sample rows use blocks of one sample. The allpass banks are timed
+// against the two single processors they replace in the rooms' left and
+// right chains. The rooms and FDN reverbs
+// compare their frame processor with block processing at several block
+// sizes, the density of their impulse responses, and their CPU use on mostly
+// silent input with and without the silence bypass. The memory report gives
+// each room's RAM and the part of it in its delay arena.
+
+#include "idsp/delay.hpp"
+#include "idsp/mod_fx.hpp"
+#include "idsp/reverb.hpp"
+#include "idsp/reverb_toolkit.hpp"
+#include "idsp/random.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 100000;
+
+template<class S, class F>
+static void compare(const std::string& name, idsp::BufferInterface& block, S&& process_sample, F&& process)
+{
+    idsp::benchmark(name + " per-sample", iterations, [&]() {
+        for (auto& x : block)
+            process_sample(x);
+        idsp::_bench::keep(block[0]);
+    }, block.size());
+    idsp::benchmark(name + " block", iterations, [&]() {
+        process(block);
+        idsp::_bench::keep(block[0]);
+    }, block.size());
+}
+
+// Left and right allpasses as two single processors against one two-lane
+// bank, frame by frame and in blocks, in place on a stereo block
+template<class SF, class BF, class SB, class BB>
+static void lanes(const std::string& name, idsp::PolyBufferInterface& io,
+                  SF&& singles_frame, BF&& bank_frame, SB&& singles_block, BB&& bank_block)
+{
+    idsp::benchmark(name + " 2 singles per-sample", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            singles_frame(io[0][i], io[1][i]);
+        idsp::_bench::keep(io[0][0]);
+    }, dsp_block_size);
+    idsp::benchmark(name + " Bank<2> per-sample", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            std::array<Sample, 2> frame {io[0][i], io[1][i]};
+            bank_frame(frame.data());
+            io[0][i] = frame[0];
+            io[1][i] = frame[1];
+        }
+        idsp::_bench::keep(io[0][0]);
+    }, dsp_block_size);
+    idsp::benchmark(name + " 2 singles block", iterations, [&]() {
+        singles_block(io[0], io[1]);
+        idsp::_bench::keep(io[0][0]);
+    }, dsp_block_size);
+    idsp::benchmark(name + " Bank<2> block", iterations, [&]() {
+        bank_block(io);
+        idsp::_bench::keep(io[0][0]);
+    }, dsp_block_size);
+}
+
+// The stereo allpass stages of LargeRoom at 48 kHz
+static void banks(idsp::PolyBufferInterface& io)
+{
+    auto singles = std::make_unique<idsp::SampleBufferArena<384, 432, 2976, 2928, 4176, 4128, 1440, 1488, 3648, 3600, 5760, 5808>>();
+    auto lines = std::make_unique<idsp::SampleBufferArena<384, 432, 2976, 2928, 4176, 4128, 1440, 1488, 3648, 3600, 5760, 5808>>();
+    auto& s = *singles;
+    auto& l = *lines;
+
+    idsp::AllpassProcessor allpass_l(s[0]), allpass_r(s[1]);
+    idsp::AllpassBank<2> allpass(&l[0]);
+    lanes("Allpass", io,
+        [&](Sample& x_l, Sample& x_r) { x_l = allpass_l.process(x_l); x_r = allpass_r.process(x_r); },
+        [&](Sample* x) { allpass.process(x, x); },
+        [&](idsp::BufferInterface& x_l, idsp::BufferInterface& x_r) { allpass_l.process(x_l, x_l); allpass_r.process(x_r, x_r); },
+        [&](idsp::PolyBufferInterface& x) { allpass.process(x, x); });
+
+    idsp::NestedAllpassProcessor nested_l(s[2], s[4]), nested_r(s[3], s[5]);
+    idsp::NestedAllpassBank<2> nested(&l[2], &l[4]);
+    lanes("NestedAllpass", io,
+        [&](Sample& x_l, Sample& x_r) { x_l = nested_l.process(x_l); x_r = nested_r.process(x_r); },
+        [&](Sample* x) { nested.process(x, x); },
+        [&](idsp::BufferInterface& x_l, idsp::BufferInterface& x_r) { nested_l.process(x_l, x_l); nested_r.process(x_r, x_r); },
+        [&](idsp::PolyBufferInterface& x) { nested.process(x, x); });
+
+    idsp::DoubleNestedAllpassProcessor double_nested_l(s[6], s[8], s[10]), double_nested_r(s[7], s[9], s[11]);
+    idsp::DoubleNestedAllpassBank<2> double_nested(&l[6], &l[8], &l[10]);
+    lanes("DoubleNestedAllpass", io,
+        [&](Sample& x_l, Sample& x_r) { x_l = double_nested_l.process(x_l); x_r = double_nested_r.process(x_r); },
+        [&](Sample* x) { double_nested.process(x, x); },
+        [&](idsp::BufferInterface& x_l, idsp::BufferInterface& x_r) { double_nested_l.process(x_l, x_l); double_nested_r.process(x_r, x_r); },
+        [&](idsp::PolyBufferInterface& x) { double_nested.process(x, x); });
+}
+
+// Frame-by-frame against block processing of a room, in place. The silence
+// bypass is off, so the block rows time the network as the frame rows do.
+template<class Room, size_t BlockSize>
+static void room(const std::string& name)
+{
+    auto room = std::make_unique<Room>();
+    room->set_gain(Sample(0.5f));
+    room->set_dampening(0.5f);
+    room->set_silence_threshold(Sample(-1.f));
+    idsp::PolySampleBufferStatic<BlockSize, 2> buffer;
+    for (size_t i = 0; i < BlockSize; i++)
+    {
+        buffer[0][i] = Sample(0.25f * static_cast<float>(i % 13) / 13.f);
+        buffer[1][i] = Sample(0.25f * static_cast<float>(i % 7) / 7.f);
+    }
+    auto& io = buffer.interface();
+    const size_t iters = iterations * dsp_block_size / BlockSize / 4;
+    idsp::benchmark(name + " per-sample, block " + std::to_string(BlockSize), iters, [&]() {
+        for (size_t i = 0; i < BlockSize; i++)
+            room->process(io[0][i], io[1][i], io[0][i], io[1][i]);
+        idsp::_bench::keep(io[0][0]);
+    }, BlockSize);
+    idsp::benchmark(name + " block, block " + std::to_string(BlockSize), iters, [&]() {
+        room->template process_for<BlockSize>(io, io);
+        idsp::_bench::keep(io[0][0]);
+    }, BlockSize);
+}
+
+template<class Room>
+static void rooms(const std::string& name)
+{
+    room<Room, 32>(name);
+    room<Room, 64>(name);
+    room<Room, 256>(name);
+}
+
+// Normalised echo density of the left impulse response over 20 ms windows:
+// the fraction of samples beyond one standard deviation, relative to the
+// fraction for Gaussian noise. 1 means the tail is as dense as noise.
+template<class Room>
+static void echo_density(const std::string& name)
+{
+    auto room = std::make_unique<Room>();
+    room->set_gain(Sample(0.8f));
+    room->set_dampening(0.3f);
+    std::vector<float> response(48000);
+    for (size_t i = 0; i < response.size(); i++)
+    {
+        Sample l, r;
+        const Sample x = Sample(i == 0 ? 1.f : 0.f);
+        room->process(x, x, l, r);
+        response[i] = static_cast<float>(l);
+    }
+    std::cout << std::left << std::setw(48) << name;
+    for (size_t ms : {50, 100, 200, 400})
+    {
+        const size_t start = ms * 48, length = 20 * 48;
+        double power = 0;
+        for (size_t i = start; i < start + length; i++)
+            power += static_cast<double>(response[i]) * response[i];
+        const double deviation = std::sqrt(power / length);
+        size_t beyond = 0;
+        for (size_t i = start; i < start + length; i++)
+            beyond += std::fabs(response[i]) > deviation;
+        const double density = static_cast<double>(beyond) / length / std::erfc(1.0 / std::sqrt(2.0));
+        std::cout << std::right << std::setw(5) << ms << " ms: " << std::fixed << std::setprecision(2) << density;
+    }
+    std::cout << std::endl;
+}
+
+// Mean cost per stereo frame of an idle installation: each call plays thirty
+// seconds holding one 100 ms burst of noise, with the network always running
+// and with the silence bypass
+template<class Room>
+static void sparse(const std::string& name)
+{
+    constexpr size_t period = 30 * 48000;
+    constexpr size_t burst = 48000 / 10;
+    idsp::PolySampleBufferStatic<dsp_block_size, 2> buffer;
+    auto& io = buffer.interface();
+    idsp::WhiteNoise noise(1);
+    double always = 0;
+    for (bool bypass : {false, true})
+    {
+        auto room = std::make_unique<Room>();
+        room->set_gain(Sample(0.5f));
+        room->set_dampening(0.5f);
+        if (!bypass)
+            room->set_silence_threshold(Sample(-1.f));
+        const double ns = idsp::benchmark(name + (bypass ? " bypass" : " always running"), 8, [&]() {
+            for (size_t start = 0; start < period; start += dsp_block_size)
+            {
+                for (size_t c = 0; c < 2; c++)
+                    for (size_t i = 0; i < dsp_block_size; i++)
+                        io[c][i] = start < burst ? Sample(noise.bipolar() * 0.5f) : Sample(0);
+                room->template process_for<dsp_block_size>(io, io);
+            }
+            idsp::_bench::keep(io[0][0]);
+        }, period);
+        if (bypass)
+            std::cout << "  " << std::fixed << std::setprecision(1) << 100.0 * ns / always << "% of always running" << std::endl;
+        always = ns;
+    }
+}
+
+template<template<size_t> class Room>
+static void memory(const std::string& name)
+{
+    std::cout << std::left << std::setw(16) << name;
+    std::cout << std::right << std::setw(10) << sizeof(Room<32000>) << " (" << std::setw(6) << Room<32000>::arena_size * sizeof(Sample) << ")";
+    std::cout << std::right << std::setw(10) << sizeof(Room<44100>) << " (" << std::setw(6) << Room<44100>::arena_size * sizeof(Sample) << ")";
+    std::cout << std::right << std::setw(10) << sizeof(Room<48000>) << " (" << std::setw(6) << Room<48000>::arena_size * sizeof(Sample) << ")";
+    std::cout << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size));
+
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    for (size_t i = 0; i < dsp_block_size; i++)
+        buffer[i] = Sample(0.25f * static_cast<float>((i * 37) % 17) / 17.f);
+    auto block = buffer.interface();
+
+    idsp::Delay<idsp::SampleBufferStatic<4800>> delay;
+    compare("AudioRingBuffer::process", block,
+        [&](Sample& x) { x = delay->process(x); },
+        [&](idsp::BufferInterface& x) { delay->process(x, x); });
+
+    idsp::Allpass<idsp::SampleBufferStatic<441>> allpass;
+    compare("AllpassProcessor::process", block,
+        [&](Sample& x) { x = allpass->process(x); },
+        [&](idsp::BufferInterface& x) { allpass->process(x, x); });
+
+    idsp::NestedAllpass<idsp::SampleBufferStatic<1021>, idsp::SampleBufferStatic<331>> nested;
+    compare("NestedAllpassProcessor::process", block,
+        [&](Sample& x) { x = nested->process(x); },
+        [&](idsp::BufferInterface& x) { nested->process(x, x); });
+
+    idsp::DoubleNestedAllpass<idsp::SampleBufferStatic<1543>, idsp::SampleBufferStatic<331>, idsp::SampleBufferStatic<557>> double_nested;
+    compare("DoubleNestedAllpassProcessor::process", block,
+        [&](Sample& x) { x = double_nested->process(x); },
+        [&](idsp::BufferInterface& x) { double_nested->process(x, x); });
+
+    idsp::SampleBufferStatic<dsp_block_size> right_buffer;
+    std::array<idsp::BufferInterface, 2> stereo {block, right_buffer.interface()};
+    idsp::PolyBufferInterface poly(stereo.data(), 2);
+    banks(poly);
+
+    idsp::DiffuserRev2<48000> diffuser;
+    idsp::benchmark("DiffuserRev2 per-sample", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            diffuser.process(block[i], right_buffer[i], block[i], right_buffer[i]);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+    idsp::benchmark("DiffuserRev2 block", iterations, [&]() {
+        diffuser.process_for<dsp_block_size>(poly, poly);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+
+    idsp::Chorus chorus(48000);
+    chorus.set_modulation_amount(0.8f);
+    compare("Chorus::process", block,
+        [&](Sample& x) { chorus._process(x, x, right_buffer[0]); },
+        [&](idsp::BufferInterface& x) {
+        std::array<idsp::BufferInterface, 2> out {x, idsp::BufferInterface(right_buffer.data(), x.size())};
+        idsp::PolyBufferInterface poly_out(out.data(), 2);
+        chorus.process(x, poly_out);
+    });
+
+    idsp::WowFlutter wow_flutter(48000);
+    wow_flutter.set_modulation_amount(0.5f);
+    compare("WowFlutter::process", block,
+        [&](Sample& x) { idsp::BufferInterface one(&x, 1); wow_flutter.process(one, one); },
+        [&](idsp::BufferInterface& x) { wow_flutter.process(x, x); });
+
+    idsp::VarispeedDelay<48000> varispeed;
+    varispeed.set_time(12000.f);
+    compare("VarispeedDelay::process", block,
+        [&](Sample& x) { idsp::BufferInterface one(&x, 1); varispeed.process(one, one); },
+        [&](idsp::BufferInterface& x) { varispeed.process(x, x); });
+
+    idsp::benchmark_header("Ring buffer 4-point reads, block size " + std::to_string(dsp_block_size));
+
+    std::array<float, dsp_block_size> offsets;
+    for (size_t i = 0; i < dsp_block_size; i++)
+        offsets[i] = 1000.5f + 700.f * static_cast<float>(i % 8) + 0.37f * static_cast<float>(i);
+    idsp::SampleBufferStatic<4096> ring_buffer;
+    idsp::AudioRingBuffer ring(ring_buffer);
+    idsp::benchmark("AudioRingBuffer::read_offset_smooth_wrap", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            right_buffer[i] = ring.read_offset_smooth_wrap(offsets[i]);
+            ring.write(block[i]);
+        }
+        idsp::_bench::keep(right_buffer[0]);
+    }, dsp_block_size);
+    idsp::MaskedDelay<4096> masked;
+    idsp::benchmark("MaskedAudioRingBuffer::read_offset_smooth", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            right_buffer[i] = masked->read_offset_smooth(offsets[i]);
+            masked->write(block[i]);
+        }
+        idsp::_bench::keep(right_buffer[0]);
+    }, dsp_block_size);
+    idsp::MaskedDelay<4096, true> mirrored;
+    idsp::benchmark("MaskedAudioRingBuffer mirrored", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            right_buffer[i] = mirrored->read_offset_smooth(offsets[i]);
+            mirrored->write(block[i]);
+        }
+        idsp::_bench::keep(right_buffer[0]);
+    }, dsp_block_size);
+
+    idsp::benchmark_header("Modulated delay lines, block size " + std::to_string(dsp_block_size));
+
+    std::array<idsp::BufferInterface, 2> out {block, right_buffer.interface()};
+    idsp::PolyBufferInterface poly_out(out.data(), 2);
+    idsp::benchmark("Chorus::process_for", iterations, [&]() {
+        chorus.process_for<dsp_block_size>(block, poly_out);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+    idsp::benchmark("WowFlutter::process_for", iterations, [&]() {
+        wow_flutter.process_for<dsp_block_size>(block, block);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+
+    idsp::DattorroPlate<48000> plate;
+    plate.set_gain(Sample(0.5f));
+    idsp::benchmark("DattorroPlate<48000>::process_for", iterations / 4, [&]() {
+        plate.process_for<dsp_block_size>(block, poly_out);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+
+    idsp::GreisengerClouds<48000> clouds;
+    clouds.set_gain(Sample(0.5f));
+    idsp::benchmark("GreisengerClouds<48000>::process_for", iterations / 4, [&]() {
+        clouds.process_for<dsp_block_size>(block, poly_out);
+        idsp::_bench::keep(block[0]);
+    }, dsp_block_size);
+
+    idsp::benchmark_header("Memory per instance in bytes (delay arena)");
+    std::cout << std::left << std::setw(16) << "" << std::right << std::setw(19) << "32 kHz" << std::setw(19) << "44.1 kHz" << std::setw(19) << "48 kHz" << std::endl;
+    memory<idsp::SmallRoom>("SmallRoom");
+    memory<idsp::MediumRoom>("MediumRoom");
+    memory<idsp::LargeRoom>("LargeRoom");
+
+    idsp::benchmark_header("Rooms, per stereo frame");
+    rooms<idsp::SmallRoom<48000>>("SmallRoom<48000>");
+    rooms<idsp::MediumRoom<48000>>("MediumRoom<48000>");
+    rooms<idsp::LargeRoom<48000>>("LargeRoom<48000>");
+    rooms<idsp::FDNReverb<48000, 8>>("FDNReverb<48000, 8>");
+    rooms<idsp::FDNReverb<48000, 16>>("FDNReverb<48000, 16>");
+
+    idsp::benchmark_header("Echo density of the impulse response");
+    echo_density<idsp::LargeRoom<48000>>("LargeRoom<48000>");
+    echo_density<idsp::FDNReverb<48000, 8>>("FDNReverb<48000, 8>");
+    echo_density<idsp::FDNReverb<48000, 16>>("FDNReverb<48000, 16>");
+
+    idsp::benchmark_header("Sparse input, per stereo frame, block size " + std::to_string(dsp_block_size));
+    sparse<idsp::SmallRoom<48000>>("SmallRoom<48000>");
+    sparse<idsp::MediumRoom<48000>>("MediumRoom<48000>");
+    sparse<idsp::LargeRoom<48000>>("LargeRoom<48000>");
+    sparse<idsp::FDNReverb<48000, 8>>("FDNReverb<48000, 8>");
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Cost per channel of BiquadBank and OnepoleBank against the same number of
+// separate filters, for planar, interleaved and frame-at-a-time buffers, and
+// the cost of BiquadFilter coefficient updates.
+
+#include "idsp/filter.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 20000;
+
+template<size_t N>
+static void compare()
+{
+    using FilterType = idsp::BiquadFilter::Type;
+    const std::string name = std::to_string(N) + " channels ";
+    const size_t items = N * dsp_block_size;
+
+    idsp::PolySampleBufferStatic<dsp_block_size, N> planar;
+    std::vector<Sample> interleaved(items);
+    for (size_t n = 0; n < N; n++)
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            planar[n][i] = Sample(0.25f * static_cast<float>((i * 37 + n) % 17) / 17.f);
+            interleaved[i * N + n] = planar[n][i];
+        }
+    auto io = planar.interface();
+
+    std::vector<idsp::BiquadFilter> filters;
+    idsp::BiquadBank<N> bank(FilterType::Lowpass);
+    for (size_t n = 0; n < N; n++)
+    {
+        const float f = (100.f + 150.f * n) / 48000.f;
+        filters.emplace_back(FilterType::Lowpass, f, 0.707f);
+        bank.set_parameters(n, f, 0.707f);
+    }
+
+    idsp::benchmark(name + "BiquadFilter x N", iterations, [&]() {
+        for (size_t n = 0; n < N; n++)
+            filters[n].process(io[n], io[n]);
+        idsp::_bench::keep(io[0][0]);
+    }, items);
+    idsp::benchmark(name + "BiquadBank planar", iterations, [&]() {
+        bank.template process_for<dsp_block_size>(io, io);
+        idsp::_bench::keep(io[0][0]);
+    }, items);
+    idsp::benchmark(name + "BiquadBank interleaved", iterations, [&]() {
+        bank.process_interleaved(interleaved.data(), interleaved.data(), dsp_block_size);
+        idsp::_bench::keep(interleaved[0]);
+    }, items);
+}
+
+template<size_t N>
+static void compare_onepole()
+{
+    using FilterType = idsp::OnepoleFilter::Type;
+    const std::string name = std::to_string(N) + " channels ";
+    const size_t items = N * dsp_block_size;
+
+    idsp::PolySampleBufferStatic<dsp_block_size, N> planar;
+    std::vector<Sample> interleaved(items);
+    for (size_t n = 0; n < N; n++)
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            planar[n][i] = Sample(0.25f * static_cast<float>((i * 37 + n) % 17) / 17.f);
+            interleaved[i * N + n] = planar[n][i];
+        }
+    auto io = planar.interface();
+
+    std::vector<idsp::OnepoleFilter> filters;
+    idsp::OnepoleBank<N> bank(FilterType::Lowpass);
+    for (size_t n = 0; n < N; n++)
+    {
+        const float f = (500.f + 150.f * n) / 48000.f;
+        filters.emplace_back(FilterType::Lowpass, f);
+        bank.set_cutoff(n, f);
+    }
+
+    idsp::benchmark(name + "OnepoleFilter x N block", iterations, [&]() {
+        for (size_t n = 0; n < N; n++)
+            filters[n].process(io[n], io[n]);
+        idsp::_bench::keep(io[0][0]);
+    }, items);
+    idsp::benchmark(name + "OnepoleFilter x N per frame", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            for (size_t n = 0; n < N; n++)
+                interleaved[i * N + n] = filters[n].process(interleaved[i * N + n]);
+        idsp::_bench::keep(interleaved[0]);
+    }, items);
+    idsp::benchmark(name + "OnepoleBank planar", iterations, [&]() {
+        bank.template process_for<dsp_block_size>(io, io);
+        idsp::_bench::keep(io[0][0]);
+    }, items);
+    idsp::benchmark(name + "OnepoleBank per frame", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            bank.process(interleaved.data() + i * N, interleaved.data() + i * N);
+        idsp::_bench::keep(interleaved[0]);
+    }, items);
+}
+
+/** Times set_parameters() for @a type swept across the spectrum. Each
+ * update is followed by one filtered sample so that it can't be skipped. */
+static void coefficient_updates(const std::string& name, idsp::BiquadFilter::Type type)
+{
+    idsp::BiquadFilter filter(type);
+    float f = 0.001f;
+    const double ns = idsp::benchmark(name + " set_parameters", iterations * 10, [&]() {
+        f = f > 0.45f ? 0.001f : f + 0.0007f;
+        filter.set_parameters(f, 0.707f, 2.f);
+        idsp::_bench::keep(filter.process(Sample(0.1f)));
+    });
+    std::cout << "    " << std::fixed << std::setprecision(1) << 1e3 / ns << " M updates/s" << std::endl;
+}
+
+static void coefficients()
+{
+    using FilterType = idsp::BiquadFilter::Type;
+    idsp::benchmark_header("Coefficient updates");
+
+    float f = 0.001f;
+    idsp::benchmark("std::tan(pi * f)", iterations * 10, [&]() {
+        f = f > 0.45f ? 0.001f : f + 0.0007f;
+        idsp::_bench::keep(std::tan(idsp::pi * f));
+    });
+    idsp::benchmark("tan_pi_fast(f)", iterations * 10, [&]() {
+        f = f > 0.45f ? 0.001f : f + 0.0007f;
+        idsp::_bench::keep(idsp::tan_pi_fast(f));
+    });
+    idsp::benchmark("std::exp(-2 pi f)", iterations * 10, [&]() {
+        f = f > 0.45f ? 0.001f : f + 0.0007f;
+        idsp::_bench::keep(std::exp(-idsp::twopi * f));
+    });
+    idsp::benchmark("exp_fast(-2 pi f)", iterations * 10, [&]() {
+        f = f > 0.45f ? 0.001f : f + 0.0007f;
+        idsp::_bench::keep(idsp::exp_fast(-idsp::twopi * f));
+    });
+
+    coefficient_updates("Lowpass", FilterType::Lowpass);
+    coefficient_updates("Peak", FilterType::Peak);
+    coefficient_updates("Highshelf", FilterType::Highshelf);
+    coefficient_updates("Lowpass1Pole", FilterType::Lowpass1Pole);
+
+    // A parameter change every block, applied at once or glided over it
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    for (size_t i = 0; i < dsp_block_size; i++)
+        buffer[i] = Sample(0.25f * static_cast<float>((i * 37) % 17) / 17.f);
+    auto io = buffer.interface();
+    idsp::BiquadFilter filter(FilterType::Lowpass);
+    idsp::benchmark("Block with set_parameters", iterations, [&]() {
+        f = f > 0.2f ? 0.001f : f + 0.0007f;
+        filter.set_parameters(f, 0.707f);
+        filter.process(io, io);
+        idsp::_bench::keep(io[0]);
+    }, dsp_block_size);
+    idsp::benchmark("Block with set_parameters_smooth", iterations, [&]() {
+        f = f > 0.2f ? 0.001f : f + 0.0007f;
+        filter.set_parameters_smooth(f, 0.707f);
+        filter.process(io, io);
+        idsp::_bench::keep(io[0]);
+    }, dsp_block_size);
+}
+
+int main(int argc, const char* argv[])
+{
+    coefficients();
+    idsp::benchmark_header("Cost per channel-sample, block size " + std::to_string(dsp_block_size));
+    compare<1>();
+    compare<2>();
+    compare<4>();
+    compare<8>();
+    compare<16>();
+    compare<32>();
+    compare<64>();
+
+    idsp::benchmark_header("OnepoleBank, cost per channel-sample, block size " + std::to_string(dsp_block_size));
+    compare_onepole<1>();
+    compare_onepole<2>();
+    compare_onepole<4>();
+    compare_onepole<16>();
+    return 0;
+}
@@ -0,0 +1,195 @@
+// Accuracy and cost of the core processors for the build's `Sample` type.
+// Build once per type to compare, e.g.
+//   SAMPLE_TYPE=float IDSP_ENABLE_BENCHMARKING=ON cmake ...
+//   SAMPLE_TYPE=idsp::Q15 IDSP_ENABLE_BENCHMARKING=ON cmake ...
+//   SAMPLE_TYPE=idsp::Q31 IDSP_ENABLE_BENCHMARKING=ON cmake ...
+// Errors are measured against double-precision reference implementations of
+// the same difference equations.
+
+#include "idsp/filter.hpp"
+#include "idsp/reverb_toolkit.hpp"
+#include "idsp/ringbuffer.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <vector>
+
+#define IDSP_BENCH_STR_(x) #x
+#define IDSP_BENCH_STR(x) IDSP_BENCH_STR_(x)
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t num_samples = 48000;
+static constexpr size_t iterations = 100000;
+static constexpr double sample_rate = 48000;
+
+static std::vector<double> test_signal()
+{
+    std::vector<double> x(num_samples);
+    for (size_t i = 0; i < num_samples; i++)
+        x[i] = 0.3 * std::sin(2 * M_PI * 110 * i / sample_rate)
+            + 0.2 * std::sin(2 * M_PI * 1870 * i / sample_rate)
+            + 0.1 * std::sin(2 * M_PI * 9150 * i / sample_rate);
+    return x;
+}
+
+/** Prints the maximum error and the signal-to-error ratio of @a actual. */
+static void report_error(const std::string& name, const std::vector<double>& expected, const std::vector<double>& actual)
+{
+    double max_error = 0, signal = 0, error = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        const double e = actual[i] - expected[i];
+        max_error = std::max(max_error, std::abs(e));
+        signal += expected[i] * expected[i];
+        error += e * e;
+    }
+    const double ser = error > 0 ? 10 * std::log10(signal / error) : INFINITY;
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::scientific << std::setprecision(2)
+              << std::setw(12) << max_error << " max err"
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << ser << " dB SER"
+              << std::endl;
+}
+
+template<class F>
+static std::vector<double> run(const std::vector<double>& input, F&& process)
+{
+    std::vector<double> output(input.size());
+    for (size_t i = 0; i < input.size(); i++)
+        output[i] = static_cast<double>(process(Sample(input[i])));
+    return output;
+}
+
+static void accuracy(const std::vector<double>& input)
+{
+    idsp::benchmark_header("Accuracy vs double reference");
+
+    {
+        const double f = 500 / sample_rate;
+        const double coef = 1 / (M_PI * f);
+        double xs = 0, ys = 0;
+        std::vector<double> expected(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            ys = (input[i] + xs - ys * (1 - coef)) / (1 + coef);
+            xs = input[i];
+            expected[i] = ys;
+        }
+        idsp::OnepoleFilter filter(idsp::OnepoleFilter::Type::Lowpass, static_cast<float>(f));
+        report_error("OnepoleFilter lowpass 500 Hz", expected, run(input, [&](Sample x) { return filter.process(x); }));
+    }
+
+    for (double freq : {100.0, 1000.0, 10000.0})
+    {
+        const double K = std::tan(M_PI * freq / sample_rate);
+        const double Q = 0.707;
+        const double norm = 1 / (1 + K / Q + K * K);
+        const double b0 = K * K * norm, b1 = 2 * b0, b2 = b0;
+        const double a1 = 2 * (K * K - 1) * norm, a2 = (1 - K / Q + K * K) * norm;
+        double w1 = 0, w2 = 0;
+        std::vector<double> expected(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            const double w0 = input[i] - a1 * w1 - a2 * w2;
+            expected[i] = b0 * w0 + b1 * w1 + b2 * w2;
+            w2 = w1;
+            w1 = w0;
+        }
+        idsp::BiquadFilter filter(idsp::BiquadFilter::Type::Lowpass, static_cast<float>(freq / sample_rate), static_cast<float>(Q));
+        report_error("BiquadFilter lowpass " + std::to_string(static_cast<int>(freq)) + " Hz",
+            expected, run(input, [&](Sample x) { return filter.process(x); }));
+    }
+
+    {
+        // The allpass state w(n) is stored in `Sample` and peaks at up to
+        // 1 / (1 - g) times the input, so leave it some headroom
+        constexpr size_t length = 441;
+        const double g = 0.6;
+        std::vector<double> quiet(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+            quiet[i] = 0.35 * input[i];
+        std::vector<double> line(length, 0.0);
+        size_t index = 0;
+        std::vector<double> expected(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            const double wnD = line[index];
+            const double wn = quiet[i] + g * wnD;
+            expected[i] = -g * wn + wnD;
+            line[index] = wn;
+            index = (index + 1) % length;
+        }
+        idsp::Allpass<idsp::SampleBufferStatic<length>> allpass;
+        allpass->set_gain(static_cast<float>(g));
+        report_error("AllpassProcessor g=0.6", expected, run(quiet, [&](Sample x) { return allpass->process(x); }));
+    }
+
+    {
+        constexpr size_t length = 1024;
+        idsp::SampleBufferStatic<length> buffer;
+        idsp::AudioRingBuffer ring(buffer);
+        std::vector<double> expected(input.size()), actual(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            ring.write(Sample(input[i]));
+            if (i >= length)
+            {
+                // 4-point interpolation halfway between samples i-9 and i-8
+                expected[i] = idsp::interpolate_4(0.5, input[i - 10], input[i - 9], input[i - 8], input[i - 7]);
+                actual[i] = static_cast<double>(ring.read_at_smooth_wrap(static_cast<float>((i - 9) % length) + 0.5f));
+            }
+        }
+        report_error("AudioRingBuffer 4-point read", expected, actual);
+    }
+}
+
+static void speed(const std::vector<double>& signal)
+{
+    idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size));
+
+    idsp::SampleBufferStatic<dsp_block_size> input;
+    idsp::SampleBufferStatic<dsp_block_size> output;
+    for (size_t i = 0; i < dsp_block_size; i++)
+        input[i] = Sample(signal[i]);
+
+    idsp::OnepoleFilter onepole(idsp::OnepoleFilter::Type::Lowpass, 500 / 48000.f);
+    idsp::benchmark("OnepoleFilter::process", iterations, [&]() {
+        onepole.process(input.interface(), output.interface());
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+
+    idsp::BiquadFilter biquad(idsp::BiquadFilter::Type::Lowpass, 1000 / 48000.f, 0.707f);
+    idsp::benchmark("BiquadFilter::process", iterations, [&]() {
+        biquad.process(input.interface(), output.interface());
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+
+    idsp::Allpass<idsp::SampleBufferStatic<441>> allpass;
+    idsp::benchmark("AllpassProcessor::process", iterations, [&]() {
+        allpass->process(input.interface(), output.interface());
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+
+    idsp::SampleBufferStatic<1024> buffer;
+    idsp::AudioRingBuffer ring(buffer);
+    idsp::benchmark("AudioRingBuffer 4-point read", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            ring.write(input[i]);
+            output[i] = ring.read_at_smooth_wrap(static_cast<float>(ring.get_index()) + 0.5f);
+        }
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+int main(int argc, const char* argv[])
+{
+    std::cout << "Sample = " IDSP_BENCH_STR(Sample) << std::endl;
+    const auto signal = test_signal();
+    accuracy(signal);
+    speed(signal);
+    return 0;
+}
@@ -0,0 +1,257 @@
+// Cost per output sample of GrainPlayer against the number of grains
+// playing, for 16 and 256 grain slots. Its grain-major rendering is timed
+// next to sample-major rendering of the same active list, and next to the
+// scheduler it replaced, which visited every slot every sample and DC blocked
+// each one. Grains are topped up before every block so the count stays fixed.
+// The window rows give the cost per grain-sample of blending the window from
+// two tables against reading the table resolved at trigger. The thread rows
+// render 256 grains with ParallelGrainRenderer on 1 thread up to the core
+// count, at a 256-sample block so each job is worth handing out.
+
+#include "idsp/grain_player.hpp"
+#include "idsp/grain_player_parallel.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 4000;
+static constexpr float sample_rate = 48000;
+static constexpr size_t buffer_size = 96000;
+
+/** Reference: every slot visited every sample, one DC blocker per slot. */
+template<size_t MaxGrains>
+class EverySlotPlayer
+{
+    public:
+        EverySlotPlayer(idsp::AudioRingBuffer& buff) :
+        audio_buffer{buff}
+        {
+            for (auto& grain : grains)
+                grain = idsp::Grain(sample_rate);
+        }
+
+        void trigger_grain(idsp::Grain::Parameters& parameters)
+        {
+            for (auto& grain : grains)
+            {
+                if (grain.get_state() == idsp::Grain::idle)
+                {
+                    grain.init(parameters, audio_buffer);
+                    active_grains++;
+                    return;
+                }
+            }
+        }
+
+        void process(idsp::BufferInterface& output)
+        {
+            for (size_t i = 0; i < output.size(); i++)
+            {
+                std::array<Sample, MaxGrains> grain_out;
+                for (size_t g = 0; g < MaxGrains; g++)
+                    grain_out[g] = grains[g].get_state() == idsp::Grain::active ? grains[g].process(audio_buffer, windows) : Sample(0);
+                dc_blockers.process(grain_out.data(), grain_out.data());
+                Sample out{0};
+                for (auto x : grain_out)
+                    out += x;
+                output[i] = idsp::tanh_fast(out);
+            }
+            for (auto& grain : grains)
+            {
+                if (grain.get_state() == idsp::Grain::dying)
+                {
+                    grain.kill();
+                    active_grains--;
+                }
+            }
+        }
+
+        size_t active_grains = 0;
+
+    private:
+        idsp::AudioRingBuffer& audio_buffer;
+        std::array<idsp::Grain, MaxGrains> grains;
+        idsp::OnepoleBank<MaxGrains> dc_blockers{idsp::OnepoleFilter::Type::Highpass};
+        idsp::WindowBank<128> windows;
+};
+
+/** Reference: the active list rendered a sample at a time. */
+template<size_t MaxGrains>
+class SampleMajorPlayer
+{
+    public:
+        SampleMajorPlayer(idsp::AudioRingBuffer& buff) :
+        audio_buffer{buff}
+        {
+            for (size_t i = 0; i < MaxGrains; i++)
+                grains[i] = idsp::Grain(sample_rate);
+        }
+
+        void trigger_grain(idsp::Grain::Parameters& parameters)
+        {
+            for (size_t i = 0; i < MaxGrains; i++)
+            {
+                if (grains[i].get_state() == idsp::Grain::idle)
+                {
+                    grains[i].init(parameters, audio_buffer);
+                    active_list[active_grains++] = i;
+                    return;
+                }
+            }
+        }
+
+        void process(idsp::BufferInterface& output)
+        {
+            for (size_t i = 0; i < output.size(); i++)
+            {
+                Sample out{0};
+                for (size_t g = 0; g < active_grains; g++)
+                {
+                    auto& grain = grains[active_list[g]];
+                    if (grain.get_state() == idsp::Grain::active)
+                        out += grain.process(audio_buffer, windows);
+                }
+                output[i] = idsp::tanh_fast(dc_blocker.process(out));
+            }
+            size_t kept = 0;
+            for (size_t g = 0; g < active_grains; g++)
+            {
+                if (grains[active_list[g]].get_state() == idsp::Grain::dying)
+                    grains[active_list[g]].kill();
+                else
+                    active_list[kept++] = active_list[g];
+            }
+            active_grains = kept;
+        }
+
+        size_t active_grains = 0;
+
+    private:
+        idsp::AudioRingBuffer& audio_buffer;
+        std::array<idsp::Grain, MaxGrains> grains;
+        std::array<size_t, MaxGrains> active_list;
+        idsp::OnepoleFilter dc_blocker{idsp::OnepoleFilter::Type::Highpass};
+        idsp::WindowBank<128> windows;
+};
+
+template<size_t MaxGrains>
+static void grains(idsp::AudioRingBuffer& ring, size_t active)
+{
+    const std::string name = std::to_string(active) + " of " + std::to_string(MaxGrains) + " grains";
+    idsp::SampleBufferStatic<dsp_block_size> left, right;
+    auto l = left.interface();
+    auto r = right.interface();
+
+    auto player = std::make_unique<idsp::GrainPlayer<MaxGrains>>(ring, sample_rate);
+    player->set_position(0.3f);
+    player->set_pitch(1.5f);
+    player->set_length(0.5f);
+    player->set_window_shape(0.7f);
+    idsp::benchmark("GrainPlayer grain-major, " + name, iterations, [&]() {
+        while (player->get_active_grains() < active)
+            player->trigger_grain();
+        player->process(l, r);
+        idsp::_bench::keep(l[0]);
+    }, dsp_block_size);
+
+    idsp::Grain::Parameters parameters {5000, 1.5f, 0.5f, 0.7f, 0, 1.f};
+    auto sample_major = std::make_unique<SampleMajorPlayer<MaxGrains>>(ring);
+    idsp::benchmark("Sample-major, " + name, iterations, [&]() {
+        while (sample_major->active_grains < active)
+            sample_major->trigger_grain(parameters);
+        sample_major->process(l);
+        idsp::_bench::keep(l[0]);
+    }, dsp_block_size);
+
+    auto reference = std::make_unique<EverySlotPlayer<MaxGrains>>(ring);
+    idsp::benchmark("Every slot, " + name, iterations, [&]() {
+        while (reference->active_grains < active)
+            reference->trigger_grain(parameters);
+        reference->process(l);
+        idsp::_bench::keep(l[0]);
+    }, dsp_block_size);
+}
+
+static void threads(idsp::AudioRingBuffer& ring)
+{
+    constexpr size_t max_grains = 256;
+    constexpr size_t block_size = 256;
+    using Player = idsp::GrainPlayer<max_grains>;
+    idsp::SampleBufferStatic<block_size> left, right;
+    auto l = left.interface();
+    auto r = right.interface();
+
+    const size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::cout << "hardware_concurrency " << cores << std::endl;
+    for (size_t num_threads = 1; num_threads <= std::max<size_t>(cores, 4); num_threads *= 2)
+    {
+        auto player = std::make_unique<Player>(ring, sample_rate);
+        player->set_position(0.3f);
+        player->set_pitch(1.5f);
+        player->set_length(0.5f);
+        player->set_window_shape(0.7f);
+        idsp::ParallelGrainRenderer<Player> renderer(*player, num_threads);
+        idsp::benchmark(std::to_string(num_threads) + " threads, 256 of 256 grains", iterations / 4, [&]() {
+            while (player->get_active_grains() < max_grains)
+                player->trigger_grain();
+            player->process(l, r, renderer);
+            idsp::_bench::keep(l[0]);
+        }, block_size);
+    }
+}
+
+static void windows()
+{
+    idsp::WindowBank<128> bank;
+    std::array<float, dsp_block_size> phases, envelopes;
+    for (size_t i = 0; i < dsp_block_size; i++)
+        phases[i] = static_cast<float>(i) / static_cast<float>(dsp_block_size);
+    const float shape = 0.7f;
+    const Sample* table = bank.acquire_window(shape);
+
+    idsp::benchmark("get_window per sample", iterations * 10, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            envelopes[i] = bank.get_window(phases[i], shape);
+        idsp::_bench::keep(envelopes[0]);
+    }, dsp_block_size);
+    idsp::benchmark("get_window block", iterations * 10, [&]() {
+        bank.get_window(phases.data(), shape, envelopes.data(), dsp_block_size);
+        idsp::_bench::keep(envelopes[0]);
+    }, dsp_block_size);
+    idsp::benchmark("read_window per sample", iterations * 10, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            envelopes[i] = bank.read_window(table, phases[i]);
+        idsp::_bench::keep(envelopes[0]);
+    }, dsp_block_size);
+    idsp::benchmark("read_window block", iterations * 10, [&]() {
+        bank.read_window(table, phases.data(), envelopes.data(), dsp_block_size);
+        idsp::_bench::keep(envelopes[0]);
+    }, dsp_block_size);
+}
+
+int main(int argc, const char* argv[])
+{
+    auto audio = std::make_unique<idsp::SampleBufferStatic<buffer_size>>();
+    idsp::AudioRingBuffer ring(*audio);
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(0.25f * static_cast<float>((i * 37) % 101) / 101.f - 0.125f));
+
+    idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size));
+    grains<16>(ring, 4);
+    grains<16>(ring, 16);
+    grains<256>(ring, 16);
+    grains<256>(ring, 64);
+    grains<256>(ring, 256);
+
+    idsp::benchmark_header("Cost per sample against threads, block size 256");
+    threads(ring);
+
+    idsp::benchmark_header("Window cost per grain-sample");
+    windows();
+    return 0;
+}
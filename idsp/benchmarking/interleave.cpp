@@ -0,0 +1,78 @@
+#include "idsp/interleave.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 200000;
+
+/** Reference implementation: channel-major nested loops through the
+ * PolyBufferInterface, with the conversion written inline. */
+template<size_t Nc>
+static void naive_deinterleave(const int16_t* input, idsp::PolyBufferInterface& output, size_t num_frames)
+{
+    for (size_t c = 0; c < Nc; c++)
+        for (size_t i = 0; i < num_frames; i++)
+            output[c][i] = static_cast<Sample>(input[i * Nc + c]) / Sample(32768);
+}
+
+template<size_t Nc>
+static void naive_interleave(const idsp::PolyBufferInterface& input, int16_t* output, size_t num_frames)
+{
+    for (size_t c = 0; c < Nc; c++)
+        for (size_t i = 0; i < num_frames; i++)
+            output[i * Nc + c] = static_cast<int16_t>(idsp::clamp(input[c][i], Sample(-1), Sample(32767) / Sample(32768)) * Sample(32768));
+}
+
+template<size_t Nc>
+static void run()
+{
+    const std::string ch = std::to_string(Nc) + "ch";
+    std::vector<int16_t> interleaved(dsp_block_size * Nc);
+    for (size_t i = 0; i < interleaved.size(); i++)
+        interleaved[i] = static_cast<int16_t>((i * 2654435761u) >> 16);
+
+    std::vector<int32_t> interleaved32(dsp_block_size * Nc);
+    for (size_t i = 0; i < interleaved32.size(); i++)
+        interleaved32[i] = static_cast<int32_t>(i * 2654435761u);
+
+    idsp::PolySampleBufferStatic<dsp_block_size, Nc> planar;
+    auto& planar_ref = planar.interface();
+
+    idsp::benchmark("naive deinterleave int16 " + ch, iterations, [&]() {
+        naive_deinterleave<Nc>(interleaved.data(), planar_ref, dsp_block_size);
+        idsp::_bench::keep(planar[0][0]);
+    }, dsp_block_size * Nc);
+    idsp::benchmark("deinterleave_for int16 " + ch, iterations, [&]() {
+        idsp::deinterleave_for<Nc, dsp_block_size>(interleaved.data(), planar_ref);
+        idsp::_bench::keep(planar[0][0]);
+    }, dsp_block_size * Nc);
+    idsp::benchmark("deinterleave_for int32 " + ch, iterations, [&]() {
+        idsp::deinterleave_for<Nc, dsp_block_size>(interleaved32.data(), planar_ref);
+        idsp::_bench::keep(planar[0][0]);
+    }, dsp_block_size * Nc);
+
+    idsp::benchmark("naive interleave int16 " + ch, iterations, [&]() {
+        naive_interleave<Nc>(planar_ref, interleaved.data(), dsp_block_size);
+        idsp::_bench::keep(interleaved[0]);
+    }, dsp_block_size * Nc);
+    idsp::benchmark("interleave_for int16 " + ch, iterations, [&]() {
+        idsp::interleave_for<Nc, dsp_block_size>(planar_ref, interleaved.data());
+        idsp::_bench::keep(interleaved[0]);
+    }, dsp_block_size * Nc);
+    idsp::benchmark("interleave_for int32 " + ch, iterations, [&]() {
+        idsp::interleave_for<Nc, dsp_block_size>(planar_ref, interleaved32.data());
+        idsp::_bench::keep(interleaved32[0]);
+    }, dsp_block_size * Nc);
+}
+
+int main(int argc, const char* argv[])
+{
+    idsp::benchmark_header("Interleave/deinterleave, block size " + std::to_string(dsp_block_size));
+    run<2>();
+    run<4>();
+    run<8>();
+    return 0;
+}
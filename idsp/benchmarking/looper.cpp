@@ -0,0 +1,120 @@
+// Cost per output sample of a looper Tap playing a short loop, so that a
+// crossfade is running most of the time, and the taps one core could run at
+// 48 kHz. Moving and crossfading by blocks is timed against moving a sample at
+// a time, and apply_xfade on its own against per-sample gains.
+
+#include "idsp/looper.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <memory>
+
+using namespace idsp::looper;
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 20000;
+static constexpr size_t data_size = 48000;
+static constexpr double sample_rate = 48000;
+
+static void taps_per_core(const std::string& name, double ns_per_sample)
+{
+    std::cout << std::left << std::setw(48) << ("  " + name) << std::right << std::setw(10)
+        << std::fixed << std::setprecision(0) << 1e9 / (ns_per_sample * sample_rate) << " taps per core" << std::endl;
+}
+
+static void tap(const idsp::BufferInterface& data, float speed)
+{
+    LoopingParamaters params{};
+    params.speed = speed;
+    params.looping_enabled = true;
+    params.loop_start = 1000;
+    params.loop_end = 2200;
+    params.loop_fade_length = 480;
+    params.data_start = 0;
+    params.data_end = static_cast<IndexT>(data_size);
+    params.data_fade_length = 480;
+    const std::string name = "speed " + std::to_string(speed).substr(0, 4);
+
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+
+    Tap by_block;
+    by_block.set_loop_parameters(params);
+    by_block.activate();
+    const double block = idsp::benchmark("Tap by blocks, " + name, iterations, [&]() {
+        output.fill(Sample(0));
+        by_block.process(dsp_block_size);
+        by_block.render(data, output);
+        by_block.update();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    taps_per_core("by blocks, " + name, block);
+
+    Tap by_sample;
+    by_sample.set_loop_parameters(params);
+    by_sample.activate();
+    const double sample = idsp::benchmark("Tap by samples, " + name, iterations, [&]() {
+        output.fill(Sample(0));
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            idsp::BufferInterface one(output.data() + i, 1);
+            by_sample.process(1);
+            by_sample.render(data, one);
+            by_sample.update();
+        }
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    taps_per_core("by samples, " + name, sample);
+}
+
+static void xfade()
+{
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    FadingPosition fp;
+    const auto restart = [&]() {
+        fp.activate(0);
+        fp.trigger_fade(FadeType::Loop, 0, 4800, true, true);
+        fp.trigger_fade(FadeType::Deactivate, 0, 9600, false, true);
+    };
+    restart();
+    idsp::benchmark("apply_xfade, 2 fades", iterations * 4, [&]() {
+        output.fill(Sample(1));
+        fp.process(static_cast<FractionT>(dsp_block_size), dsp_block_size);
+        fp.apply_xfade(output);
+        if (!fp.is_fading(FadeType::Loop)) restart();
+        fp.update();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+
+    restart();
+    idsp::benchmark("Per-sample gains, 2 fades", iterations * 4, [&]() {
+        output.fill(Sample(1));
+        for (size_t i = 0; i < dsp_block_size; i++)
+        {
+            idsp::BufferInterface one(output.data() + i, 1);
+            fp.process(FractionT(1), 1);
+            fp.apply_xfade(one);
+        }
+        if (!fp.is_fading(FadeType::Loop)) restart();
+        fp.update();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+int main(int argc, const char* argv[])
+{
+    auto data = std::make_unique<idsp::SampleBufferStatic<data_size>>();
+    for (size_t i = 0; i < data_size; i++)
+        (*data)[i] = Sample(std::sin(0.01f * static_cast<float>(i)));
+
+    idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size) + ", 1200-sample loop, 480-sample fades");
+    tap(data->interface(), 1.f);
+    tap(data->interface(), -1.5f);
+
+    idsp::benchmark_header("Crossfade gains");
+    xfade();
+    return 0;
+}
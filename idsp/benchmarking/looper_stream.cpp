@@ -0,0 +1,172 @@
+// Cost per output sample of a looper Tap reading a StreamingBuffer, against
+// reading memory, with every block cached; then cache hits and underruns of
+// taps playing a minute-long file at 4 times real time while recording over
+// it, with the default cache.
+
+#include "idsp/looper_stream.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace idsp::looper;
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 20000;
+static constexpr size_t data_size = 48000;
+static constexpr size_t file_size = 60 * 48000;
+static constexpr double sample_rate = 48000;
+
+using Stream = StreamingBuffer<>;
+
+static const std::string path = "/tmp/idsp_benchmark_looper_stream_" + std::to_string(getpid()) + ".raw";
+
+static LoopingParamaters loop_parameters(float speed, IndexT loop_start, IndexT loop_end, IndexT data_end)
+{
+    LoopingParamaters params{};
+    params.speed = speed;
+    params.looping_enabled = true;
+    params.loop_start = loop_start;
+    params.loop_end = loop_end;
+    params.loop_fade_length = 480;
+    params.data_start = 0;
+    params.data_end = data_end;
+    params.data_fade_length = 480;
+    return params;
+}
+
+static void record(Stream& stream, size_t num_samples)
+{
+    std::array<Sample, dsp_block_size> block;
+    for (size_t start = 0; start < num_samples; start += dsp_block_size)
+    {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            block[i] = Sample(std::sin(0.01f * static_cast<float>(start + i)));
+        while (!stream.write(static_cast<IndexT>(start), block.data(), dsp_block_size))
+            stream.wait_until_idle();
+    }
+    stream.wait_until_idle(std::chrono::milliseconds(10000));
+}
+
+static void cost(const idsp::BufferInterface& data, Stream& stream)
+{
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    const auto params = loop_parameters(1.f, 1000, 2200, static_cast<IndexT>(data_size));
+
+    Tap from_memory;
+    from_memory.set_loop_parameters(params);
+    from_memory.activate();
+    idsp::benchmark("Tap from memory", iterations, [&]() {
+        output.fill(Sample(0));
+        from_memory.process(dsp_block_size);
+        from_memory.render(data, output);
+        from_memory.update();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+
+    Tap from_stream;
+    from_stream.set_loop_parameters(params);
+    from_stream.activate();
+    // the loop fits the cache, so after one pass every read hits
+    for (size_t i = 0; i < 64; i++)
+    {
+        output.fill(Sample(0));
+        from_stream.process(dsp_block_size);
+        stream.follow(0, from_stream);
+        stream.wait_until_idle();
+        from_stream.render_from(stream, output);
+        from_stream.update();
+    }
+    stream.reset_stats();
+    idsp::benchmark("Tap from stream, cached", iterations, [&]() {
+        output.fill(Sample(0));
+        from_stream.process(dsp_block_size);
+        stream.follow(0, from_stream);
+        from_stream.render_from(stream, output);
+        from_stream.update();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    const auto stats = stream.get_stats();
+    std::cout << "  hit rate " << std::setprecision(4) << stats.hit_rate() << ", " << stats.underruns << " samples of underrun" << std::endl;
+    stream.unfollow(0);
+}
+
+/** Plays @a num_taps taps spread over the file, looping most of it at
+ * different speeds, for @a seconds of audio at @a rate times real time,
+ * overdubbing a block each block. */
+static void playback(Stream& stream, size_t num_taps, double seconds, double rate)
+{
+    using Clock = std::chrono::steady_clock;
+    std::vector<Tap> taps(num_taps);
+    for (size_t t = 0; t < num_taps; t++)
+    {
+        const float speed = (t % 2 == 0 ? 1.f : -1.f) * (0.5f + 0.25f * static_cast<float>(t));
+        const IndexT start = static_cast<IndexT>(t * file_size / (2 * num_taps));
+        taps[t].set_loop_parameters(loop_parameters(speed, start, start + static_cast<IndexT>(file_size / 2), static_cast<IndexT>(file_size)));
+        taps[t].activate();
+    }
+    // cue the taps up before they start, as a set would
+    for (size_t t = 0; t < num_taps; t++)
+        stream.follow(t, taps[t]);
+    stream.wait_until_idle();
+    stream.reset_stats();
+
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    const size_t num_blocks = static_cast<size_t>(seconds * sample_rate) / dsp_block_size;
+    const auto period = std::chrono::duration<double>(static_cast<double>(dsp_block_size) / (sample_rate * rate));
+    const auto begin = Clock::now();
+    for (size_t block = 0; block < num_blocks; block++)
+    {
+        output.fill(Sample(0));
+        for (size_t t = 0; t < num_taps; t++)
+        {
+            taps[t].process(dsp_block_size);
+            stream.follow(t, taps[t]);
+            taps[t].render_from(stream, output);
+            taps[t].update();
+        }
+        const IndexT record_at = static_cast<IndexT>((block * dsp_block_size) % file_size);
+        stream.write(record_at, output.data(), dsp_block_size);
+        std::this_thread::sleep_until(begin + std::chrono::duration_cast<Clock::duration>(period * static_cast<double>(block + 1)));
+    }
+
+    const auto stats = stream.get_stats();
+    std::cout << std::left << std::setw(48) << ("  " + std::to_string(num_taps) + " taps, " + std::to_string(static_cast<int>(rate)) + "x real time")
+        << std::right << std::fixed << std::setprecision(4)
+        << "hit rate " << stats.hit_rate()
+        << std::setw(8) << stats.underruns << " underrun"
+        << std::setw(8) << stats.overruns << " overrun"
+        << std::setw(8) << stats.loads << " loads" << std::endl;
+    for (size_t t = 0; t < num_taps; t++)
+        stream.unfollow(t);
+}
+
+int main(int argc, const char* argv[])
+{
+    std::remove(path.c_str());
+    auto data = std::make_unique<idsp::SampleBufferStatic<data_size>>();
+    for (size_t i = 0; i < data_size; i++)
+        (*data)[i] = Sample(std::sin(0.01f * static_cast<float>(i)));
+    {
+        auto stream = std::make_unique<Stream>(path);
+        record(*stream, file_size);
+
+        idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size) + ", 1200-sample loop, 480-sample fades");
+        cost(data->interface(), *stream);
+
+        idsp::benchmark_header("Streaming a 60 s file, 4096-sample blocks, 128 cached");
+        playback(*stream, 1, 4.0, 4.0);
+        playback(*stream, 4, 4.0, 4.0);
+        playback(*stream, 8, 4.0, 4.0);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
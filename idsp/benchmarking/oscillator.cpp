@@ -0,0 +1,124 @@
+// Cost per sample of single-level and mipmapped wavetable oscillators, the
+// one-off cost of building the mip levels, construction of oscillators
+// that share them, N separate LFOs against an OscillatorBank<N>, and float
+// against integer phase accumulators.
+
+#include "idsp/oscillator.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 100000;
+static constexpr size_t table_size = 2049;
+static constexpr size_t num_levels = 9;
+
+template<size_t Levels>
+static void oscillator(const std::string& name, float frequency)
+{
+    idsp::WavetableOscillator<table_size, Levels> osc(idsp::Waveform::sawtooth, true);
+    osc.set_rate(frequency / 48000.f);
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    idsp::benchmark(name + " " + std::to_string(static_cast<int>(frequency)) + " Hz", iterations, [&]() {
+        osc.template process_for<dsp_block_size>(output);
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+template<size_t N>
+static void compare_bank()
+{
+    std::vector<idsp::WavetableOscillator<128>> separate;
+    idsp::OscillatorBank<N> bank(idsp::Waveform::sine, true);
+    for (size_t n = 0; n < N; n++)
+    {
+        const float rate = 0.0001f * static_cast<float>(n + 1);
+        separate.emplace_back(idsp::Waveform::sine, true);
+        separate[n].set_rate(rate);
+        bank.set_rate(n, rate);
+    }
+    idsp::PolySampleBufferStatic<dsp_block_size, N> buffer;
+    auto& output = buffer.interface();
+    const size_t iters = iterations / N + 1;
+    const std::string suffix = "<" + std::to_string(N) + ">";
+    idsp::benchmark("WavetableOscillator<128> x" + std::to_string(N), iters, [&]() {
+        for (size_t n = 0; n < N; n++)
+            separate[n].template process_for<dsp_block_size>(output[n]);
+        idsp::_bench::keep(output[0][0]);
+    }, dsp_block_size * N);
+    idsp::benchmark("OscillatorBank" + suffix, iters, [&]() {
+        bank.template process_for<dsp_block_size>(output);
+        idsp::_bench::keep(output[0][0]);
+    }, dsp_block_size * N);
+}
+
+template<class Osc>
+static void block(const std::string& name, Osc& osc)
+{
+    osc.set_rate(0.0123f);
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    idsp::benchmark(name, iterations, [&]() {
+        osc.template process_for<dsp_block_size>(output);
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+// RawOscillator has no process_for
+static void raw(const std::string& name, idsp::RawOscillator osc)
+{
+    osc.set_rate(0.0123f);
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    idsp::benchmark(name, iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            output[i] = osc.process();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+int main(int argc, const char* argv[])
+{
+    idsp::benchmark_header("Sawtooth, cost per sample, block size " + std::to_string(dsp_block_size));
+    for (float frequency : {110.f, 3520.f})
+    {
+        oscillator<1>("WavetableOscillator<2049>", frequency);
+        oscillator<num_levels>("WavetableOscillator<2049, 9>", frequency);
+    }
+
+    idsp::benchmark_header("Sine LFOs, cost per oscillator sample, block size " + std::to_string(dsp_block_size));
+    compare_bank<2>();
+    compare_bank<8>();
+    compare_bank<64>();
+
+    idsp::benchmark_header("Float against integer phase, cost per sample, block size " + std::to_string(dsp_block_size));
+    raw("RawOscillator triangle", idsp::RawOscillator(idsp::Waveform::triangle, true));
+    idsp::FixedRawOscillator<idsp::Waveform::triangle, true> fixed_triangle;
+    block("FixedRawOscillator triangle", fixed_triangle);
+    raw("RawOscillator sine", idsp::RawOscillator(idsp::Waveform::sine, true));
+    idsp::FixedRawOscillator<idsp::Waveform::sine, true> fixed_sine;
+    block("FixedRawOscillator sine", fixed_sine);
+    idsp::WavetableOscillator<129> wavetable(idsp::Waveform::sine, true);
+    block("WavetableOscillator<129> sine", wavetable);
+    idsp::FixedWavetableOscillator<idsp::Waveform::sine, true> fixed_wavetable;
+    block("FixedWavetableOscillator<sine, 7>", fixed_wavetable);
+
+    idsp::benchmark_header("Construction");
+    const idsp::LookupTable<Sample, table_size> saw(idsp::waveforms::sawtooth_bipolar);
+    idsp::benchmark("MipmappedWavetable<2049, 9>", 20, [&]() {
+        const idsp::MipmappedWavetable<table_size, num_levels> table(saw);
+        idsp::_bench::keep(table.table(num_levels - 1)[1]);
+    });
+    idsp::benchmark("WavetableOscillator<2049> (shared table)", iterations, []() {
+        idsp::WavetableOscillator<table_size> osc(idsp::Waveform::sawtooth, true);
+        idsp::_bench::keep(osc);
+    });
+    idsp::benchmark("WavetableOscillator<2049, 9> (shared table)", iterations, []() {
+        idsp::WavetableOscillator<table_size, num_levels> osc(idsp::Waveform::sawtooth, true);
+        idsp::_bench::keep(osc);
+    });
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Throughput in samples per second and memory per instance of the noise
+// sources, per sample and in blocks, against the std::mt19937 generator they
+// used to carry.
+
+#include "idsp/random.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <random>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 100000;
+
+static void rate(const std::string& name, double ns_per_sample)
+{
+    std::cout << std::left << std::setw(48) << ("  " + name) << std::right << std::setw(10)
+        << std::fixed << std::setprecision(1) << 1e3 / ns_per_sample << " Msamples/s" << std::endl;
+}
+
+template<class Noise>
+static void noise(const std::string& name)
+{
+    Noise source;
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    const double per_sample = idsp::benchmark(name + " bipolar()", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            output[i] = source.bipolar();
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    rate(name + " bipolar()", per_sample);
+    const double block = idsp::benchmark(name + " process_for", iterations, [&]() {
+        source.template process_for<dsp_block_size>(output);
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    rate(name + " process_for", block);
+}
+
+int main(int argc, const char* argv[])
+{
+    idsp::benchmark_header("Memory per instance");
+    std::cout << "std::mt19937 + uniform_real_distribution  " << sizeof(std::mt19937) + sizeof(std::uniform_real_distribution<float>) << " bytes" << std::endl;
+    std::cout << "Xoshiro128                                 " << sizeof(idsp::Xoshiro128) << " bytes" << std::endl;
+    std::cout << "WhiteNoise                                 " << sizeof(idsp::WhiteNoise) << " bytes" << std::endl;
+    std::cout << "PinkNoise                                  " << sizeof(idsp::PinkNoise) << " bytes" << std::endl;
+    std::cout << "BlueNoise                                  " << sizeof(idsp::BlueNoise) << " bytes" << std::endl;
+    std::cout << "NoiseSource                                " << sizeof(idsp::NoiseSource) << " bytes" << std::endl;
+    std::cout << "Stochastic                                 " << sizeof(idsp::Stochastic) << " bytes" << std::endl;
+    std::cout << "FluctuatingRandom                          " << sizeof(idsp::FluctuatingRandom) << " bytes" << std::endl;
+
+    idsp::benchmark_header("Cost per sample, block size " + std::to_string(dsp_block_size));
+    std::mt19937 mt(1);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    idsp::SampleBufferStatic<dsp_block_size> buffer;
+    auto output = buffer.interface();
+    const double mt_ns = idsp::benchmark("std::mt19937 bipolar", iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            output[i] = distribution(mt) * 2.f - 1.f;
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+    rate("std::mt19937 bipolar", mt_ns);
+    noise<idsp::WhiteNoise>("WhiteNoise");
+    noise<idsp::PinkNoise>("PinkNoise");
+    noise<idsp::BlueNoise>("BlueNoise");
+    noise<idsp::NoiseSource>("NoiseSource");
+    return 0;
+}
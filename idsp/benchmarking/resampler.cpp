@@ -0,0 +1,129 @@
+// Cost per output sample and aliasing rejection of SincInterpolator reads
+// from an AudioRingBuffer at each tier, against the 4-point block read. Reads
+// run at 1, 2 and 4 source samples per output sample, the levels a grain at
+// pitch 1 to 4 would select. Rejection is the level of a tone above the
+// reader's Nyquist, 0.75 / ratio cycles per sample, after reading.
+
+#include "idsp/resampler.hpp"
+#include "benchmark.hpp"
+
+#include "idsp/buffer_types.hpp"
+#include "idsp/ringbuffer.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr size_t iterations = 20000;
+static constexpr size_t buffer_size = 48000;
+
+static void fill_sine(idsp::AudioRingBuffer& ring, float frequency)
+{
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(std::sin(idsp::twopi * frequency * static_cast<float>(i % 48000))));
+}
+
+/** Level in dB of reading a full-scale tone, RMS against a sine's. */
+template<class Read>
+static double level_db(float ratio, Read&& read)
+{
+    std::array<float, dsp_block_size> positions;
+    std::array<Sample, dsp_block_size> output;
+    double sum = 0.0;
+    size_t count = 0;
+    for (float start = 1000.25f; start + ratio * dsp_block_size < static_cast<float>(buffer_size) - 1000.f; start += ratio * dsp_block_size)
+    {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            positions[i] = start + ratio * static_cast<float>(i);
+        read(positions.data(), output.data());
+        for (auto x : output)
+            sum += static_cast<double>(x) * static_cast<double>(x);
+        count += dsp_block_size;
+    }
+    return 10.0 * std::log10(sum / static_cast<double>(count) / 0.5);
+}
+
+/** Times reads at @a ratio through @a read, which maps a block of positions
+ * to output. Positions start just past the start of the buffer. */
+template<class Read>
+static void cost(const std::string& name, float ratio, Read&& read)
+{
+    std::array<float, dsp_block_size> positions;
+    std::array<Sample, dsp_block_size> output;
+    float start = 1000.25f;
+    idsp::benchmark(name, iterations, [&]() {
+        for (size_t i = 0; i < dsp_block_size; i++)
+            positions[i] = start + ratio * static_cast<float>(i);
+        start += ratio * dsp_block_size;
+        if (start > static_cast<float>(buffer_size) - 1000.f) start = 1000.25f;
+        read(positions.data(), output.data());
+        idsp::_bench::keep(output[0]);
+    }, dsp_block_size);
+}
+
+template<size_t Taps>
+static void tier(idsp::AudioRingBuffer& ring)
+{
+    using Interpolator = idsp::SincInterpolator<Taps>;
+    auto interpolator = std::make_unique<Interpolator>();
+    for (float ratio : {1.f, 2.f, 4.f})
+    {
+        const size_t level = Interpolator::select_level(ratio);
+        cost(std::to_string(Taps) + "-tap sinc, ratio " + std::to_string(static_cast<int>(ratio)), ratio, [&](const float* positions, Sample* output) {
+            ring.read_at(*interpolator, level, positions, output, dsp_block_size);
+        });
+    }
+}
+
+template<size_t Taps>
+static void rejection(idsp::AudioRingBuffer& ring)
+{
+    using Interpolator = idsp::SincInterpolator<Taps>;
+    auto interpolator = std::make_unique<Interpolator>();
+    std::cout << std::left << std::setw(24) << (std::to_string(Taps) + "-tap sinc") << std::right;
+    for (float ratio : {2.f, 4.f})
+    {
+        fill_sine(ring, 0.75f / ratio);
+        const size_t level = Interpolator::select_level(ratio);
+        std::cout << std::setw(12) << std::fixed << std::setprecision(1) << level_db(ratio, [&](const float* positions, Sample* output) {
+            ring.read_at(*interpolator, level, positions, output, dsp_block_size);
+        }) << " dB";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    auto audio = std::make_unique<idsp::SampleBufferStatic<buffer_size>>();
+    idsp::AudioRingBuffer ring(*audio);
+    fill_sine(ring, 0.01f);
+
+    idsp::benchmark_header("Cost per output sample, block size " + std::to_string(dsp_block_size));
+    for (float ratio : {1.f, 2.f, 4.f})
+    {
+        cost("4-point, ratio " + std::to_string(static_cast<int>(ratio)), ratio, [&](const float* positions, Sample* output) {
+            ring.read_at_smooth_safe(positions, output, dsp_block_size);
+        });
+    }
+    tier<4>(ring);
+    tier<8>(ring);
+    tier<16>(ring);
+    tier<32>(ring);
+
+    idsp::benchmark_header("Aliased tone level               ratio 2     ratio 4");
+    std::cout << std::left << std::setw(24) << "4-point" << std::right;
+    for (float ratio : {2.f, 4.f})
+    {
+        fill_sine(ring, 0.75f / ratio);
+        std::cout << std::setw(12) << std::fixed << std::setprecision(1) << level_db(ratio, [&](const float* positions, Sample* output) {
+            ring.read_at_smooth_safe(positions, output, dsp_block_size);
+        }) << " dB";
+    }
+    std::cout << std::endl;
+    rejection<4>(ring);
+    rejection<8>(ring);
+    rejection<16>(ring);
+    rejection<32>(ring);
+    return 0;
+}
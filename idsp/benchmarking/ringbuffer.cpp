@@ -0,0 +1,149 @@
+#include "idsp/ringbuffer.hpp"
+#include "benchmark.hpp"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+static constexpr size_t queue_size = 1024;
+static constexpr size_t batch_size = 32;
+static constexpr size_t iterations = 200000;
+static constexpr uint32_t transfer_count = 10000000;
+
+/** Reference: the same ring guarded by a mutex. */
+template<class T, size_t S>
+class LockedRingBuffer
+{
+    public:
+        bool write(const T& data)
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            if (this->_count == S)
+                return false;
+            this->_data[(this->_read_pos + this->_count) % S] = data;
+            this->_count++;
+            return true;
+        }
+
+        bool read(T& value)
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            if (this->_count == 0)
+                return false;
+            value = this->_data[this->_read_pos];
+            this->_read_pos = (this->_read_pos + 1) % S;
+            this->_count--;
+            return true;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::array<T, S> _data {};
+        size_t _read_pos {0};
+        size_t _count {0};
+};
+
+/** Moves @a transfer_count values from a producer thread to this thread
+ * and prints the throughput. */
+template<class Push, class Pop>
+static void transfer(const std::string& name, Push&& push, Pop&& pop)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    std::thread producer([&]() {
+        uint32_t next = 0;
+        while (next < transfer_count)
+        {
+            const uint32_t n = push(next);
+            if (n == 0)
+                std::this_thread::yield();
+            next += n;
+        }
+    });
+    uint32_t received = 0;
+    uint64_t checksum = 0;
+    while (received < transfer_count)
+    {
+        const uint32_t n = pop(checksum);
+        if (n == 0)
+            std::this_thread::yield();
+        received += n;
+    }
+    producer.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    idsp::_bench::keep(checksum);
+
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << (transfer_count / seconds / 1e6) << " M items/s"
+              << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    idsp::benchmark_header("Single thread, queue size " + std::to_string(queue_size));
+    {
+        idsp::RingBuffer<uint32_t, queue_size> queue;
+        uint32_t value = 0;
+        idsp::benchmark("RingBuffer write + read", iterations, [&]() {
+            queue.write(value);
+            queue.read(value);
+            idsp::_bench::keep(value);
+        });
+
+        std::array<uint32_t, batch_size> batch {};
+        idsp::benchmark("RingBuffer batch write + read of " + std::to_string(batch_size), iterations, [&]() {
+            queue.write(batch.data(), batch.size());
+            queue.read(batch.data(), batch.size());
+            idsp::_bench::keep(batch[0]);
+        }, batch_size);
+
+        LockedRingBuffer<uint32_t, queue_size> locked;
+        idsp::benchmark("Mutex ring write + read", iterations, [&]() {
+            locked.write(value);
+            locked.read(value);
+            idsp::_bench::keep(value);
+        });
+    }
+
+    idsp::benchmark_header("Producer thread to consumer thread, " + std::to_string(std::thread::hardware_concurrency()) + " host threads");
+    {
+        idsp::RingBuffer<uint32_t, queue_size> queue;
+        transfer("RingBuffer single", [&](uint32_t next) -> uint32_t {
+            return queue.write(next) ? 1 : 0;
+        }, [&](uint64_t& checksum) -> uint32_t {
+            uint32_t value;
+            if (!queue.read(value))
+                return 0;
+            checksum += value;
+            return 1;
+        });
+
+        std::array<uint32_t, batch_size> in {}, out {};
+        transfer("RingBuffer batch of " + std::to_string(batch_size), [&](uint32_t next) -> uint32_t {
+            const size_t n = idsp::min<size_t>(batch_size, transfer_count - next);
+            for (size_t i = 0; i < n; i++)
+                in[i] = next + static_cast<uint32_t>(i);
+            return static_cast<uint32_t>(queue.write(in.data(), n));
+        }, [&](uint64_t& checksum) -> uint32_t {
+            const size_t n = queue.read(out.data(), out.size());
+            for (size_t i = 0; i < n; i++)
+                checksum += out[i];
+            return static_cast<uint32_t>(n);
+        });
+
+        LockedRingBuffer<uint32_t, queue_size> locked;
+        transfer("Mutex ring single", [&](uint32_t next) -> uint32_t {
+            return locked.write(next) ? 1 : 0;
+        }, [&](uint64_t& checksum) -> uint32_t {
+            uint32_t value;
+            if (!locked.read(value))
+                return 0;
+            checksum += value;
+            return 1;
+        });
+    }
+
+    return 0;
+}
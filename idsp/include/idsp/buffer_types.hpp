@@ -245,6 +245,66 @@ class PolySampleBufferStatic
         idsp::PolyBufferInterface _ref;
 };
 
+/** Arena of static audio buffers.
+ * Packs buffers of the compile-time sizes Sizes into one contiguous block,
+ * each starting on a 16-byte boundary. Use this for the delay lines of a
+ * network, so their memory is one static size and they sit together in
+ * cache.
+ */
+template<size_t... Sizes>
+class SampleBufferArena
+{
+    /** Samples per 16 bytes. */
+    static constexpr size_t _align = sizeof(Sample) < 16 ? 16 / sizeof(Sample) : 1;
+
+    public:
+        /** The number of buffers. */
+        static constexpr size_t count = sizeof...(Sizes);
+
+        /** The total samples in the arena, including alignment padding. */
+        static constexpr size_t total_size = (((Sizes + _align - 1) / _align * _align) + ... + 0);
+
+        SampleBufferArena():
+        _data{}
+        {
+            const std::array<size_t, count> sizes {Sizes...};
+            size_t offset = 0;
+            for (size_t n = 0; n < count; n++)
+            {
+                this->_refs[n] = idsp::BufferInterface(this->_data.data() + offset, sizes[n]);
+                offset += (sizes[n] + _align - 1) / _align * _align;
+            }
+        }
+
+        ~SampleBufferArena() = default;
+
+        /** The interfaces point into this arena, so it can't be copied. */
+        SampleBufferArena(const SampleBufferArena&) = delete;
+        SampleBufferArena& operator=(const SampleBufferArena&) = delete;
+
+        IDSP_CONSTEXPR_SINCE_CXX14
+        void erase()
+        {
+            this->_data.fill(Sample(0));
+        }
+
+        /** @returns An idsp::BufferInterface representing buffer @a n, valid
+         * for the arena's lifetime. */
+        IDSP_CONSTEXPR_SINCE_CXX14
+        idsp::BufferInterface& operator[](size_t n)
+            { return this->_refs[n]; }
+        constexpr const idsp::BufferInterface& operator[](size_t n) const
+            { return this->_refs[n]; }
+
+        /** @returns The number of buffers. */
+        constexpr size_t size() const
+            { return count; }
+
+    private:
+        alignas(16) std::array<Sample, total_size> _data;
+        std::array<idsp::BufferInterface, count> _refs;
+};
+
 
 /** Dynamic audio buffer class.
  * Use this for runtime variable-size audio buffers.
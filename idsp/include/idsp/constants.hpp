@@ -1,6 +1,8 @@
 #ifndef IDSP_CONSTANTS
 #define IDSP_CONSTANTS
 
+#include "idsp/fixed_point.hpp"
+
 #include "math.h"
 #include <array>
 
@@ -12,6 +14,11 @@ namespace idsp
         #define Sample float
     #endif
 
+    /** Type for coefficients and intermediate state. See @ref SampleTraits. */
+    using SampleCompute = SampleTraits<Sample>::compute_type;
+    /** Type for control-rate parameters. See @ref SampleTraits. */
+    using SampleParameter = SampleTraits<Sample>::parameter_type;
+
     static constexpr float pi {static_cast<float>(M_PI)};
 
     static constexpr float twopi {2.f * pi};
@@ -7,6 +7,7 @@
 #include "idsp/wrapper.hpp"
 #include "idsp/modulation.hpp"
 #include "idsp/reverb_toolkit.hpp"
+#include <algorithm>
 #include <vector>
 #include <array>
 
@@ -17,6 +18,7 @@ namespace idsp
     {
         public:
             VarispeedDelay() :
+            delay_time{0.f},
             slew_amount{2400.f},
             slew_position{0.f},
             freeze{false}
@@ -25,15 +27,13 @@ namespace idsp
 
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for(size_t i = 0; i < input.size(); i++)
-                    output[i] = _process(input[i]);
+                _process_block(input.data(), output.data(), input.size());
             }
 
             template<size_t N>
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    output[i] = _process(input[i]);
+                _process_block(input.data(), output.data(), N);
             }
 
             inline void set_time(const float f) {delay_time = min<float>(f, delay->get_size());}
@@ -52,6 +52,47 @@ namespace idsp
                 if(!freeze)delay->write(input);
                 return output;
             }
+
+            // Short delay times fall back to per-sample reads and writes, see AudioRingBuffer::can_read_block()
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<float, _block_size> positions;
+                std::array<Sample, _block_size> dry;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(num_samples, _block_size);
+                    for(size_t i = 0; i < n; i++)
+                    {
+                        slew_position += ((delay_time-slew_position)/slew_amount);
+                        positions[i] = slew_position;
+                    }
+                    if(freeze)
+                    {
+                        for(size_t i = 0; i < n; i++)
+                            output[i] = delay->read_offset_smooth_safe(positions[i]);
+                    }
+                    else if(delay->can_read_block(positions.data(), n))
+                    {
+                        std::copy_n(input, n, dry.data());
+                        delay->read_offset_smooth_safe(positions.data(), output, n);
+                        delay->write(dry.data(), n);
+                    }
+                    else
+                    {
+                        for(size_t i = 0; i < n; i++)
+                        {
+                            const Sample x = input[i];
+                            output[i] = delay->read_offset_smooth_safe(positions[i]);
+                            delay->write(x);
+                        }
+                    }
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
+            }
+
+            static constexpr size_t _block_size = 32;
             Delay<SampleBufferStatic<S>> delay;
             float delay_time;
             float slew_amount;
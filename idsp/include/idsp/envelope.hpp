@@ -177,7 +177,7 @@ namespace idsp
                 }
                 prev_gate = gate;
                 retrigger = false;
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
             private:
@@ -195,7 +195,7 @@ namespace idsp
             float hold_time_remaining; /* ^^^^^^^^^^ */
             float sustain_level;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -289,7 +289,7 @@ namespace idsp
                         break;
                 }
                 prev_gate = gate;
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
             private:
@@ -303,7 +303,7 @@ namespace idsp
 
             float attack_time;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -419,7 +419,7 @@ namespace idsp
                         break;
                 }
                 prev_gate = gate;
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
             private:
@@ -435,7 +435,7 @@ namespace idsp
             float decay_time;
             float sustain_level;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -547,7 +547,7 @@ namespace idsp
                         break;
                 }
                 prev_gate = gate;
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
             private:
@@ -564,7 +564,7 @@ namespace idsp
             float hold_time_remaining; /* ^^^^^^^^^^ */
             float sustain_level;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -680,7 +680,7 @@ namespace idsp
                         break;
                 }
                 prev_gate = gate;
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
             private:
@@ -696,7 +696,7 @@ namespace idsp
             float decay_time;
             float sustain_level;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -752,7 +752,7 @@ namespace idsp
                 switch (state)
                 {
                     case State::ATTACK:
-                        if((x >= 0.995f || (((input - x) < 0.01f) && (mode == Mode::GATE))))
+                        if((x >= 0.995f || (((static_cast<float>(input) - x) < 0.01f) && (mode == Mode::GATE))))
                         {
                             state = State::RELEASE;
                         }
@@ -778,7 +778,7 @@ namespace idsp
                         state = State::IDLE;
                         break;
                 }
-                return clamp(x, 0.f, 1.f);
+                return Sample(clamp(x, 0.f, 1.f));
             }
 
         private:
@@ -792,7 +792,7 @@ namespace idsp
 
             float attack_time;
             float release_time;
-            Sample x;
+            float x;
             float shape;
             State state;
             EnvelopeMode mode;
@@ -834,11 +834,11 @@ namespace idsp
             Sample _process(const Sample input)
             {
                  //rectify the input
-                Sample in_sample = fabs(input);
+                Sample in_sample = input < Sample(0) ? -input : input;
                 //square for rms
                 in_sample *= in_sample;
                 //use env as voltage controlled slew limiter
-                return env.process(in_sample);
+                return env.process(in_sample != Sample(0));
             }
 
             Envelope env;
@@ -5,6 +5,7 @@
 #include "idsp/functions.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 namespace idsp
@@ -21,16 +22,17 @@ namespace idsp
             };
 
             constexpr
-            OnepoleFilter(Type filter_type, Sample cutoff):
+            OnepoleFilter(Type filter_type, SampleParameter cutoff):
             type{filter_type},
-            coef{Sample(1) / (Sample(M_PI) * cutoff)},
-            xState{Sample{}},
-            yState{Sample{}}
+            gain{SampleCompute(OnepoleFilter::input_gain(cutoff))},
+            feedback{SampleCompute(OnepoleFilter::feedback_gain(cutoff))},
+            xState{},
+            yState{}
             {}
 
             constexpr
             OnepoleFilter(Type filter_type):
-            OnepoleFilter(filter_type, Sample(0.1))
+            OnepoleFilter(filter_type, SampleParameter(0.1))
             {}
 
             IDSP_CONSTEXPR_SINCE_CXX20
@@ -38,9 +40,25 @@ namespace idsp
 
             /** Set normalised cutoff/center frequency. */
             IDSP_CONSTEXPR_SINCE_CXX14
-            void set_cutoff(Sample f)
+            void set_cutoff(SampleParameter f)
             {
-                this->coef = Sample(1) / (pi * f);
+                this->gain = SampleCompute(OnepoleFilter::input_gain(f));
+                this->feedback = SampleCompute(OnepoleFilter::feedback_gain(f));
+            }
+
+            /** The lowpass recurrence is y = g * (x + x[n-1]) - h * y[n-1],
+             * with w = pi * f, g = w / (w + 1) and h = (w - 1) / (w + 1).
+             * @return g for normalised cutoff @a f.
+             */
+            static constexpr SampleParameter input_gain(SampleParameter f)
+            {
+                return (SampleParameter(pi) * f) / (SampleParameter(pi) * f + SampleParameter(1));
+            }
+
+            /** @return h for normalised cutoff @a f, see input_gain(). */
+            static constexpr SampleParameter feedback_gain(SampleParameter f)
+            {
+                return (SampleParameter(pi) * f - SampleParameter(1)) / (SampleParameter(pi) * f + SampleParameter(1));
             }
 
             /** Filter block processor. */
@@ -59,25 +77,29 @@ namespace idsp
 
         private:
             IDSP_CONSTEXPR_SINCE_CXX14
-            Sample _process_lowpass(Sample x)
+            SampleCompute _integrate(SampleCompute x)
             {
-                this->yState = (x + this->xState - this->yState * (Sample(1) - this->coef)) / (Sample(1) + this->coef);
+                this->yState = this->gain * (x + this->xState) - this->feedback * this->yState;
                 this->xState = x;
                 return this->yState;
             }
             IDSP_CONSTEXPR_SINCE_CXX14
+            Sample _process_lowpass(Sample x)
+            {
+                return Sample(this->_integrate(SampleCompute(x)));
+            }
+            IDSP_CONSTEXPR_SINCE_CXX14
             Sample _process_highpass(Sample x)
             {
-                this->yState = (x + this->xState - this->yState * (Sample(1) - this->coef)) / (Sample(1) + this->coef);
-                this->xState = x;
-                return x - this->yState;
+                const SampleCompute xc = SampleCompute(x);
+                return Sample(xc - this->_integrate(xc));
             }
             IDSP_CONSTEXPR_SINCE_CXX14
             Sample _process_allpass(Sample x)
             {
-                this->yState = (x + this->xState - this->yState * (Sample(1) - this->coef)) / (Sample(1) + this->coef);
-                this->xState = x;
-                return this->yState - (x - this->yState);
+                const SampleCompute xc = SampleCompute(x);
+                const SampleCompute y = this->_integrate(xc);
+                return Sample(y - (xc - y));
             }
 
             IDSP_CONSTEXPR_SINCE_CXX14
@@ -125,9 +147,173 @@ namespace idsp
 
             Type type;
 
-            Sample coef;
-            Sample xState;
-            Sample yState;
+            /** Coefficients g and h, see input_gain(). */
+            SampleCompute gain;
+            SampleCompute feedback;
+            SampleCompute xState;
+            SampleCompute yState;
+    };
+
+    /** Bank of @a N independent one-pole filters, each with its own type
+     * and cutoff, processed together.
+     * Stored structure-of-arrays like BiquadBank. Each filter's output is
+     * its lowpass state mixed with its input, y * wet + x * dry, so the
+     * filters can have different types and still share one loop.
+     * Each filter computes what an OnepoleFilter with the same parameters
+     * would.
+     */
+    template<size_t N>
+    class OnepoleBank
+    {
+        static_assert(N > 0, "OnepoleBank needs at least one filter.");
+
+        /** Frames transposed per pass in the planar block processors. */
+        static constexpr size_t _tile_size = 16;
+
+        public:
+            using Type = typename OnepoleFilter::Type;
+
+            OnepoleBank(Type filter_type, SampleParameter cutoff)
+            {
+                for (size_t n = 0; n < N; n++)
+                {
+                    this->set_type(n, filter_type);
+                    this->set_cutoff(n, cutoff);
+                }
+                this->reset();
+            }
+
+            OnepoleBank(Type filter_type):
+            OnepoleBank(filter_type, SampleParameter(0.1))
+            {}
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~OnepoleBank() = default;
+
+            /** Sets the type of filter @a n. */
+            void set_type(size_t n, Type filter_type)
+            {
+                switch (filter_type)
+                {
+                    case Type::Lowpass:
+                        this->wet[n] = SampleCompute(1);
+                        this->dry[n] = SampleCompute(0);
+                        break;
+                    case Type::Highpass:
+                        this->wet[n] = SampleCompute(-1);
+                        this->dry[n] = SampleCompute(1);
+                        break;
+                    case Type::Allpass:
+                        this->wet[n] = SampleCompute(2);
+                        this->dry[n] = SampleCompute(-1);
+                        break;
+                    default:
+                        this->wet[n] = SampleCompute(0);
+                        this->dry[n] = SampleCompute(1);
+                        break;
+                }
+            }
+
+            /** Sets the normalised cutoff of filter @a n. */
+            void set_cutoff(size_t n, SampleParameter f)
+            {
+                this->gain[n] = SampleCompute(OnepoleFilter::input_gain(f));
+                this->feedback[n] = SampleCompute(OnepoleFilter::feedback_gain(f));
+            }
+
+            /** Sets the normalised cutoff of every filter. */
+            void set_cutoff(SampleParameter f)
+            {
+                for (size_t n = 0; n < N; n++)
+                    this->set_cutoff(n, f);
+            }
+
+            /** Clears the state of every filter. */
+            void reset()
+            {
+                this->xState.fill(SampleCompute(0));
+                this->yState.fill(SampleCompute(0));
+            }
+
+            /** Frame processor: filters one sample of each of the N channels.
+             * Works in place. */
+            void process(const Sample* input, Sample* output)
+            {
+                std::array<SampleCompute, N> frame;
+                for (size_t n = 0; n < N; n++)
+                    frame[n] = SampleCompute(input[n]);
+                this->_process_frame(frame);
+                for (size_t n = 0; n < N; n++)
+                    output[n] = Sample(frame[n]);
+            }
+
+            /** Interleaved block processor: @a input and @a output hold
+             * @a num_frames frames of N samples each. Works in place. */
+            void process_interleaved(const Sample* input, Sample* output, size_t num_frames)
+            {
+                for (size_t i = 0; i < num_frames; i++)
+                    this->process(input + i * N, output + i * N);
+            }
+
+            /** Planar block processor: channel n of @a input is filtered by
+             * filter n into channel n of @a output. Works in place.
+             * @note Both must have at least N channels of equal length.
+             */
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, input.data_size());
+            }
+
+            template<size_t Bs>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, Bs);
+            }
+
+        private:
+            inline void _process_frame(std::array<SampleCompute, N>& x)
+            {
+                for (size_t n = 0; n < N; n++)
+                {
+                    this->yState[n] = this->gain[n] * (x[n] + this->xState[n]) - this->feedback[n] * this->yState[n];
+                    this->xState[n] = x[n];
+                    x[n] = this->yState[n] * this->wet[n] + x[n] * this->dry[n];
+                }
+            }
+
+            // Transposes a tile of frames so the filter update can run
+            // across channels, then transposes the results back
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                std::array<std::array<SampleCompute, N>, _tile_size> tile;
+                for (size_t start = 0; start < num_frames; start += _tile_size)
+                {
+                    const size_t size = idsp::min(_tile_size, num_frames - start);
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        const Sample* in = input[n].data() + start;
+                        for (size_t i = 0; i < size; i++)
+                            tile[i][n] = SampleCompute(in[i]);
+                    }
+                    for (size_t i = 0; i < size; i++)
+                        this->_process_frame(tile[i]);
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        Sample* out = output[n].data() + start;
+                        for (size_t i = 0; i < size; i++)
+                            out[i] = Sample(tile[i][n]);
+                    }
+                }
+            }
+
+            // Coefficients g and h (see OnepoleFilter::input_gain()), the
+            // output mix and the state of each filter
+            alignas(16) std::array<SampleCompute, N> gain;
+            alignas(16) std::array<SampleCompute, N> feedback;
+            alignas(16) std::array<SampleCompute, N> wet;
+            alignas(16) std::array<SampleCompute, N> dry;
+            alignas(16) std::array<SampleCompute, N> xState;
+            alignas(16) std::array<SampleCompute, N> yState;
     };
 
     /** Biquadratic multi-mode filter. */
@@ -147,20 +333,24 @@ namespace idsp
                 Notch
             };
 
-            IDSP_CONSTEXPR_SINCE_CXX14
+            IDSP_CONSTEXPR_SINCE_CXX20
             BiquadFilter(Type filter_type):
             type{filter_type},
             a{},
             b{},
+            a_target{},
+            b_target{},
+            ramp_pending{false},
             xState{}
             {
-                this->a.fill(0);
-                this->b.fill(0);
-                this->xState.fill(0);
+                this->a.fill(SampleCompute(0));
+                this->b.fill(SampleCompute(0));
+                this->a_target.fill(SampleCompute(0));
+                this->b_target.fill(SampleCompute(0));
+                this->xState.fill(SampleCompute(0));
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
-            BiquadFilter(Type filter_type, Sample f, Sample Q, Sample V = Sample(1)):
+            BiquadFilter(Type filter_type, SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1)):
             BiquadFilter(filter_type)
             {
                 this->set_parameters(f, Q, V);
@@ -170,125 +360,155 @@ namespace idsp
             ~BiquadFilter() = default;
 
             /** Set the filter's parameters.
+             * The new coefficients apply from the next sample.
              * @param f The filter cutoff/center normalised frequency.
              * @param Q Filter resonance.
              */
-            void set_parameters(Sample f, Sample Q, Sample V = Sample(1))
+            void set_parameters(SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1))
+            {
+                this->_set_target(f, Q, V);
+                this->_finish_ramp();
+            }
+
+            /** Set the filter's parameters, gliding to them over the next
+             * block.
+             * The next block call moves every coefficient linearly from its
+             * current value to the new one, reaching it on the block's last
+             * sample, so swept parameters don't produce steps. Stable
+             * biquads form a convex set, so every coefficient set on the way
+             * is stable too. A sample call applies the new coefficients at
+             * once.
+             */
+            void set_parameters_smooth(SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1))
             {
-                constexpr Sample sqrt2 = M_SQRT2;
-                const Sample K = std::tan(pi * f);
+                this->_set_target(f, Q, V);
+                this->ramp_pending = true;
+            }
+
+            /** Computes the normalised coefficients of a filter of type @a type.
+             * @param a Receives the feedback coefficients a1 and a2 (a0 is 1).
+             * @param b Receives the feedforward coefficients b0, b1 and b2.
+             */
+            static void compute_coefficients(Type type, SampleParameter f, SampleParameter Q, SampleParameter V,
+                std::array<SampleParameter, 3>& a, std::array<SampleParameter, 3>& b)
+            {
+                using T = SampleParameter;
+                constexpr T sqrt2 = M_SQRT2;
+                const T K = idsp::tan_pi_fast(f);
+                a.fill(T(0));
+                b.fill(T(0));
 
                 switch (type) {
                     case Type::Lowpass1Pole: {
-                        this->a[0] = -std::exp(-Sample(2) * pi * f);
-                        this->a[1] = Sample(0);
-                        this->b[0] = Sample(1) + this->a[0];
-                        this->b[1] = Sample(0);
-                        this->b[2] = Sample(0);
+                        a[0] = -idsp::exp_fast(-T(2) * T(pi) * f);
+                        a[1] = T(0);
+                        b[0] = T(1) + a[0];
+                        b[1] = T(0);
+                        b[2] = T(0);
                     } break;
 
                     case Type::Highpass1Pole: {
-                        this->a[0] = std::exp(-Sample(2) * pi * (0.5f - f));
-                        this->a[1] = Sample(0);
-                        this->b[0] = Sample(1) - this->a[0];
-                        this->b[1] = Sample(0);
-                        this->b[2] = Sample(0);
+                        a[0] = idsp::exp_fast(-T(2) * T(pi) * (T(0.5) - f));
+                        a[1] = T(0);
+                        b[0] = T(1) - a[0];
+                        b[1] = T(0);
+                        b[2] = T(0);
                     } break;
 
                     case Type::Lowpass: {
-                        const Sample norm = Sample(1) / (Sample(1) + K / Q + K * K);
-                        this->b[0] = K * K * norm;
-                        this->b[1] = Sample(2) * this->b[0];
-                        this->b[2] = this->b[0];
-                        this->a[0] = Sample(2) * (K * K - Sample(1)) * norm;
-                        this->a[1] = (Sample(1) - K / Q + K * K) * norm;
+                        const T norm = T(1) / (T(1) + K / Q + K * K);
+                        b[0] = K * K * norm;
+                        b[1] = T(2) * b[0];
+                        b[2] = b[0];
+                        a[0] = T(2) * (K * K - T(1)) * norm;
+                        a[1] = (T(1) - K / Q + K * K) * norm;
                     } break;
 
                     case Type::Highpass: {
-                        const Sample norm = Sample(1) / (Sample(1) + K / Q + K * K);
-                        this->b[0] = norm;
-                        this->b[1] = -Sample(2) * this->b[0];
-                        this->b[2] = this->b[0];
-                        this->a[0] = Sample(2) * (K * K - Sample(1)) * norm;
-                        this->a[1] = (Sample(1) - K / Q + K * K) * norm;
+                        const T norm = T(1) / (T(1) + K / Q + K * K);
+                        b[0] = norm;
+                        b[1] = -T(2) * b[0];
+                        b[2] = b[0];
+                        a[0] = T(2) * (K * K - T(1)) * norm;
+                        a[1] = (T(1) - K / Q + K * K) * norm;
 
                     } break;
 
                     case Type::Lowshelf: {
-                        const Sample sqrtV = std::sqrt(V);
-                        if (V >= Sample(1)) {
-                            const Sample norm = Sample(1) / (Sample(1) + sqrt2 * K + K * K);
-                            this->b[0] = (Sample(1) + sqrt2 * sqrtV * K + V * K * K) * norm;
-                            this->b[1] = Sample(2) * (V * K * K - Sample(1)) * norm;
-                            this->b[2] = (Sample(1) - sqrt2 * sqrtV * K + V * K * K) * norm;
-                            this->a[0] = Sample(2) * (K * K - Sample(1)) * norm;
-                            this->a[1] = (Sample(1) - sqrt2 * K + K * K) * norm;
+                        const T sqrtV = std::sqrt(V);
+                        if (V >= T(1)) {
+                            const T norm = T(1) / (T(1) + sqrt2 * K + K * K);
+                            b[0] = (T(1) + sqrt2 * sqrtV * K + V * K * K) * norm;
+                            b[1] = T(2) * (V * K * K - T(1)) * norm;
+                            b[2] = (T(1) - sqrt2 * sqrtV * K + V * K * K) * norm;
+                            a[0] = T(2) * (K * K - T(1)) * norm;
+                            a[1] = (T(1) - sqrt2 * K + K * K) * norm;
                         }
                         else {
-                            const Sample norm = Sample(1) / (Sample(1) + sqrt2 / sqrtV * K + K * K / V);
-                            this->b[0] = (Sample(1) + sqrt2 * K + K * K) * norm;
-                            this->b[1] = Sample(2) * (K * K - 1) * norm;
-                            this->b[2] = (Sample(1) - sqrt2 * K + K * K) * norm;
-                            this->a[0] = Sample(2) * (K * K / V - Sample(1)) * norm;
-                            this->a[1] = (Sample(1) - sqrt2 / sqrtV * K + K * K / V) * norm;
+                            const T norm = T(1) / (T(1) + sqrt2 / sqrtV * K + K * K / V);
+                            b[0] = (T(1) + sqrt2 * K + K * K) * norm;
+                            b[1] = T(2) * (K * K - 1) * norm;
+                            b[2] = (T(1) - sqrt2 * K + K * K) * norm;
+                            a[0] = T(2) * (K * K / V - T(1)) * norm;
+                            a[1] = (T(1) - sqrt2 / sqrtV * K + K * K / V) * norm;
                         }
                     } break;
 
                     case Type::Highshelf: {
-                        const Sample sqrtV = std::sqrt(V);
-                        if (V >= Sample(1)) {
-                            const Sample norm = Sample(1) / (Sample(1) + sqrt2 * K + K * K);
-                            this->b[0] = (V + sqrt2 * sqrtV * K + K * K) * norm;
-                            this->b[1] = Sample(2) * (K * K - V) * norm;
-                            this->b[2] = (V - sqrt2 * sqrtV * K + K * K) * norm;
-                            this->a[0] = Sample(2) * (K * K - Sample(1)) * norm;
-                            this->a[1] = (Sample(1) - sqrt2 * K + K * K) * norm;
+                        const T sqrtV = std::sqrt(V);
+                        if (V >= T(1)) {
+                            const T norm = T(1) / (T(1) + sqrt2 * K + K * K);
+                            b[0] = (V + sqrt2 * sqrtV * K + K * K) * norm;
+                            b[1] = T(2) * (K * K - V) * norm;
+                            b[2] = (V - sqrt2 * sqrtV * K + K * K) * norm;
+                            a[0] = T(2) * (K * K - T(1)) * norm;
+                            a[1] = (T(1) - sqrt2 * K + K * K) * norm;
                         }
                         else {
-                            const Sample norm = Sample(1) / (Sample(1) / V + sqrt2 / sqrtV * K + K * K);
-                            this->b[0] = (Sample(1) + sqrt2 * K + K * K) * norm;
-                            this->b[1] = Sample(2) * (K * K - Sample(1)) * norm;
-                            this->b[2] = (Sample(1) - sqrt2 * K + K * K) * norm;
-                            this->a[0] = Sample(2) * (K * K - Sample(1) / V) * norm;
-                            this->a[1] = (Sample(1) / V - sqrt2 / sqrtV * K + K * K) * norm;
+                            const T norm = T(1) / (T(1) / V + sqrt2 / sqrtV * K + K * K);
+                            b[0] = (T(1) + sqrt2 * K + K * K) * norm;
+                            b[1] = T(2) * (K * K - T(1)) * norm;
+                            b[2] = (T(1) - sqrt2 * K + K * K) * norm;
+                            a[0] = T(2) * (K * K - T(1) / V) * norm;
+                            a[1] = (T(1) / V - sqrt2 / sqrtV * K + K * K) * norm;
                         }
                     } break;
 
                     case Type::Bandpass: {
-                        const Sample norm = Sample(1) / (Sample(1) + K / Q + K * K);
-                        this->b[0] = K / Q * norm;
-                        this->b[1] = Sample(0);
-                        this->b[2] = -this->b[0];
-                        this->a[0] = Sample(2) * (K * K - Sample(1)) * norm;
-                        this->a[1] = (Sample(1) - K / Q + K * K) * norm;
+                        const T norm = T(1) / (T(1) + K / Q + K * K);
+                        b[0] = K / Q * norm;
+                        b[1] = T(0);
+                        b[2] = -b[0];
+                        a[0] = T(2) * (K * K - T(1)) * norm;
+                        a[1] = (T(1) - K / Q + K * K) * norm;
                     } break;
 
                     case Type::Peak: {
-                        if (V >= Sample(1)) {
-                            const Sample norm = Sample(1) / (Sample(1) + K / Q + K * K);
-                            this->b[0] = (Sample(1) + K / Q * V + K * K) * norm;
-                            this->b[1] = Sample(2) * (K * K - Sample(1)) * norm;
-                            this->b[2] = (Sample(1) - K / Q * V + K * K) * norm;
-                            this->a[0] = this->b[1];
-                            this->a[1] = (Sample(1) - K / Q + K * K) * norm;
+                        if (V >= T(1)) {
+                            const T norm = T(1) / (T(1) + K / Q + K * K);
+                            b[0] = (T(1) + K / Q * V + K * K) * norm;
+                            b[1] = T(2) * (K * K - T(1)) * norm;
+                            b[2] = (T(1) - K / Q * V + K * K) * norm;
+                            a[0] = b[1];
+                            a[1] = (T(1) - K / Q + K * K) * norm;
                         }
                         else {
-                            const Sample norm = Sample(1) / (Sample(1) + K / Q / V + K * K);
-                            this->b[0] = (Sample(1) + K / Q + K * K) * norm;
-                            this->b[1] = Sample(2) * (K * K - Sample(1)) * norm;
-                            this->b[2] = (Sample(1) - K / Q + K * K) * norm;
-                            this->a[0] = this->b[1];
-                            this->a[1] = (Sample(1) - K / Q / V + K * K) * norm;
+                            const T norm = T(1) / (T(1) + K / Q / V + K * K);
+                            b[0] = (T(1) + K / Q + K * K) * norm;
+                            b[1] = T(2) * (K * K - T(1)) * norm;
+                            b[2] = (T(1) - K / Q + K * K) * norm;
+                            a[0] = b[1];
+                            a[1] = (T(1) - K / Q / V + K * K) * norm;
                         }
                     } break;
 
                     case Type::Notch: {
-                        const Sample norm = Sample(1) / (Sample(1) + K / Q + K * K);
-                        this->b[0] = (Sample(1) + K * K) * norm;
-                        this->b[1] = Sample(2) * (K * K - Sample(1)) * norm;
-                        this->b[2] = this->b[0];
-                        this->a[0] = this->b[1];
-                        this->a[1] = (Sample(1) - K / Q + K * K) * norm;
+                        const T norm = T(1) / (T(1) + K / Q + K * K);
+                        b[0] = (T(1) + K * K) * norm;
+                        b[1] = T(2) * (K * K - T(1)) * norm;
+                        b[2] = b[0];
+                        a[0] = b[1];
+                        a[1] = (T(1) - K / Q + K * K) * norm;
                     } break;
 
                     default: break;
@@ -310,34 +530,253 @@ namespace idsp
             }
 
         private:
+            void _set_target(SampleParameter f, SampleParameter Q, SampleParameter V)
+            {
+                // Coefficients are computed in the parameter type and only
+                // converted once they are within range
+                std::array<SampleParameter, 3> a {};
+                std::array<SampleParameter, 3> b {};
+                BiquadFilter::compute_coefficients(this->type, f, Q, V, a, b);
+
+                for (size_t i = 0; i < 3; i++)
+                {
+                    this->a_target[i] = SampleCompute(a[i]);
+                    this->b_target[i] = SampleCompute(b[i]);
+                }
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void _finish_ramp()
+            {
+                this->a = this->a_target;
+                this->b = this->b_target;
+                this->ramp_pending = false;
+            }
+
             IDSP_CONSTEXPR_SINCE_CXX14
             Sample _process_sample(Sample x)
+            {
+                if (this->ramp_pending)
+                    this->_finish_ramp();
+                return this->_filter(x);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            Sample _filter(Sample x)
             {
                 // Feedback coefficients
-                this->xState[0] = x + (this->xState[1] * -this->a[1]) + (this->xState[2] * -this->a[2]);
+                this->xState[0] = SampleCompute(x) - (this->xState[1] * this->a[0]) - (this->xState[2] * this->a[1]);
                 // Feedfoward coefficients
                 const auto out = (this->xState[0] * this->b[0]) + (this->xState[1] * this->b[1]) + (this->xState[2] * this->b[2]);
                 // Shift delay blocks
                 this->xState[2] = this->xState[1];
                 this->xState[1] = this->xState[0];
-                return out;
+                return Sample(out);
             }
 
             IDSP_CONSTEXPR_SINCE_CXX14
             void _process_block(const BufferInterface& input, BufferInterface& output)
             {
                 const size_t size = idsp::min(input.size(), output.size());
+                if (this->ramp_pending && size > 0)
+                {
+                    const SampleCompute step = SampleCompute(SampleParameter(1) / SampleParameter(size));
+                    std::array<SampleCompute, 3> da {};
+                    std::array<SampleCompute, 3> db {};
+                    for (size_t j = 0; j < 3; j++)
+                    {
+                        da[j] = (this->a_target[j] - this->a[j]) * step;
+                        db[j] = (this->b_target[j] - this->b[j]) * step;
+                    }
+                    for (size_t i = 0; i + 1 < size; i++)
+                    {
+                        for (size_t j = 0; j < 3; j++)
+                        {
+                            this->a[j] += da[j];
+                            this->b[j] += db[j];
+                        }
+                        output[i] = this->_filter(input[i]);
+                    }
+                    this->_finish_ramp();
+                    output[size - 1] = this->_filter(input[size - 1]);
+                    return;
+                }
                 for (size_t i = 0; i < size; i++)
                 {
-                    output[i] = this->_process_sample(input[i]);
+                    output[i] = this->_filter(input[i]);
                 }
             }
 
             Type type;
 
-            std::array<Sample, 3> a;
-            std::array<Sample, 3> b;
-            std::array<Sample, 3> xState;
+            /** Feedback coefficients a1 and a2 (a0 is normalised to 1). */
+            std::array<SampleCompute, 3> a;
+            std::array<SampleCompute, 3> b;
+            /** Coefficients a set_parameters_smooth() call is gliding to. */
+            std::array<SampleCompute, 3> a_target;
+            std::array<SampleCompute, 3> b_target;
+            bool ramp_pending;
+            std::array<SampleCompute, 3> xState;
+    };
+
+    /** Bank of @a N independent biquads, each with its own type and
+     * parameters, processed together.
+     * Coefficients and state are stored structure-of-arrays and the
+     * per-sample update runs across the filters, so on hosts with SIMD the
+     * compiler processes 4 (SSE/NEON) or 8 (AVX) filters per instruction.
+     * Each filter computes exactly what a BiquadFilter with the same
+     * parameters would.
+     */
+    template<size_t N>
+    class BiquadBank
+    {
+        static_assert(N > 0, "BiquadBank needs at least one filter.");
+
+        /** Frames transposed per pass in the planar block processors. */
+        static constexpr size_t _tile_size = 16;
+
+        public:
+            using Type = typename BiquadFilter::Type;
+
+            BiquadBank(Type filter_type):
+            types{}
+            {
+                this->types.fill(filter_type);
+                this->a1.fill(SampleCompute(0));
+                this->a2.fill(SampleCompute(0));
+                this->b0.fill(SampleCompute(0));
+                this->b1.fill(SampleCompute(0));
+                this->b2.fill(SampleCompute(0));
+                this->reset();
+            }
+
+            BiquadBank(Type filter_type, SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1)):
+            BiquadBank(filter_type)
+            {
+                for (size_t n = 0; n < N; n++)
+                    this->set_parameters(n, f, Q, V);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~BiquadBank() = default;
+
+            /** Sets the type of filter @a n. Takes effect on the next
+             * set_parameters() call for that filter. */
+            void set_type(size_t n, Type filter_type)
+            {
+                this->types[n] = filter_type;
+            }
+
+            /** Sets the parameters of filter @a n, see BiquadFilter::set_parameters(). */
+            void set_parameters(size_t n, SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1))
+            {
+                std::array<SampleParameter, 3> a {};
+                std::array<SampleParameter, 3> b {};
+                BiquadFilter::compute_coefficients(this->types[n], f, Q, V, a, b);
+                this->a1[n] = SampleCompute(a[0]);
+                this->a2[n] = SampleCompute(a[1]);
+                this->b0[n] = SampleCompute(b[0]);
+                this->b1[n] = SampleCompute(b[1]);
+                this->b2[n] = SampleCompute(b[2]);
+            }
+
+            /** Sets the type and parameters of filter @a n. */
+            void set_parameters(size_t n, Type filter_type, SampleParameter f, SampleParameter Q, SampleParameter V = SampleParameter(1))
+            {
+                this->set_type(n, filter_type);
+                this->set_parameters(n, f, Q, V);
+            }
+
+            /** Clears the state of every filter. */
+            void reset()
+            {
+                this->s1.fill(SampleCompute(0));
+                this->s2.fill(SampleCompute(0));
+            }
+
+            /** Frame processor: filters one sample of each of the N channels.
+             * Works in place. */
+            void process(const Sample* input, Sample* output)
+            {
+                std::array<SampleCompute, N> frame;
+                for (size_t n = 0; n < N; n++)
+                    frame[n] = SampleCompute(input[n]);
+                this->_process_frame(frame);
+                for (size_t n = 0; n < N; n++)
+                    output[n] = Sample(frame[n]);
+            }
+
+            /** Interleaved block processor: @a input and @a output hold
+             * @a num_frames frames of N samples each. Works in place. */
+            void process_interleaved(const Sample* input, Sample* output, size_t num_frames)
+            {
+                for (size_t i = 0; i < num_frames; i++)
+                    this->process(input + i * N, output + i * N);
+            }
+
+            /** Planar block processor: channel n of @a input is filtered by
+             * filter n into channel n of @a output. Works in place.
+             * @note Both must have at least N channels of equal length.
+             */
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, input.data_size());
+            }
+
+            template<size_t Bs>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, Bs);
+            }
+
+        private:
+            inline void _process_frame(std::array<SampleCompute, N>& x)
+            {
+                for (size_t n = 0; n < N; n++)
+                {
+                    const SampleCompute w = x[n] - (this->s1[n] * this->a1[n]) - (this->s2[n] * this->a2[n]);
+                    x[n] = (w * this->b0[n]) + (this->s1[n] * this->b1[n]) + (this->s2[n] * this->b2[n]);
+                    this->s2[n] = this->s1[n];
+                    this->s1[n] = w;
+                }
+            }
+
+            // Transposes a tile of frames so the filter update can run
+            // across channels, then transposes the results back
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                std::array<std::array<SampleCompute, N>, _tile_size> tile;
+                for (size_t start = 0; start < num_frames; start += _tile_size)
+                {
+                    const size_t size = idsp::min(_tile_size, num_frames - start);
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        const Sample* in = input[n].data() + start;
+                        for (size_t i = 0; i < size; i++)
+                            tile[i][n] = SampleCompute(in[i]);
+                    }
+                    for (size_t i = 0; i < size; i++)
+                        this->_process_frame(tile[i]);
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        Sample* out = output[n].data() + start;
+                        for (size_t i = 0; i < size; i++)
+                            out[i] = Sample(tile[i][n]);
+                    }
+                }
+            }
+
+            std::array<Type, N> types;
+
+            // Feedback coefficients a1, a2 (a0 is normalised to 1),
+            // feedforward coefficients b0, b1, b2 and the two state samples
+            alignas(16) std::array<SampleCompute, N> a1;
+            alignas(16) std::array<SampleCompute, N> a2;
+            alignas(16) std::array<SampleCompute, N> b0;
+            alignas(16) std::array<SampleCompute, N> b1;
+            alignas(16) std::array<SampleCompute, N> b2;
+            alignas(16) std::array<SampleCompute, N> s1;
+            alignas(16) std::array<SampleCompute, N> s2;
     };
 
     class ToneControl
@@ -0,0 +1,364 @@
+#ifndef IDSP_FIXED_POINT_H
+#define IDSP_FIXED_POINT_H
+
+#include "idsp/std_helpers.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace idsp
+{
+
+    namespace _fixed
+    {
+        /** Integer type of twice the width of @a T, for intermediate results. */
+        template<class T> struct Wide;
+        template<> struct Wide<int8_t> { using type = int16_t; };
+        template<> struct Wide<int16_t> { using type = int32_t; };
+        template<> struct Wide<int32_t> { using type = int64_t; };
+
+        /** Clamps @a x to the range of @a T. */
+        template<class T, class W>
+        constexpr T saturate(W x)
+        {
+            return x > static_cast<W>(std::numeric_limits<T>::max()) ? std::numeric_limits<T>::max()
+                : x < static_cast<W>(std::numeric_limits<T>::min()) ? std::numeric_limits<T>::min()
+                : static_cast<T>(x);
+        }
+
+        /** Magnitude of @a x as an unsigned value, safe for the most negative value. */
+        constexpr uint64_t magnitude(int64_t x)
+        {
+            return x < 0 ? uint64_t(0) - static_cast<uint64_t>(x) : static_cast<uint64_t>(x);
+        }
+
+        /** Applies @a negative to the magnitude @a m, saturating to int64_t. */
+        constexpr int64_t signed_saturate(uint64_t m, bool negative)
+        {
+            constexpr uint64_t max = static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+            if (negative)
+                return m > max ? std::numeric_limits<int64_t>::min() : -static_cast<int64_t>(m);
+            return m > max ? std::numeric_limits<int64_t>::max() : static_cast<int64_t>(m);
+        }
+
+        /** Portable rounded, saturated (a * b) >> shift for 64-bit operands,
+         * using 32-bit partial products. For targets without a 128-bit type. */
+        constexpr int64_t mul_shift_64(int64_t a, int64_t b, unsigned shift)
+        {
+            const bool negative = (a < 0) != (b < 0);
+            const uint64_t ua = magnitude(a);
+            const uint64_t ub = magnitude(b);
+            const uint64_t a_lo = ua & 0xFFFFFFFFu, a_hi = ua >> 32;
+            const uint64_t b_lo = ub & 0xFFFFFFFFu, b_hi = ub >> 32;
+
+            const uint64_t ll = a_lo * b_lo;
+            const uint64_t lh = a_lo * b_hi;
+            const uint64_t hl = a_hi * b_lo;
+            const uint64_t hh = a_hi * b_hi;
+            const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+            uint64_t lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+            uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+            if (shift == 0)
+                return hi != 0 ? signed_saturate(~uint64_t(0), negative) : signed_saturate(lo, negative);
+
+            // Round to nearest, ties towards +inf to match the native path
+            const uint64_t rounding = (uint64_t(1) << (shift - 1)) - (negative ? 1 : 0);
+            lo += rounding;
+            if (lo < rounding)
+                hi++;
+
+            const uint64_t res_lo = (lo >> shift) | (shift < 64 ? (hi << (64 - shift)) : 0);
+            const uint64_t res_hi = hi >> shift;
+            return res_hi != 0 ? signed_saturate(~uint64_t(0), negative) : signed_saturate(res_lo, negative);
+        }
+
+        /** Portable saturated (a << shift) / b for 64-bit operands, using
+         * restoring long division. For targets without a 128-bit type. */
+        constexpr int64_t div_shift_64(int64_t a, int64_t b, unsigned shift)
+        {
+            const bool negative = (a < 0) != (b < 0);
+            if (b == 0)
+                return negative ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+
+            const uint64_t ua = magnitude(a);
+            const uint64_t ub = magnitude(b);
+            // 128-bit numerator ua << shift, as (n_hi, n_lo)
+            const uint64_t n_hi = shift == 0 ? 0 : (ua >> (64 - shift));
+            const uint64_t n_lo = shift == 0 ? ua : (ua << shift);
+
+            uint64_t q_hi = 0, q_lo = 0, rem = 0;
+            for (int bit = 127; bit >= 0; bit--)
+            {
+                const uint64_t n_bit = bit >= 64 ? (n_hi >> (bit - 64)) & 1u : (n_lo >> bit) & 1u;
+                // rem < ub <= 2^63, so this never overflows
+                rem = (rem << 1) | n_bit;
+                if (rem >= ub)
+                {
+                    rem -= ub;
+                    if (bit >= 64)
+                        q_hi |= uint64_t(1) << (bit - 64);
+                    else
+                        q_lo |= uint64_t(1) << bit;
+                }
+            }
+            return q_hi != 0 ? signed_saturate(~uint64_t(0), negative) : signed_saturate(q_lo, negative);
+        }
+
+        template<class T>
+        constexpr T add(T a, T b)
+            { return saturate<T>(static_cast<typename Wide<T>::type>(a) + b); }
+        constexpr int64_t add(int64_t a, int64_t b)
+        {
+            return (b > 0 && a > std::numeric_limits<int64_t>::max() - b) ? std::numeric_limits<int64_t>::max()
+                : (b < 0 && a < std::numeric_limits<int64_t>::min() - b) ? std::numeric_limits<int64_t>::min()
+                : a + b;
+        }
+
+        template<class T>
+        constexpr T sub(T a, T b)
+            { return saturate<T>(static_cast<typename Wide<T>::type>(a) - b); }
+        constexpr int64_t sub(int64_t a, int64_t b)
+        {
+            return (b < 0 && a > std::numeric_limits<int64_t>::max() + b) ? std::numeric_limits<int64_t>::max()
+                : (b > 0 && a < std::numeric_limits<int64_t>::min() + b) ? std::numeric_limits<int64_t>::min()
+                : a - b;
+        }
+
+        template<class T>
+        constexpr T mul(T a, T b, unsigned shift)
+        {
+            using W = typename Wide<T>::type;
+            const W rounding = shift > 0 ? (W(1) << (shift - 1)) : W(0);
+            return saturate<T>((static_cast<W>(a) * b + rounding) >> shift);
+        }
+        constexpr int64_t mul(int64_t a, int64_t b, unsigned shift)
+        {
+            #ifdef __SIZEOF_INT128__
+                const __int128 rounding = shift > 0 ? (static_cast<__int128>(1) << (shift - 1)) : 0;
+                return saturate<int64_t>((static_cast<__int128>(a) * b + rounding) >> shift);
+            #else
+                return mul_shift_64(a, b, shift);
+            #endif
+        }
+
+        template<class T>
+        constexpr T div(T a, T b, unsigned shift)
+        {
+            using W = typename Wide<T>::type;
+            if (b == 0)
+                return a < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+            return saturate<T>((static_cast<W>(a) * (W(1) << shift)) / b);
+        }
+        constexpr int64_t div(int64_t a, int64_t b, unsigned shift)
+        {
+            #ifdef __SIZEOF_INT128__
+                if (b == 0)
+                    return a < 0 ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+                return saturate<int64_t>((static_cast<__int128>(a) * (static_cast<__int128>(1) << shift)) / b);
+            #else
+                return div_shift_64(a, b, shift);
+            #endif
+        }
+
+        /** Rescales raw value @a x from @a From to @a To fractional bits, saturating
+         * to the range of @a T. */
+        template<class T>
+        constexpr T rescale_raw(int64_t x, unsigned from, unsigned to)
+        {
+            if (from >= to)
+            {
+                const unsigned s = from - to;
+                // Arithmetic shift rounds towards -inf; that's fine for conversions
+                return saturate<T>(s >= 64 ? (x < 0 ? -1 : 0) : (x >> s));
+            }
+            const unsigned s = to - from;
+            const int64_t limit = std::numeric_limits<int64_t>::max() >> s;
+            if (x > limit)
+                return std::numeric_limits<T>::max();
+            if (x < -limit - 1)
+                return std::numeric_limits<T>::min();
+            return saturate<T>(x * (int64_t(1) << s));
+        }
+    } // namespace _fixed
+
+    /** Saturating fixed-point number.
+     * Stores a signed integer of type @a Storage scaled by 2^-@a FracBits, so e.g.
+     * `FixedPoint<int16_t, 15>` is the classic Q15 format with range [-1:1).
+     * All arithmetic saturates at the bounds of the format instead of wrapping.
+     * Multiplication and division round via an intermediate of twice the width.
+     *
+     * Construction from any arithmetic type is implicit (and saturating), so
+     * existing code such as `Sample(0.5)` or `x * 0.5f` keeps working; conversion
+     * back to arithmetic types is explicit. Note that mixed expressions with a
+     * floating-point operand convert that operand at runtime, which is a
+     * soft-float operation on FPU-less targets – keep such constants in a
+     * `Sample` or @ref SampleTraits::compute_type member instead.
+     */
+    template<class Storage, unsigned FracBits>
+    class FixedPoint
+    {
+        static_assert(std::is_integral<Storage>::value && std::is_signed<Storage>::value,
+            "FixedPoint storage must be a signed integer type.");
+        static_assert(FracBits < sizeof(Storage) * 8, "Too many fractional bits for FixedPoint storage.");
+
+        struct RawTag {};
+
+        constexpr FixedPoint(Storage raw, RawTag):
+        _v{raw} {}
+
+        public:
+            using storage_type = Storage;
+            static constexpr unsigned frac_bits = FracBits;
+
+            constexpr FixedPoint():
+            _v{0} {}
+
+            /** Saturating conversion from a floating-point value, rounding to
+             * nearest. */
+            template<class T,
+            typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true>
+            constexpr FixedPoint(T x):
+            _v{_from_floating(static_cast<double>(x))} {}
+
+            /** Saturating conversion from an integer value. */
+            template<class T,
+            typename std::enable_if<std::is_integral<T>::value, bool>::type = true>
+            constexpr FixedPoint(T x):
+            _v{_fixed::rescale_raw<Storage>(static_cast<int64_t>(x), 0, FracBits)} {}
+
+            /** Saturating conversion from another fixed-point format. */
+            template<class S, unsigned F,
+            typename std::enable_if<!std::is_same<FixedPoint<S, F>, FixedPoint>::value, bool>::type = true>
+            explicit constexpr FixedPoint(FixedPoint<S, F> x):
+            _v{_fixed::rescale_raw<Storage>(static_cast<int64_t>(x.raw()), F, FracBits)} {}
+
+            /** Constructs a FixedPoint directly from its raw integer representation. */
+            static constexpr FixedPoint from_raw(Storage raw)
+                { return FixedPoint(raw, RawTag{}); }
+
+            /** @returns The raw integer representation. */
+            constexpr Storage raw() const
+                { return this->_v; }
+
+            /** Conversion to arithmetic types. Integer conversion truncates towards
+             * negative infinity. */
+            template<class T,
+            typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true>
+            explicit constexpr operator T() const
+                { return static_cast<T>(this->_v) * (T(1) / static_cast<T>(_one())); }
+            template<class T,
+            typename std::enable_if<std::is_integral<T>::value, bool>::type = true>
+            explicit constexpr operator T() const
+                { return static_cast<T>(this->_v >> FracBits); }
+
+            /** @returns The smallest and largest representable values, and the
+             * smallest positive step. */
+            static constexpr FixedPoint min()
+                { return from_raw(std::numeric_limits<Storage>::min()); }
+            static constexpr FixedPoint max()
+                { return from_raw(std::numeric_limits<Storage>::max()); }
+            static constexpr FixedPoint epsilon()
+                { return from_raw(1); }
+
+            // Arithmetic
+            friend constexpr FixedPoint operator+(FixedPoint a, FixedPoint b)
+                { return from_raw(_fixed::add(a._v, b._v)); }
+            friend constexpr FixedPoint operator-(FixedPoint a, FixedPoint b)
+                { return from_raw(_fixed::sub(a._v, b._v)); }
+            friend constexpr FixedPoint operator*(FixedPoint a, FixedPoint b)
+                { return from_raw(_fixed::mul(a._v, b._v, FracBits)); }
+            friend constexpr FixedPoint operator/(FixedPoint a, FixedPoint b)
+                { return from_raw(_fixed::div(a._v, b._v, FracBits)); }
+            friend constexpr FixedPoint operator-(FixedPoint a)
+                { return from_raw(_fixed::sub(Storage(0), a._v)); }
+            friend constexpr FixedPoint operator+(FixedPoint a)
+                { return a; }
+
+            IDSP_CONSTEXPR_SINCE_CXX14 FixedPoint& operator+=(FixedPoint b)
+                { return *this = *this + b; }
+            IDSP_CONSTEXPR_SINCE_CXX14 FixedPoint& operator-=(FixedPoint b)
+                { return *this = *this - b; }
+            IDSP_CONSTEXPR_SINCE_CXX14 FixedPoint& operator*=(FixedPoint b)
+                { return *this = *this * b; }
+            IDSP_CONSTEXPR_SINCE_CXX14 FixedPoint& operator/=(FixedPoint b)
+                { return *this = *this / b; }
+
+            // Comparison
+            friend constexpr bool operator==(FixedPoint a, FixedPoint b)
+                { return a._v == b._v; }
+            friend constexpr bool operator!=(FixedPoint a, FixedPoint b)
+                { return a._v != b._v; }
+            friend constexpr bool operator<(FixedPoint a, FixedPoint b)
+                { return a._v < b._v; }
+            friend constexpr bool operator<=(FixedPoint a, FixedPoint b)
+                { return a._v <= b._v; }
+            friend constexpr bool operator>(FixedPoint a, FixedPoint b)
+                { return a._v > b._v; }
+            friend constexpr bool operator>=(FixedPoint a, FixedPoint b)
+                { return a._v >= b._v; }
+
+            friend constexpr FixedPoint abs(FixedPoint a)
+                { return a._v < 0 ? -a : a; }
+
+        private:
+            static constexpr int64_t _one()
+                { return int64_t(1) << FracBits; }
+
+            static constexpr Storage _from_floating(double x)
+            {
+                const double scaled = x * static_cast<double>(_one());
+                return scaled >= static_cast<double>(std::numeric_limits<Storage>::max()) ? std::numeric_limits<Storage>::max()
+                    : scaled <= static_cast<double>(std::numeric_limits<Storage>::min()) ? std::numeric_limits<Storage>::min()
+                    : static_cast<Storage>(scaled + (scaled >= 0 ? 0.5 : -0.5));
+            }
+
+            Storage _v;
+    };
+
+    /** Q15: 16-bit, range [-1:1). */
+    using Q15 = FixedPoint<int16_t, 15>;
+    /** Q31: 32-bit, range [-1:1). */
+    using Q31 = FixedPoint<int32_t, 31>;
+
+    /** Per-sample-type arithmetic properties.
+     * `compute_type` is the type processors use for coefficients and
+     * intermediate state that need more range than the sample format itself, e.g.
+     * biquad coefficients around 2, or one-pole coefficients in the hundreds. For
+     * floating-point samples it is the sample type itself; for fixed-point
+     * samples it is a format of twice the width with half of it integer
+     * headroom, e.g. Q15 computes in Q15.16 and Q31 in Q31.32.
+     * `parameter_type` is the type for control-rate values such as normalised
+     * frequencies and modulation depths, which are converted to `compute_type`
+     * once when set rather than on every sample.
+     */
+    template<class T>
+    struct SampleTraits
+    {
+        using compute_type = T;
+        using parameter_type = T;
+        static constexpr bool is_fixed_point = false;
+    };
+
+    template<class Storage, unsigned FracBits>
+    struct SampleTraits<FixedPoint<Storage, FracBits>>
+    {
+        using compute_type = FixedPoint<typename _fixed::Wide<Storage>::type, sizeof(Storage) * 8>;
+        using parameter_type = float;
+        static constexpr bool is_fixed_point = true;
+    };
+
+    /** 64-bit formats are already the widest, and compute in themselves. */
+    template<unsigned FracBits>
+    struct SampleTraits<FixedPoint<int64_t, FracBits>>
+    {
+        using compute_type = FixedPoint<int64_t, FracBits>;
+        using parameter_type = float;
+        static constexpr bool is_fixed_point = true;
+    };
+
+} // namespace idsp
+
+#endif
@@ -118,17 +118,36 @@ namespace idsp
 
     /** 2-point linear interpolation. */
     template<typename T, typename V,
-    typename std::enable_if<std::is_convertible<V, T>::value, bool>::type = true>
+    typename std::enable_if<std::is_convertible<V, T>::value && !SampleTraits<T>::is_fixed_point, bool>::type = true>
     constexpr T interpolate_2(V frac, T n, T n1) {
         return n + ((n1 - n) * frac);
     }
+    /** 2-point linear interpolation of fixed-point values. The difference
+     * between the points is taken in the wider compute type, so it cannot
+     * saturate. */
+    template<typename T, typename V,
+    typename std::enable_if<std::is_convertible<V, T>::value && SampleTraits<T>::is_fixed_point, bool>::type = true>
+    constexpr T interpolate_2(V frac, T n, T n1) {
+        using C = typename SampleTraits<T>::compute_type;
+        return T(C(n) + ((C(n1) - C(n)) * C(frac)));
+    }
 
     /** 4-point interpolation. */
     template<typename T, typename V,
-    typename std::enable_if<std::is_convertible<V, T>::value, bool>::type = true>
+    typename std::enable_if<std::is_convertible<V, T>::value && !SampleTraits<T>::is_fixed_point, bool>::type = true>
     constexpr T interpolate_4(V frac, T a, T b, T c, T d) {
         return b + frac * ((c - b) - T(0.1666667) * (T(1) - frac) * ((d - a - T(3)*(c - b)) * frac + (d + T(2)*a - T(3)*b)));
     }
+    /** 4-point interpolation of fixed-point values, computed in the wider
+     * compute type. */
+    template<typename T, typename V,
+    typename std::enable_if<std::is_convertible<V, T>::value && SampleTraits<T>::is_fixed_point, bool>::type = true>
+    constexpr T interpolate_4(V frac, T a, T b, T c, T d) {
+        using C = typename SampleTraits<T>::compute_type;
+        const C f {frac};
+        const C ca {a}, cb {b}, cc {c}, cd {d};
+        return T(cb + f * ((cc - cb) - C(0.1666667) * (C(1) - f) * ((cd - ca - C(3)*(cc - cb)) * f + (cd + C(2)*ca - C(3)*cb))));
+    }
 
     /** Interpolates an idsp::SampleBuffer using 4-point interpolation.
      * @param buf idsp::SampleBuffer to interpolate.
@@ -212,6 +231,16 @@ namespace idsp
         return rv;
     }
 
+    /** Returns the smallest power of two that is not less than $x$. */
+    template<typename T,
+    typename std::enable_if<std::is_unsigned<T>::value, bool>::type = true>
+    constexpr T next_power_of_two(T x) {
+        T rv = 1;
+        while (rv < x)
+            rv <<= 1;
+        return rv;
+    }
+
     /** Sine over argument function. */
     template<typename T,
     typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true>
@@ -257,6 +286,70 @@ namespace idsp
         return idsp::sin_fast(x);
     }
 
+    /** Sine of any @a x, accurate to float precision and usable in constant
+     * expressions, e.g. to generate lookup tables at compile time.
+     * Reduces @a x to [-pi/2, pi/2] and sums the Taylor series to x^15 in
+     * double precision, whose error there is below 7e-10.
+     */
+    template<typename T>
+    IDSP_CONSTEXPR_SINCE_CXX14 T sin_accurate(T x) {
+        const double turns = static_cast<double>(x) / (2 * M_PI);
+        const double nearest = static_cast<double>(static_cast<long long>(turns + (turns < 0 ? -0.5 : 0.5)));
+        double r = static_cast<double>(x) - nearest * 2 * M_PI;
+        if (r > M_PI / 2)
+            r = M_PI - r;
+        else if (r < -M_PI / 2)
+            r = -M_PI - r;
+        const double r2 = r * r;
+        double term = r;
+        double sum = r;
+        for (int n = 1; n <= 7; n++)
+        {
+            term *= -r2 / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return static_cast<T>(sum);
+    }
+
+    /** Cosine counterpart of @ref sin_accurate. */
+    template<typename T>
+    IDSP_CONSTEXPR_SINCE_CXX14 T cos_accurate(T x) {
+        return idsp::sin_accurate(static_cast<T>(static_cast<double>(x) + M_PI / 2));
+    }
+
+    /** Approximation of tan(pi * f) for bilinear-transform prewarping.
+     * Valid for 0 <= @a f < 0.5. Uses a [5/4] Padé approximant on
+     * 0 <= pi * f <= pi / 4 and tan(x) = 1 / tan(pi / 2 - x) above that.
+     * The relative error is below 1.4e-8, under float resolution.
+     */
+    template<typename T>
+    IDSP_CONSTEXPR_SINCE_CXX14 T tan_pi_fast(T f) {
+        const bool reflect = f > T(0.25);
+        const T x = T(M_PI) * (reflect ? T(0.5) - f : f);
+        const T x2 = x * x;
+        T num = x * (T(945) - x2 * (T(105) - x2));
+        T den = T(945) - x2 * (T(420) - T(15) * x2);
+        if (reflect)
+            std::swap(num, den);
+        return num / den;
+    }
+
+    /** Approximation of exp(x) for -pi <= @a x <= 0, e.g. the pole of a
+     * one-pole filter at exp(-2 pi f).
+     * Evaluates a 6th order Taylor series at x / 16 and squares it 4 times.
+     * The relative error is below 5e-8 over that range.
+     */
+    template<typename T>
+    IDSP_CONSTEXPR_SINCE_CXX14 T exp_fast(T x) {
+        const T y = x * T(0.0625);
+        T e = T(1) + y * (T(1) + y * (T(1.0 / 2) + y * (T(1.0 / 6) + y * (T(1.0 / 24) + y * (T(1.0 / 120) + y * T(1.0 / 720))))));
+        e *= e;
+        e *= e;
+        e *= e;
+        e *= e;
+        return e;
+    }
+
     /** Returns a cosine window. */
     template<typename T,
     typename std::enable_if<std::is_floating_point<T>::value, bool>::type = true>
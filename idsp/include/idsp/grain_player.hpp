@@ -7,86 +7,219 @@
 #include "idsp/filter.hpp"
 #include "idsp/modulation.hpp"
 #include "idsp/delay.hpp"
+#include "idsp/resampler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
 
 namespace idsp
 {
-    template<size_t S>
+    /**
+     * Grain windows, blended from four shared tables by a shape in [0, 1].
+     * A grain's shape is fixed for its lifetime, so it can resolve its window
+     * once with acquire_window(): the blend is written to one of @a Slots
+     * cached tables, shared by every grain of the same shape, and reading it
+     * costs one table read instead of two and a blend.
+     */
+    template<size_t S, size_t Slots = 8>
     class WindowBank
     {
         public:
-            WindowBank() :
-            cosine{LookupTable<Sample, S>([](Sample p) -> Sample {
-                return 0.5 - 0.5 * cosf(2.f * pi * p);
-            })},
-            triangle{LookupTable<Sample, S>([](Sample p) -> Sample {
-                if(p <= 0.5)
-                    return (p * 2.f);
-                else
-                    return (1.f - p) * 2.f;
-            })},
-            square{LookupTable<Sample, S>([](Sample p) -> Sample {
-                if(p < 0.005f)
-                    return 0.f;
-                else if(p < 0.1f)
-                    return p/0.1f;
-                else if (p < 0.9f)
-                    return 1.f;
-                else
-                    return 1.f - ((p - 0.9f)* 10.f);
-            })},
-            sawtooth{LookupTable<Sample, S>([](Sample p) -> Sample {
-                 if(p < 0.1f)
-                    return p/0.1f;
-                else
-                    return  1.f - ((p - 0.1)* 1.1f);
-            })}
-            {}
+            WindowBank()
+            {
+                // NaN matches no shape, so every slot starts empty
+                _shapes.fill(std::numeric_limits<float>::quiet_NaN());
+                _users.fill(0);
+            }
 
-            inline float get_cosine(float phase){return cosine.read_wrap(phase);}
+            inline float get_cosine(float phase){return cosine().read_wrap(phase);}
 
-            inline float get_triangle(float phase){return triangle.read_wrap(phase);}
+            inline float get_triangle(float phase){return triangle().read_wrap(phase);}
 
-            inline float get_square(float phase){return square.read_wrap(phase);}
+            inline float get_square(float phase){return square().read_wrap(phase);}
 
-            inline float get_sawtooth(float phase) {return sawtooth.read_wrap(phase);}
+            inline float get_sawtooth(float phase) {return sawtooth().read_wrap(phase);}
 
             float get_window(float phase, float shape)
             {
                 if(shape < 0.3f)
                 {
                     float blend = rescale(shape, 0.f, 0.3f, 0.f, 1.f);
-                    float sqr = square.read_wrap(phase);
-                    float saw = sawtooth.read_wrap(phase);
+                    float sqr = square().read_wrap(phase);
+                    float saw = sawtooth().read_wrap(phase);
                     return interpolate_2(blend, sqr, saw);
                 }
                 else if(shape < 0.6f)
                 {
                     float blend = rescale(shape, 0.3f, 0.6f, 0.f, 1.f);
-                    float saw = sawtooth.read_wrap(phase);
-                    float tri = triangle.read_wrap(phase);
+                    float saw = sawtooth().read_wrap(phase);
+                    float tri = triangle().read_wrap(phase);
                     return interpolate_2(blend, saw, tri);
                 }
                 else
                 {
                     float blend = rescale(shape, 0.6f, 1.f, 0.f, 1.f);
-                    float tri = triangle.read_wrap(phase);
-                    float cos = cosine.read_wrap(phase);
+                    float tri = triangle().read_wrap(phase);
+                    float cos = cosine().read_wrap(phase);
                     return interpolate_2(blend, tri, cos);
                 }
             }
 
+            /** Block form of get_window for one @a shape: output[i] is
+             * get_window(phases[i], shape), for phases in [0, 1]. The pair
+             * of tables and their blend are picked once for the block. */
+            void get_window(const float* phases, float shape, float* output, size_t num_samples)
+            {
+                const LookupTable<Sample, S>* a;
+                const LookupTable<Sample, S>* b;
+                const float blend = _tables(shape, a, b);
+                for(size_t i = 0; i < num_samples; i++)
+                {
+                    const float phase = _wrap(phases[i]);
+                    output[i] = interpolate_2(blend, a->read(phase), b->read(phase));
+                }
+            }
+
+            /** Resolves the window of @a shape to a blended table, shared
+             * with any grain already holding the same shape. Hand it back
+             * with release_window() when the grain ends.
+             * @return The table, or nullptr if every slot holds a shape that
+             * is still in use, in which case get_window() is the fallback. */
+            const Sample* acquire_window(float shape)
+            {
+                size_t free_slot = Slots;
+                for(size_t k = 0; k < Slots; k++)
+                {
+                    if(_shapes[k] == shape)
+                    {
+                        _users[k]++;
+                        return _cache[k].data();
+                    }
+                    if(_users[k] == 0 && free_slot == Slots) free_slot = k;
+                }
+                if(free_slot == Slots) return nullptr;
+
+                const LookupTable<Sample, S>* a;
+                const LookupTable<Sample, S>* b;
+                const float blend = _tables(shape, a, b);
+                auto& table = _cache[free_slot];
+                for(size_t i = 0; i < S; i++)
+                    table[i] = interpolate_2(blend, (*a)[i], (*b)[i]);
+                _shapes[free_slot] = shape;
+                _users[free_slot] = 1;
+                return table.data();
+            }
+
+            /** Hands back a table from acquire_window(). Null is ignored. The
+             * table stays cached for its shape until its slot is reused. */
+            void release_window(const Sample* table)
+            {
+                for(size_t k = 0; k < Slots; k++)
+                    if(_cache[k].data() == table) _users[k]--;
+            }
+
+            /** Reads a table from acquire_window() at @a phase, in [0, 1]. */
+            static float read_window(const Sample* table, float phase)
+            {
+                const float scaled = _wrap(phase) * static_cast<float>(S - 1);
+                // the phase is never negative, so the signed conversion,
+                // cheaper than the unsigned one, truncates the same way
+                const int index = static_cast<int>(scaled);
+                return interpolate_2(scaled - static_cast<float>(index), table[index], table[index + 1]);
+            }
+
+            /** Block form of read_window. */
+            static void read_window(const Sample* table, const float* phases, float* output, size_t num_samples)
+            {
+                for(size_t i = 0; i < num_samples; i++)
+                    output[i] = read_window(table, phases[i]);
+            }
+
         private:
-            LookupTable<Sample, S> cosine;
-            LookupTable<Sample, S> triangle;
-            LookupTable<Sample, S> square;
-            LookupTable<Sample, S> sawtooth;
+            // read_wrap without the floor, for phases in [0, 1]: 1 wraps to 0
+            static float _wrap(float phase) {return phase < 1.f ? phase : phase - 1.f;}
+
+            // The pair of tables get_window() blends for @a shape, and the blend
+            static float _tables(float shape, const LookupTable<Sample, S>*& a, const LookupTable<Sample, S>*& b)
+            {
+                if(shape < 0.3f)
+                {
+                    a = &square();
+                    b = &sawtooth();
+                    return rescale(shape, 0.f, 0.3f, 0.f, 1.f);
+                }
+                else if(shape < 0.6f)
+                {
+                    a = &sawtooth();
+                    b = &triangle();
+                    return rescale(shape, 0.3f, 0.6f, 0.f, 1.f);
+                }
+                a = &triangle();
+                b = &cosine();
+                return rescale(shape, 0.6f, 1.f, 0.f, 1.f);
+            }
+
+            static IDSP_CONSTEXPR_SINCE_CXX14 Sample _cosine_window(SampleParameter p)
+            {
+                return 0.5f - 0.5f * idsp::cos_accurate(2.f * pi * p);
+            }
+
+            static constexpr Sample _triangle_window(SampleParameter p)
+            {
+                return p <= 0.5f ? p * 2.f : (1.f - p) * 2.f;
+            }
+
+            static constexpr Sample _square_window(SampleParameter p)
+            {
+                return p < 0.005f ? 0.f
+                    : p < 0.1f ? p / 0.1f
+                    : p < 0.9f ? 1.f
+                    : 1.f - ((p - 0.9f) * 10.f);
+            }
+
+            static constexpr Sample _sawtooth_window(SampleParameter p)
+            {
+                return p < 0.1f ? p / 0.1f : 1.f - ((p - 0.1f) * 1.1f);
+            }
+
+            // The tables are constant-initialised, so they live in read-only
+            // memory and are shared by every bank of the same size
+            static const LookupTable<Sample, S>& cosine()
+            {
+                static constexpr LookupTable<Sample, S> table(_cosine_window);
+                return table;
+            }
+
+            static const LookupTable<Sample, S>& triangle()
+            {
+                static constexpr LookupTable<Sample, S> table(_triangle_window);
+                return table;
+            }
+
+            static const LookupTable<Sample, S>& square()
+            {
+                static constexpr LookupTable<Sample, S> table(_square_window);
+                return table;
+            }
+
+            static const LookupTable<Sample, S>& sawtooth()
+            {
+                static constexpr LookupTable<Sample, S> table(_sawtooth_window);
+                return table;
+            }
+
+            std::array<std::array<Sample, S>, Slots> _cache;
+            /** The shape blended into each slot. */
+            std::array<float, Slots> _shapes;
+            /** Grains holding each slot. */
+            std::array<size_t, Slots> _users;
     };
 
     class Grain
     {
         public:
-            using FilterType = typename OnepoleFilter::Type;
-
             static constexpr float min_pitch = 0.25f;
             static constexpr float max_pitch = 4.f;
 
@@ -107,15 +240,13 @@ namespace idsp
                 dying
             };
 
-            Grain():
-            dc_blocker{FilterType::Highpass}
-            {}
+            Grain() = default;
 
             Grain(float sample_rate)  :
             phase{0},
             state{idle},
             sample_rate{sample_rate},
-            dc_blocker{FilterType::Highpass, (50*(1.f/sample_rate))}
+            window{nullptr}
             {}
 
             void init(Parameters& paramaters, AudioRingBuffer& audio_buffer)
@@ -128,6 +259,15 @@ namespace idsp
                 start_index = start_index < 0 ? (start_index + audio_buffer.get_size()) : start_index;
                 phase = 0;
                 state = active;
+                window = nullptr;
+            }
+
+            /** As init(), and resolves the grain's window in @a windows, so
+             * each sample reads one table. Pair with kill(windows). */
+            void init(Parameters& paramaters, AudioRingBuffer& audio_buffer, WindowBank<128>& windows)
+            {
+                init(paramaters, audio_buffer);
+                window = windows.acquire_window(grain_parameters.window_shape);
             }
 
             void kill()
@@ -136,144 +276,274 @@ namespace idsp
                 phase = 0;
             }
 
-            void process(AudioRingBuffer& audio_buffer, WindowBank<128>& windows, Sample& out_left, Sample& out_right)
+            /** As kill(), and hands the grain's window back to @a windows. */
+            void kill(WindowBank<128>& windows)
             {
-                float envelope = windows.get_window((phase/grain_length), grain_parameters.window_shape);
+                windows.release_window(window);
+                window = nullptr;
+                kill();
+            }
+
+            /** @return The grain's next windowed sample, before DC blocking. */
+            Sample process(AudioRingBuffer& audio_buffer, WindowBank<128>& windows)
+            {
+                float envelope = window ? WindowBank<128>::read_window(window, (phase/grain_length))
+                                        : windows.get_window((phase/grain_length), grain_parameters.window_shape);
                 float read_position = static_cast<float>(start_index) + phase;
                 Sample out_sample = (audio_buffer.read_at_smooth_safe(read_position) * grain_parameters.volume * envelope);
 
                 phase += grain_parameters.pitch;
                 if(phase >= grain_length) this->state = dying;
 
-                out_left += dc_blocker.process(out_sample);
+                return out_sample;
+            }
 
-        //        if(grain_parameters.channel == 0) out_left += dc_blocker.process(out_sample);
-        //        else out_right += dc_blocker.process(out_sample);
+            /** Adds the grain's next @a num_samples windowed samples, before
+             * DC blocking, to @a output, stopping early if it finishes.
+             * Matches the sample processor sample for sample. */
+            void process(AudioRingBuffer& audio_buffer, WindowBank<128>& windows, Sample* output, size_t num_samples)
+            {
+                _process_block(windows, output, num_samples, [&](const float* positions, Sample* reads, size_t n) {
+                    audio_buffer.read_at_smooth_safe(positions, reads, n);
+                });
+            }
+
+            /** As the block process(), reading through @a interpolator, e.g. a
+             * SincInterpolator, at the level for the grain's pitch instead of
+             * 4-point, so pitching up is filtered rather than aliased. */
+            template<class Interpolator>
+            void process(AudioRingBuffer& audio_buffer, WindowBank<128>& windows, const Interpolator& interpolator, Sample* output, size_t num_samples)
+            {
+                const size_t level = Interpolator::select_level(grain_parameters.pitch);
+                _process_block(windows, output, num_samples, [&](const float* positions, Sample* reads, size_t n) {
+                    audio_buffer.read_at(interpolator, level, positions, reads, n);
+                });
             }
 
 
             inline GrainState get_state() {return state;}
 
         private:
+            static constexpr size_t _block_size = 64;
+
+            // Block processor around @a read(positions, reads, n)
+            template<class Read>
+            void _process_block(WindowBank<128>& windows, Sample* output, size_t num_samples, Read&& read)
+            {
+                std::array<float, _block_size> positions, envelopes;
+                std::array<Sample, _block_size> reads;
+                while(num_samples > 0 && state == active)
+                {
+                    const size_t count = min(num_samples, _block_size);
+                    // the phase accumulates one sample at a time, as it does
+                    // in the sample processor
+                    size_t n = 0;
+                    while(n < count && state == active)
+                    {
+                        envelopes[n] = phase/grain_length;
+                        positions[n] = static_cast<float>(start_index) + phase;
+                        n++;
+                        phase += grain_parameters.pitch;
+                        if(phase >= grain_length) this->state = dying;
+                    }
+                    if(window) WindowBank<128>::read_window(window, envelopes.data(), envelopes.data(), n);
+                    else windows.get_window(envelopes.data(), grain_parameters.window_shape, envelopes.data(), n);
+                    read(positions.data(), reads.data(), n);
+                    for(size_t i = 0; i < n; i++)
+                        output[i] += reads[i] * grain_parameters.volume * envelopes[i];
+                    output += n;
+                    num_samples -= n;
+                }
+            }
+
             Parameters grain_parameters;
             float grain_length;
             int start_index;
             float phase;
             GrainState state;
             float sample_rate;
-            idsp::OnepoleFilter dc_blocker;
+            /** The resolved window, or null to blend it every sample. */
+            const Sample* window;
     };
 
+    /**
+     * Granular player over an audio ring buffer.
+     * Active grains are kept in a compact list of indices and idle ones on a
+     * free list, so triggering a grain is O(1) and each output sample costs
+     * O(active grains) whatever @a MaxGrains is. Grains that finish during a
+     * block are reclaimed together at the end of it.
+     * Blocks are rendered grain by grain: each active grain adds its whole
+     * block into an accumulator in one loop, which keeps its state in
+     * registers and gives the same sums, in the same order, as visiting
+     * every grain for each sample. Ranges of the active list can be rendered
+     * separately with render_grains(), e.g. on several threads.
+     * The DC blockers are linear and identical, so one on the grains' sum
+     * stands in for one per grain.
+     * Grains read the buffer with 4-point interpolation by default. With
+     * @a Taps of 4, 8, 16 or 32 they read through a SincInterpolator of that
+     * tier at the level for their pitch, so grains pitched up don't alias.
+     */
+    template<size_t MaxGrains = 16, size_t Taps = 0>
     class GrainPlayer
     {
         public:
-            GrainPlayer(AudioRingBuffer& buff) :
-            audio_buffer{buff},
-            buffer_length_samples{audio_buffer.get_size()},
-            max_grain_length{(buffer_length_samples-3) / static_cast<int>(Grain::max_pitch)},
-            active_grains{0},
-            prev_active_grains{0}
+            static constexpr size_t max_grains = MaxGrains;
+            /** Points of the sinc reads at level 0, or 0 for 4-point reads. */
+            static constexpr size_t taps = Taps;
+            using Interpolator = SincInterpolator<Taps>;
+
+            GrainPlayer(AudioRingBuffer& buff, float sample_rate = 48000.f) :
+            GrainPlayer(buff, nullptr, sample_rate)
+            {
+                static_assert(Taps == 0, "A sinc GrainPlayer needs its SincInterpolator.");
+            }
+
+            /** Reads through @a sinc, which can be shared and must outlive
+             * the player. */
+            template<size_t T = Taps, typename std::enable_if<T != 0, bool>::type = true>
+            GrainPlayer(AudioRingBuffer& buff, const SincInterpolator<T>& sinc, float sample_rate = 48000.f) :
+            GrainPlayer(buff, &sinc, sample_rate)
             {}
 
             void process(BufferInterface& output_left, BufferInterface& output_right)
             {
-                const size_t block_size = output_left.size();
+                _process(output_left, output_right, output_left.size(), [this](Sample* sum, size_t num_samples) {
+                    render_grains(0, active_grains, sum, num_samples);
+                });
+            }
 
-                for(size_t i = 0; i < block_size; i++)
-                {
-                    Sample out_left{0};
-                    Sample out_right{0};
-                    for(size_t g = 0; g < max_grains; g++)
-                    {
-                        if(grains[g].get_state() == Grain::active)
-                        {
-                            grains[g].process(audio_buffer, windows, out_left, out_right);
-                        }
-                    }
+            template<size_t N>
+            void process_for(BufferInterface& output_left, BufferInterface& output_right)
+            {
+                _process(output_left, output_right, N, [this](Sample* sum, size_t num_samples) {
+                    render_grains(0, active_grains, sum, num_samples);
+                });
+            }
 
-                    output_left[i] =  idsp::tanh_fast(out_left);
-                    output_right[i] = idsp::tanh_fast(out_right);
+            /** Block processor that leaves summing the grains to
+             * @a render(sum, num_samples), which must add every active grain
+             * to the zeroed @a sum, e.g. with render_grains() on several
+             * threads. */
+            template<class Render>
+            void process(BufferInterface& output_left, BufferInterface& output_right, Render&& render)
+            {
+                _process(output_left, output_right, output_left.size(), render);
+            }
+
+            /** Adds active grains @a first to @a last, exclusive and in
+             * trigger order, to @a sum over the next @a num_samples. A grain
+             * that finished earlier in the block stays silent until it is
+             * reclaimed. Separate ranges share no state that rendering
+             * changes, so they can render concurrently. */
+            void render_grains(size_t first, size_t last, Sample* sum, size_t num_samples)
+            {
+                for(size_t g = first; g < last; g++)
+                {
+                    if constexpr (Taps == 0)
+                        grains[active_list[g]].process(audio_buffer, windows, sum, num_samples);
+                    else
+                        grains[active_list[g]].process(audio_buffer, windows, *interpolator, sum, num_samples);
                 }
+            }
 
-                prev_active_grains = active_grains;
+            /** Starts a grain if one is free, otherwise does nothing. */
+            void trigger_grain()
+            {
+                if(free_grains == 0) return;
 
+                const size_t index = free_list[--free_grains];
+                player_paramaters.volume = 1.f;
+                player_paramaters.channel = stochastic.coin_toss(50);
+
+                grains[index].init(player_paramaters, audio_buffer, windows);
+                active_list[active_grains++] = index;
+            }
+
+            inline void set_position(float f) {player_paramaters.position = static_cast<int>(rescale(f, 0.f, 1.f, 1.f, static_cast<float>(buffer_length_samples-max_grain_length)));}
+
+            inline void set_pitch(float f) {player_paramaters.pitch = clamp(f, Grain::min_pitch, Grain::max_pitch);}
+
+            inline void set_length(float f) {player_paramaters.length_pot = f;}
+
+            inline void set_window_shape(float f) {player_paramaters.window_shape = f;}
+
+            /** @return The number of grains playing. */
+            inline size_t get_active_grains() const {return active_grains;}
+
+        private:
+            GrainPlayer(AudioRingBuffer& buff, const Interpolator* sinc, float sample_rate) :
+            audio_buffer{buff},
+            interpolator{sinc},
+            buffer_length_samples{audio_buffer.get_size()},
+            max_grain_length{(buffer_length_samples-3) / static_cast<int>(Grain::max_pitch)},
+            active_grains{0},
+            prev_active_grains{0},
+            free_grains{max_grains}
+            {
                 for(size_t i = 0; i < max_grains; i++)
                 {
-                    if(grains[i].get_state() == Grain::dying)
-                    {
-                        grains[i].kill();
-                        active_grains--;
-                    }
+                    grains[i] = Grain(sample_rate);
+                    // taken from the back, so the first trigger gets grain 0
+                    free_list[i] = max_grains - 1 - i;
                 }
             }
 
-            template<size_t N>
-            void process_for(BufferInterface& output_left, BufferInterface& output_right)
+            // The grains are summed in the left output, then DC blocked and
+            // saturated in place
+            template<class Render>
+            void _process(BufferInterface& output_left, BufferInterface& output_right, size_t block_size, Render&& render)
             {
-                for(size_t i = 0; i < N; i++)
+                BufferInterface sum(output_left.data(), block_size);
+                std::fill(sum.begin(), sum.end(), Sample(0));
+                render(sum.data(), block_size);
+                dc_blocker.process(sum, sum);
+
+                for(size_t i = 0; i < block_size; i++)
                 {
-                    Sample out_left{0};
                     Sample out_right{0};
-                    for(size_t g = 0; g < max_grains; g++)
-                    {
-                        if(grains[g].get_state() == Grain::active)
-                        {
-                            grains[g].process(audio_buffer, windows, out_left, out_right);
-                        }
-                    }
 
-                    output_left[i] =  idsp::tanh_fast(out_left);
+                    output_left[i] =  idsp::tanh_fast(output_left[i]);
                     output_right[i] = idsp::tanh_fast(out_right);
                 }
 
                 prev_active_grains = active_grains;
-
-                for(size_t i = 0; i < max_grains; i++)
-                {
-                    if(grains[i].get_state() == Grain::dying)
-                    {
-                        grains[i].kill();
-                        active_grains--;
-                    }
-                }
+                _reclaim();
             }
 
-            void trigger_grain()
+            // Moves finished grains to the free list, keeping the active list
+            // compact and in trigger order
+            void _reclaim()
             {
-                bool grain_triggered = false;
-                for(size_t i = 0; i < max_grains; i++)
+                size_t kept = 0;
+                for(size_t g = 0; g < active_grains; g++)
                 {
-                    if(grains[i].get_state() == Grain::idle)
+                    const size_t index = active_list[g];
+                    if(grains[index].get_state() == Grain::dying)
                     {
-                        active_grains++;
-                        player_paramaters.volume = 1.f;
-                        player_paramaters.channel = stochastic.coin_toss(50);
-
-                        grains[i].init(player_paramaters, audio_buffer);
-                        grain_triggered = true;
+                        grains[index].kill(windows);
+                        free_list[free_grains++] = index;
                     }
-                    if(grain_triggered == true) break;
+                    else active_list[kept++] = index;
                 }
+                active_grains = kept;
             }
 
-            inline void set_position(float f) {player_paramaters.position = static_cast<int>(rescale(f, 0.f, 1.f, 1.f, static_cast<float>(buffer_length_samples-max_grain_length)));}
-
-            inline void set_pitch(float f) {player_paramaters.pitch = clamp(f, Grain::min_pitch, Grain::max_pitch);}
-
-            inline void set_length(float f) {player_paramaters.length_pot = f;}
-
-            inline void set_window_shape(float f) {player_paramaters.window_shape = f;}
-
-        private:
             //Granular Constants
             AudioRingBuffer& audio_buffer;
+            /** The sinc tier's tables, or null for 4-point reads. */
+            const Interpolator* interpolator;
             size_t buffer_length_samples;
             size_t max_grain_length;
-            static constexpr size_t max_grains = 16;
             std::array<Grain, max_grains> grains;
+            /** Indices of the playing grains, in trigger order. */
+            std::array<size_t, max_grains> active_list;
+            /** Indices of the idle grains, used as a stack. */
+            std::array<size_t, max_grains> free_list;
+            OnepoleFilter dc_blocker{OnepoleFilter::Type::Highpass};
             Grain::Parameters player_paramaters;
-            unsigned active_grains;
-            unsigned prev_active_grains;
+            size_t active_grains;
+            size_t prev_active_grains;
+            size_t free_grains;
             WindowBank<128> windows;
             float feedback;
             Stochastic stochastic;
@@ -0,0 +1,182 @@
+#ifndef IDSP_GRAIN_PLAYER_PARALLEL_H
+#define IDSP_GRAIN_PLAYER_PARALLEL_H
+
+// Host builds only: needs std::thread, which the embedded targets don't have.
+
+#include "idsp/grain_player.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace idsp
+{
+    /**
+     * Renders a GrainPlayer's active grains on a fixed pool of threads.
+     * Pass it as the render argument of GrainPlayer::process().
+     * The active list is cut into jobs of @a grains_per_job grains, each
+     * summed into its own accumulator, and the accumulators are added in job
+     * order once all are done. The sums never depend on which thread took a
+     * job, so the output is the same for any thread count. It matches the
+     * single-threaded player up to rounding, since grains are summed per job
+     * first.
+     * The audio thread doesn't wait for workers: jobs are claimed with a
+     * compare and swap on one counter, and the audio thread claims them too,
+     * so the block finishes even if no worker wakes. It only spins on jobs a
+     * worker has already started. Idle workers spin for a while, then park
+     * until the next block; to wake them, the audio thread takes the park
+     * lock, which a worker only holds to check for a block and go to sleep.
+     */
+    template<class Player>
+    class ParallelGrainRenderer
+    {
+        public:
+            static constexpr size_t grains_per_job = 4;
+
+            /** @param num_threads Threads rendering, counting the audio
+             * thread, so 1 starts no workers. */
+            ParallelGrainRenderer(Player& player, size_t num_threads) :
+            _player{player},
+            _sums((Player::max_grains + grains_per_job - 1) / grains_per_job),
+            _ticket{0},
+            _done{0},
+            _parked{0},
+            _stop{false}
+            {
+                for(size_t t = 1; t < max<size_t>(num_threads, 1); t++)
+                    _workers.emplace_back([this]() { _work(); });
+            }
+
+            ParallelGrainRenderer(const ParallelGrainRenderer&) = delete;
+            ParallelGrainRenderer& operator=(const ParallelGrainRenderer&) = delete;
+
+            ~ParallelGrainRenderer()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_park_mutex);
+                    _stop.store(true);
+                }
+                _wake.notify_all();
+                for(auto& worker : _workers)
+                    worker.join();
+            }
+
+            /** Adds every active grain to the zeroed @a sum. */
+            void operator()(Sample* sum, size_t num_samples)
+            {
+                for(size_t start = 0; start < num_samples; start += _block_size)
+                    _render(sum + start, min(_block_size, num_samples - start));
+            }
+
+            inline size_t get_num_threads() const {return _workers.size() + 1;}
+
+        private:
+            static constexpr size_t _block_size = 256;
+            static constexpr size_t _spin_count = 20000;
+
+            // The ticket holds the block's generation, its number of jobs and
+            // the next job to claim. A claim checks only the ticket, so a
+            // worker still holding an old ticket can't claim a job of a newer
+            // block, nor read its parameters before the claim succeeds.
+            static constexpr uint64_t _job_bits = 16;
+            static constexpr uint64_t _job_mask = (uint64_t(1) << _job_bits) - 1;
+            static_assert((Player::max_grains + grains_per_job - 1) / grains_per_job <= _job_mask, "Too many jobs for the ticket");
+
+            static inline uint64_t _generation(uint64_t ticket) {return ticket >> (2 * _job_bits);}
+            static inline uint64_t _jobs(uint64_t ticket) {return (ticket >> _job_bits) & _job_mask;}
+            static inline uint64_t _next_job(uint64_t ticket) {return ticket & _job_mask;}
+
+            void _render(Sample* sum, size_t num_samples)
+            {
+                const size_t num_grains = _player.get_active_grains();
+                const size_t num_jobs = (num_grains + grains_per_job - 1) / grains_per_job;
+                _num_grains = num_grains;
+                _num_samples = num_samples;
+                _done.store(0, std::memory_order_relaxed);
+                const uint64_t generation = _generation(_ticket.load(std::memory_order_relaxed)) + 1;
+                // Sequentially consistent, with the parking worker's count and
+                // check, so either it sees the ticket or this sees it parked.
+                // Taking the lock then waits until it is asleep to be woken
+                _ticket.store((generation << (2 * _job_bits)) | (uint64_t(num_jobs) << _job_bits), std::memory_order_seq_cst);
+                if(_parked.load(std::memory_order_seq_cst) > 0)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(_park_mutex);
+                    }
+                    _wake.notify_all();
+                }
+
+                _run_jobs(generation);
+                while(_done.load(std::memory_order_acquire) < num_jobs)
+                    std::this_thread::yield();
+
+                for(size_t j = 0; j < num_jobs; j++)
+                    for(size_t i = 0; i < num_samples; i++)
+                        sum[i] += _sums[j][i];
+            }
+
+            // Claims and renders jobs of @a generation until there are none left
+            void _run_jobs(uint64_t generation)
+            {
+                uint64_t ticket = _ticket.load(std::memory_order_acquire);
+                while(_generation(ticket) == generation && _next_job(ticket) < _jobs(ticket))
+                {
+                    if(!_ticket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                        continue;
+                    const size_t job = static_cast<size_t>(_next_job(ticket));
+                    const size_t first = job * grains_per_job;
+                    auto& job_sum = _sums[job];
+                    std::fill(job_sum.begin(), job_sum.begin() + _num_samples, Sample(0));
+                    _player.render_grains(first, min(first + grains_per_job, _num_grains), job_sum.data(), _num_samples);
+                    _done.fetch_add(1, std::memory_order_release);
+                    ticket = _ticket.load(std::memory_order_acquire);
+                }
+            }
+
+            void _work()
+            {
+                uint64_t seen = 0;
+                while(!_stop.load(std::memory_order_acquire))
+                {
+                    // spin for a new block, then park until one is published
+                    uint64_t ticket = _ticket.load(std::memory_order_acquire);
+                    for(size_t i = 0; i < _spin_count && _generation(ticket) == seen; i++)
+                        ticket = _ticket.load(std::memory_order_acquire);
+                    if(_generation(ticket) == seen)
+                    {
+                        std::unique_lock<std::mutex> lock(_park_mutex);
+                        _parked.fetch_add(1, std::memory_order_seq_cst);
+                        _wake.wait(lock, [&]() {
+                            return _stop.load() || _generation(_ticket.load(std::memory_order_seq_cst)) != seen;
+                        });
+                        _parked.fetch_sub(1, std::memory_order_acq_rel);
+                        continue;
+                    }
+                    seen = _generation(ticket);
+                    _run_jobs(seen);
+                }
+            }
+
+            Player& _player;
+            /** One accumulator per job. */
+            std::vector<std::array<Sample, _block_size>> _sums;
+            std::vector<std::thread> _workers;
+
+            // The current block, written before its ticket is published
+            size_t _num_grains;
+            size_t _num_samples;
+
+            std::atomic<uint64_t> _ticket;
+            std::atomic<size_t> _done;
+            std::atomic<size_t> _parked;
+            std::atomic<bool> _stop;
+            std::mutex _park_mutex;
+            std::condition_variable _wake;
+    };
+
+} // namespace idsp
+#endif
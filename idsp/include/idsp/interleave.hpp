@@ -0,0 +1,158 @@
+#ifndef IDSP_INTERLEAVE_H
+#define IDSP_INTERLEAVE_H
+
+#include "idsp/buffer_interface.hpp"
+#include "idsp/functions.hpp"
+#include "idsp/std_helpers.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace idsp
+{
+    /** Packed little-endian 24-bit signed integer, as delivered by 24-bit
+     * I2S/USB audio streams. */
+    struct PackedInt24
+    {
+        uint8_t bytes[3];
+    };
+
+    /** Sample format conversion traits.
+     * Specialisations provide `to_sample` and `from_sample` for converting a
+     * single value of an external audio format to and from `Sample`. Integer
+     * formats are scaled such that full scale maps to [-1:1), and are clamped
+     * (not wrapped) on conversion back.
+     */
+    template<class T>
+    struct SampleFormat;
+
+    template<>
+    struct SampleFormat<int16_t>
+    {
+        static constexpr Sample scale {Sample(1) / Sample(32768)};
+        static constexpr Sample max_in {Sample(32767) * scale};
+
+        static constexpr Sample to_sample(int16_t x)
+            { return static_cast<Sample>(x) * scale; }
+
+        static constexpr int16_t from_sample(Sample x)
+        {
+            return static_cast<int16_t>(idsp::clamp(x, Sample(-1), max_in) * Sample(32768));
+        }
+    };
+
+    template<>
+    struct SampleFormat<PackedInt24>
+    {
+        static constexpr Sample scale {Sample(1) / Sample(8388608)};
+        static constexpr Sample max_in {Sample(8388607) * scale};
+
+        static constexpr Sample to_sample(PackedInt24 x)
+        {
+            // Shift into the top of a 32-bit word and back to sign-extend
+            const int32_t v = static_cast<int32_t>(
+                (static_cast<uint32_t>(x.bytes[0]) << 8)
+                | (static_cast<uint32_t>(x.bytes[1]) << 16)
+                | (static_cast<uint32_t>(x.bytes[2]) << 24)) >> 8;
+            return static_cast<Sample>(v) * scale;
+        }
+
+        static constexpr PackedInt24 from_sample(Sample x)
+        {
+            const int32_t v = static_cast<int32_t>(idsp::clamp(x, Sample(-1), max_in) * Sample(8388608));
+            return PackedInt24{{
+                static_cast<uint8_t>(v),
+                static_cast<uint8_t>(v >> 8),
+                static_cast<uint8_t>(v >> 16)
+            }};
+        }
+    };
+
+    template<>
+    struct SampleFormat<int32_t>
+    {
+        static constexpr Sample scale {Sample(1) / Sample(2147483648.0)};
+        /** Largest `Sample` below 1 that still converts within int32 range. */
+        static constexpr Sample max_in {Sample(2147483520.0) * scale};
+
+        static constexpr Sample to_sample(int32_t x)
+            { return static_cast<Sample>(x) * scale; }
+
+        static constexpr int32_t from_sample(Sample x)
+        {
+            return static_cast<int32_t>(idsp::clamp(x, Sample(-1), max_in) * Sample(2147483648.0));
+        }
+    };
+
+    template<>
+    struct SampleFormat<float>
+    {
+        static constexpr Sample to_sample(float x)
+            { return static_cast<Sample>(x); }
+
+        static constexpr float from_sample(Sample x)
+            { return static_cast<float>(x); }
+    };
+
+    /** Deinterleaves @a num_frames frames of @a Nc channel audio in format @a T
+     * into the planar @a output, converting to `Sample` in the same pass.
+     * Each channel is converted in its own pass with a compile-time stride,
+     * which lets the compiler use structured/strided vector loads for the
+     * common 2, 4 and 8 channel cases.
+     * @note @a output must have at least @a Nc channels of at least
+     * @a num_frames samples.
+     */
+    template<size_t Nc, class T>
+    IDSP_CONSTEXPR_SINCE_CXX14
+    void deinterleave(const T* input, PolyBufferInterface& output, size_t num_frames)
+    {
+        static_assert(Nc > 0, "Cannot deinterleave 0 channels.");
+
+        for (size_t c = 0; c < Nc; c++)
+        {
+            const T* __restrict in = input + c;
+            Sample* __restrict out = output[c].data();
+            for (size_t i = 0; i < num_frames; i++)
+                out[i] = SampleFormat<T>::to_sample(in[i * Nc]);
+        }
+    }
+
+    /** Deinterleaves one block of @a N frames. See @ref deinterleave. */
+    template<size_t Nc, size_t N, class T>
+    IDSP_CONSTEXPR_SINCE_CXX14
+    void deinterleave_for(const T* input, PolyBufferInterface& output)
+    {
+        idsp::deinterleave<Nc>(input, output, N);
+    }
+
+    /** Interleaves @a num_frames frames of the first @a Nc channels of the
+     * planar @a input into @a output, converting from `Sample` to format @a T
+     * in the same pass.
+     * @note @a output must have room for @a Nc * @a num_frames values.
+     */
+    template<size_t Nc, class T>
+    IDSP_CONSTEXPR_SINCE_CXX14
+    void interleave(const PolyBufferInterface& input, T* output, size_t num_frames)
+    {
+        static_assert(Nc > 0, "Cannot interleave 0 channels.");
+
+        for (size_t c = 0; c < Nc; c++)
+        {
+            const Sample* __restrict in = input[c].data();
+            T* __restrict out = output + c;
+            for (size_t i = 0; i < num_frames; i++)
+                out[i * Nc] = SampleFormat<T>::from_sample(in[i]);
+        }
+    }
+
+    /** Interleaves one block of @a N frames. See @ref interleave. */
+    template<size_t Nc, size_t N, class T>
+    IDSP_CONSTEXPR_SINCE_CXX14
+    void interleave_for(const PolyBufferInterface& input, T* output)
+    {
+        idsp::interleave<Nc>(input, output, N);
+    }
+
+} // namespace idsp
+
+#endif
@@ -5,17 +5,27 @@
 #include "idsp/std_helpers.hpp"
 
 #include <array>
+#include <cmath>
+#include <vector>
 
 namespace idsp
 {
 
-/** Class for generating, storing and using non-modifyable lookup tables. */
+/** Class for generating, storing and using non-modifyable lookup tables.
+ * Generation is constexpr, so a table built from a constexpr generator can
+ * be a `static constexpr` object, which sits in flash on the RP2040
+ * instead of costing RAM and startup time.
+ */
 template<class T, size_t S>
 class LookupTable
 {
     static_assert(S > 0, "Cannot create lookup table of size 0.");
 
-    static T _generator_wrapper(T v, T (*gen)(T))
+    /** Generator argument type; always floating-point, even for fixed-point
+     * tables. */
+    using Argument = typename SampleTraits<T>::parameter_type;
+
+    static constexpr T _generator_wrapper(Argument v, T (*gen)(Argument))
     {
         return gen(v);
     }
@@ -27,11 +37,13 @@ class LookupTable
          * generator function.
          */
         template<class A>
-        LookupTable(T (*generator)(T, A*), A* data)
+        IDSP_CONSTEXPR_SINCE_CXX14
+        LookupTable(T (*generator)(Argument, A*), A* data):
+        _table{}
         {
             for (size_t i = 0; i < S; i++)
             {
-                const T arg = static_cast<T>(i) / static_cast<T>(S - 1);
+                const Argument arg = static_cast<Argument>(i) / static_cast<Argument>(S - 1);
                 const T value = generator(arg, data);
                 this->_table[i] = value;
             }
@@ -40,7 +52,8 @@ class LookupTable
         /** Generates the lookup table by calling the `generator` function with
          * arguments 0 to 1 inclusive, incrementing linearly.
          */
-        LookupTable(T (*generator)(T)):
+        IDSP_CONSTEXPR_SINCE_CXX14
+        LookupTable(T (*generator)(Argument)):
         LookupTable(_generator_wrapper, generator)
         {}
 
@@ -102,13 +115,13 @@ class LookupTable
         }
 
         /** Element access. */
-        IDSP_CONSTEXPR_SINCE_CXX14 Sample& operator[](size_t i)
+        IDSP_CONSTEXPR_SINCE_CXX14 T& operator[](size_t i)
             { return this->_table[i]; }
-        constexpr const Sample& operator[](size_t i) const
+        constexpr const T& operator[](size_t i) const
             { return this->_table[i]; }
 
         /** @returns A const reference to the underlying container. */
-        const std::array<T, S>& table() const
+        constexpr const std::array<T, S>& table() const
         {
             return this->_table;
         }
@@ -117,6 +130,139 @@ class LookupTable
         std::array<T, S> _table;
 };
 
+/** A single-cycle wavetable with @a Levels band-limited copies, one per
+ * octave, for aliasing-free oscillators at audio rates.
+ * Level 0 is the source table itself. Level k keeps the lowest
+ * harmonics(k) = (Size - 1) / 2 >> k harmonics of the source's spectrum,
+ * computed once at construction with a DFT over one period of the source.
+ * That costs about 2 * (Size - 1) * harmonics(1) multiply-adds, so on
+ * soft-float targets prefer small tables or build them before audio starts.
+ * Readers pick a level with select_level() whenever their rate changes.
+ * Tables follow @ref LookupTable's layout: Size - 1 samples per period, and
+ * the last sample repeats the first.
+ */
+template<size_t Size, size_t Levels = 1>
+class MipmappedWavetable
+{
+    static_assert(Size > 2, "MipmappedWavetable needs at least 3 samples.");
+    static_assert(Levels > 0, "MipmappedWavetable needs at least one level.");
+    static_assert((((Size - 1) / 2) >> (Levels - 1)) > 0, "Too many levels for the table size, the last would be empty.");
+
+    /** Argument type of the band-limiting maths. */
+    using Argument = typename SampleTraits<Sample>::parameter_type;
+
+    public:
+        using Wavetable = LookupTable<Sample, Size>;
+
+        /** Samples per period. */
+        static constexpr size_t period = Size - 1;
+
+        /** Copies @a table into level 0 and builds the other levels from
+         * it. Constexpr with a single level. */
+        IDSP_CONSTEXPR_SINCE_CXX14
+        explicit MipmappedWavetable(const Wavetable& table):
+        _levels{}
+        {
+            this->_levels[0] = table.table();
+            if (Levels > 1)
+                this->_bandlimit();
+        }
+
+        /** @returns The number of harmonics kept in @a level. */
+        static constexpr size_t harmonics(size_t level)
+        {
+            return (period / 2) >> level;
+        }
+
+        /** @returns The lowest level whose harmonics all stay below Nyquist
+         * when read at @a rate cycles per sample, or the last level.
+         */
+        IDSP_CONSTEXPR_SINCE_CXX14
+        static size_t select_level(float rate)
+        {
+            const float magnitude = rate < 0.f ? -rate : rate;
+            size_t level = 0;
+            while (level + 1 < Levels && static_cast<float>(harmonics(level)) * magnitude > 0.5f)
+                level++;
+            return level;
+        }
+
+        /** Reads @a level given a normalised index, [0:1], with the same
+         * linear interpolation as @ref LookupTable::read(). */
+        template<class F,
+        typename std::enable_if<std::is_floating_point<F>::value, bool>::type = true>
+        Sample read(size_t level, F index) const
+        {
+            const F scaled = index * static_cast<F>(period);
+            const size_t ind = static_cast<size_t>(scaled);
+            const F frac = scaled - static_cast<F>(ind);
+            return idsp::interpolate_2(frac, this->_levels[level][ind], this->_levels[level][ind + 1]);
+        }
+
+        /** @returns A const reference to the samples of @a level. */
+        constexpr const std::array<Sample, Size>& table(size_t level) const
+        {
+            return this->_levels[level];
+        }
+
+    private:
+        void _bandlimit()
+        {
+            // One period of cos and sin, indexed by (harmonic * n) mod period
+            std::vector<Argument> cos_table(period), sin_table(period);
+            for (size_t n = 0; n < period; n++)
+            {
+                const Argument phase = Argument(twopi) * static_cast<Argument>(n) / static_cast<Argument>(period);
+                cos_table[n] = std::cos(phase);
+                sin_table[n] = std::sin(phase);
+            }
+
+            // Spectrum of the source up to the harmonics of level 1
+            const size_t num_harmonics = harmonics(1);
+            std::vector<Argument> re(num_harmonics + 1, Argument(0)), im(num_harmonics + 1, Argument(0));
+            for (size_t h = 0; h <= num_harmonics; h++)
+            {
+                size_t k = 0;
+                for (size_t n = 0; n < period; n++)
+                {
+                    const Argument x = static_cast<Argument>(this->_levels[0][n]);
+                    re[h] += x * cos_table[k];
+                    im[h] -= x * sin_table[k];
+                    k += h;
+                    k = k >= period ? k - period : k;
+                }
+                re[h] /= static_cast<Argument>(period);
+                im[h] /= static_cast<Argument>(period);
+            }
+
+            // Resynthesise from the coarsest level up, each level adding its
+            // extra octave of harmonics to the one above it
+            std::vector<Argument> sum(period, re[0]);
+            size_t synthesised = 0;
+            for (size_t level = Levels - 1; level > 0; level--)
+            {
+                for (size_t n = 0; n < period; n++)
+                {
+                    size_t k = (synthesised * n) % period;
+                    for (size_t h = synthesised + 1; h <= harmonics(level); h++)
+                    {
+                        k += n;
+                        k = k >= period ? k - period : k;
+                        sum[n] += Argument(2) * (re[h] * cos_table[k] - im[h] * sin_table[k]);
+                    }
+                }
+                synthesised = harmonics(level);
+
+                auto& table = this->_levels[level];
+                for (size_t n = 0; n < period; n++)
+                    table[n] = Sample(sum[n]);
+                table[period] = table[0];
+            }
+        }
+
+        std::array<std::array<Sample, Size>, Levels> _levels;
+};
+
 } // namespace idsp
 
 #endif
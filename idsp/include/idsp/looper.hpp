@@ -2,9 +2,13 @@
 #define IDSP_LOOPER_H
 
 #include "idsp/buffer_interface.hpp"
+#include "idsp/functions.hpp"
 #include "idsp/lookup.hpp"
 #include "idsp/std_helpers.hpp"
 
+#include <array>
+#include <cstddef>
+
 #ifndef Sample
     #warning `Sample` not defined; defaulting to `float`
     #define Sample float
@@ -69,20 +73,17 @@ namespace idsp
                 {
                     this->_ind += s;
                 }
+                /** Moves the position by @a s, which may span many samples,
+                 * e.g. a whole block. */
                 IDSP_CONSTEXPR_SINCE_CXX14
                 void process(FractionT s)
                 {
                     this->_frac += s;
-                    while (this->_frac >= FractionT(1))
-                    {
-                        this->_ind++;
-                        this->_frac -= FractionT(1);
-                    }
-                    while (this->_frac < FractionT(0))
-                    {
-                        this->_ind--;
-                        this->_frac += FractionT(1);
-                    }
+                    IndexT whole = static_cast<IndexT>(this->_frac);
+                    if (static_cast<FractionT>(whole) > this->_frac)
+                        whole--;
+                    this->_ind += whole;
+                    this->_frac -= static_cast<FractionT>(whole);
                 }
 
                 constexpr IndexT index() const
@@ -134,7 +135,7 @@ namespace idsp
                 void set_step_multiplier(FractionT mult, FractionT pol);
 
                 /** Moves the Fade's position by the given amount, multiplied by the
-                 * last value given to @ref setStep. */
+                 * last values given to @ref set_step_multiplier. */
                 void process(FractionT step);
 
                 /** @return the current step size. */
@@ -208,8 +209,28 @@ namespace idsp
 
         /** Size of the crossfade table. */
         static constexpr size_t xfade_table_size = 256;
-        /** Crossfade table. */
-        extern const idsp::LookupTable<Sample, xfade_table_size> xfade_table;
+
+        /** Last index of the crossfade table, where a fade in ends. */
+        static constexpr IndexT xfade_table_end = static_cast<IndexT>(xfade_table_size - 1);
+
+        /** Length in samples of the short fade used by @ref Tap::kill. */
+        static constexpr size_t kill_fade_length = 64;
+
+        /** Raised-cosine fade in, 0 to 1. It mirrors about its midpoint, so a
+         * fade in and a fade out at the same progress always sum to 1. */
+        static IDSP_CONSTEXPR_SINCE_CXX14 Sample _xfade_curve(SampleParameter p)
+        {
+            return Sample(0.5f - 0.5f * idsp::cos_accurate(pi * p));
+        }
+
+        /** Crossfade table. Constant-initialised, so it lives in read-only
+         * memory, once for the whole program. Fades read it from index 0,
+         * silent, to @ref xfade_table_end, full gain. */
+        inline const idsp::LookupTable<Sample, xfade_table_size>& xfade_table()
+        {
+            static constexpr idsp::LookupTable<Sample, xfade_table_size> table(_xfade_curve);
+            return table;
+        }
 
 
         /** Class for tracking a position in a sample buffer capable of fading. */
@@ -244,6 +265,11 @@ namespace idsp
                  * the fade position multiplier and polarity.
                  * If the Fade is already active, updates its position multiplier and
                  * polarity.
+                 * Loop and Data fades follow the position: a fade starting at
+                 * @a start_pos ahead of the current position stays at its initial
+                 * gain until the position gets there, so a fade can be triggered
+                 * before the move that crosses its start. The other types follow
+                 * time from the next move, whatever the speed.
                  * @param type the type of fade to start.
                  * @param start_pos position index that the fade started.
                  * @param length the length of the fade in samples.
@@ -260,8 +286,11 @@ namespace idsp
                 void copy_fades(const FadingPosition& source, FadeType no_copy_type);
 
                 /** Moves the FadingPosition's position by the given amount.
-                 * @param step Scan speed/step. */
-                void process(FractionT step);
+                 * @param step Scan speed/step, for a whole block the speed times its
+                 * length.
+                 * @param num_samples Length of the move in samples, which times the
+                 * fades that don't follow the position. */
+                void process(FractionT step, size_t num_samples = 1);
 
                 /** @return the position index. */
                 constexpr auto index() const
@@ -302,10 +331,60 @@ namespace idsp
                  * should be consistent. */
                 void apply_xfade(idsp::BufferInterface& buffer) const;
 
-                /** Updates the FadingPosition's state according to the Fades' states. */
+                /** Applies the crossfade of the part of a @a block_size block that
+                 * starts @a offset samples in and spans @a buffer. */
+                void apply_xfade(idsp::BufferInterface& buffer, size_t offset, size_t block_size) const;
+
+                /** Updates the FadingPosition's state according to the Fades' states.
+                 * Fades in that have reached full gain end, and a fade out that has
+                 * reached silence deactivates the FadingPosition. */
                 void update();
 
             private:
+                /** @returns `true` for fades that follow the position rather than time. */
+                static constexpr bool _follows_position(FadeType type)
+                    { return type == FadeType::Loop || type == FadeType::Data; }
+
+                /** Table entries per sample above which fades are too short for
+                 * ramps between entries to pay, and each gain is read instead. */
+                static constexpr FractionT _gather_speed = FractionT(0.25);
+
+                /** Block length of the gathered gain kernel. */
+                static constexpr size_t _block_size = 64;
+
+                /** Scales @a samples by the table read at positions from @a first
+                 * in steps of @a step. */
+                static void _apply_gathered(Sample* samples, size_t num_samples, FractionT first, FractionT step)
+                {
+                    const FractionT table_end = static_cast<FractionT>(xfade_table_end);
+                    const auto& table = xfade_table().table();
+                    std::array<FractionT, _block_size> positions;
+                    std::array<IndexT, _block_size> indices;
+                    for (size_t start = 0; start < num_samples; start += _block_size)
+                    {
+                        const size_t n = min(_block_size, num_samples - start);
+                        for (size_t i = 0; i < n; i++)
+                            positions[i] = clamp(first + step * static_cast<FractionT>(start + i), FractionT(0), table_end);
+                        // positions aren't negative, so truncation is floor
+                        for (size_t i = 0; i < n; i++)
+                            indices[i] = min(static_cast<IndexT>(positions[i]), xfade_table_end - 1);
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            const FractionT fraction = positions[i] - static_cast<FractionT>(indices[i]);
+                            const Sample a = table[static_cast<size_t>(indices[i])];
+                            const Sample b = table[static_cast<size_t>(indices[i]) + 1];
+                            samples[start + i] *= a + fraction * (b - a);
+                        }
+                    }
+                }
+
+                /** @returns The samples a ramp of @a distance steps covers, at least 1. */
+                static size_t _run_length(FractionT distance)
+                {
+                    const IndexT whole = static_cast<IndexT>(distance);
+                    return static_cast<size_t>(max<IndexT>(static_cast<FractionT>(whole) < distance ? whole + 1 : whole, 1));
+                }
+
                 /** State of the FadingPosition. */
                 bool _active;
                 /** Current position information. */
@@ -318,7 +397,14 @@ namespace idsp
 
 
         /** Tap class.
-         * This manages and represents a user-conceptual 'tap'. */
+         * This manages and represents a user-conceptual 'tap'.
+         * Each block, after any user events, call @ref process with the block
+         * length, @ref render to read it, then @ref update. A loop or data
+         * boundary crossed inside the block starts its crossfade at the sample
+         * it is crossed on. The region is [loop_start, loop_end) when looping,
+         * else [data_start, data_end); a position reaching the fade point near
+         * its end fades out over the fade length, while a new one fades in from
+         * the other end. */
         class Tap
         {
             public:
@@ -348,7 +434,10 @@ namespace idsp
                 constexpr const auto& loop_parameters() const
                     { return this->_loop_params; }
 
-                /** Sets the loop parameters of the Tap. */
+                /** Sets the loop parameters of the Tap.
+                 * The loop is clamped into the data and the fade lengths to half of
+                 * their region. The *_start_fade and *_end_fade points are derived:
+                 * start + fade length and end - fade length. */
                 void set_loop_parameters(const LoopingParamaters& params);
 
                 /** Activates the Tap.
@@ -374,8 +463,26 @@ namespace idsp
                 /** Unpauses the Tap's movement from @a position. */
                 void unpause(const Position& position);
 
-                /** Processes the loop mechanics of the Tap. */
-                void process();
+                /** Processes the loop mechanics of the Tap, moving it by
+                 * @a num_samples samples at its speed.
+                 * @note A block may cross at most one boundary, so the speed times
+                 * the block length must stay below the region's length. */
+                void process(size_t num_samples = 1);
+
+                /** Adds the Tap's output over the move made by the last @ref process
+                 * to @a output, reading @a data with linear interpolation. Positions
+                 * wrap around @a data once. */
+                void render(const idsp::BufferInterface& data, idsp::BufferInterface& output) const;
+
+                /** As @ref render, reading data that needn't be in memory through
+                 * @a source, which provides
+                 * `void read(IndexT first, Sample* output, size_t num_samples)`
+                 * to fetch a span of raw samples, e.g. a @ref StreamingBuffer.
+                 * Positions don't wrap: the source decides what lies outside
+                 * its data. Blocks faster than 4 times the source rate are read
+                 * in shorter spans. */
+                template<class Source>
+                void render_from(Source& source, idsp::BufferInterface& output) const;
 
                 /** Updates the state of the Tap. */
                 void update();
@@ -414,6 +521,35 @@ namespace idsp
                 /** Fades out all the active FadingPositions. */
                 void _fade_out_active(FadeType type, size_t xfade_len);
 
+                /** Activates a new FadingPosition at @a pos, fading in with @a type. */
+                void _fade_in(FadeType type, const Position& pos, size_t xfade_len);
+
+                /** @returns The start of the region the Tap is playing. */
+                Position _start_position() const;
+
+                /** @returns The move per sample that @a fp made over the last
+                 * @a num_samples samples. Taken from the difference of indices,
+                 * so it stays exact for positions too large for a float. */
+                static FractionT _step(const FadingPosition& fp, size_t num_samples)
+                {
+                    const FractionT moved = static_cast<FractionT>(fp.index() - fp.pindex()) + (fp.fraction() - fp.pfraction());
+                    return moved / static_cast<FractionT>(num_samples);
+                }
+
+                /** @returns @a x rounded down, negative or not. */
+                static IndexT _floor(FractionT x)
+                {
+                    const IndexT whole = static_cast<IndexT>(x);
+                    return static_cast<FractionT>(whole) > x ? whole - 1 : whole;
+                }
+
+                /** Block length of @ref render. */
+                static constexpr size_t _block_size = 64;
+
+                /** Samples @ref render_from fetches per block: a block at up to 4
+                 * times the source rate, and the point after it. */
+                static constexpr size_t _span_size = 4 * _block_size + 2;
+
                 static constexpr size_t num_fade_pos = 1 + num_fade_types;
 
                 /** FadingPosition storage. */
@@ -426,6 +562,488 @@ namespace idsp
                 LoopingParamaters _loop_params;
         };
 
+
+        inline void Fade::activate(IndexT index)
+        {
+            this->_active = true;
+            this->_pos.set(index);
+            this->_ppos = this->_pos;
+        }
+
+        inline void Fade::deactivate()
+        {
+            this->_active = false;
+        }
+
+        inline void Fade::reset()
+        {
+            *this = Fade();
+        }
+
+        inline void Fade::set_step_multiplier(FractionT mult, FractionT pol)
+        {
+            this->_multiplier = mult;
+            this->_polarity = pol;
+        }
+
+        inline void Fade::process(FractionT step)
+        {
+            this->_ppos = this->_pos;
+            this->_pos.process(step * this->_multiplier * this->_polarity);
+        }
+
+
+        inline void FadingPosition::activate(IndexT index, FractionT frac)
+        {
+            this->_active = true;
+            this->_pos.set(index, frac);
+            this->_ppos = this->_pos;
+            for (auto& fade : this->_fades)
+                fade.reset();
+        }
+
+        inline void FadingPosition::deactivate()
+        {
+            this->_active = false;
+        }
+
+        inline void FadingPosition::reset()
+        {
+            *this = FadingPosition();
+        }
+
+        inline void FadingPosition::trigger_fade(FadeType type, IndexT start_pos, size_t length, bool fade_in, bool forward)
+        {
+            auto& fade = this->_fades[static_cast<size_t>(type)];
+            if (fade.is_active())
+            {
+                this->update_fade(type, length, fade_in, forward);
+                return;
+            }
+            fade.activate(fade_in ? IndexT(0) : xfade_table_end);
+            this->update_fade(type, length, fade_in, forward);
+            // move it to where the position is relative to the fade's start
+            if (_follows_position(type))
+                fade.process(static_cast<FractionT>(this->index() - start_pos) + this->fraction());
+        }
+
+        inline void FadingPosition::update_fade(FadeType type, size_t length, bool fade_in, bool forward)
+        {
+            const FractionT multiplier = static_cast<FractionT>(xfade_table_end) / static_cast<FractionT>(max<size_t>(length, 1));
+            // a fade in climbs the table; one following the position does so
+            // as the position moves the way it was moving
+            const bool climbs = _follows_position(type) ? fade_in == forward : fade_in;
+            this->_fades[static_cast<size_t>(type)].set_step_multiplier(multiplier, climbs ? FractionT(1) : FractionT(-1));
+        }
+
+        inline void FadingPosition::copy_fades(const FadingPosition& source, FadeType no_copy_type)
+        {
+            for (size_t t = 0; t < num_fade_types; t++)
+                if (t != static_cast<size_t>(no_copy_type))
+                    this->_fades[t] = source._fades[t];
+        }
+
+        inline void FadingPosition::process(FractionT step, size_t num_samples)
+        {
+            this->_ppos = this->_pos;
+            this->_pos.process(step);
+            for (size_t t = 0; t < num_fade_types; t++)
+            {
+                auto& fade = this->_fades[t];
+                if (fade.is_active())
+                    fade.process(_follows_position(static_cast<FadeType>(t)) ? step : static_cast<FractionT>(num_samples));
+            }
+        }
+
+        inline bool FadingPosition::is_fading() const
+        {
+            for (const auto& fade : this->_fades)
+                if (fade.is_active())
+                    return true;
+            return false;
+        }
+
+        inline void FadingPosition::apply_xfade(idsp::BufferInterface& buffer) const
+        {
+            this->apply_xfade(buffer, 0, buffer.size());
+        }
+
+        inline void FadingPosition::apply_xfade(idsp::BufferInterface& buffer, size_t offset, size_t block_size) const
+        {
+            const size_t num_samples = buffer.size();
+            if (num_samples == 0 || block_size == 0)
+                return;
+            const FractionT table_end = static_cast<FractionT>(xfade_table_end);
+            const auto& table = xfade_table().table();
+            for (const auto& fade : this->_fades)
+            {
+                if (!fade.is_active())
+                    continue;
+                // table positions run linearly over the block
+                const FractionT step = (fade.total() - fade.ptotal()) / static_cast<FractionT>(block_size);
+                const FractionT first = fade.ptotal() + step * static_cast<FractionT>(offset);
+                const FractionT last = first + step * static_cast<FractionT>(num_samples - 1);
+                if (min(first, last) >= table_end)
+                    continue;
+                if (max(first, last) <= FractionT(0))
+                {
+                    std::fill(buffer.begin(), buffer.end(), Sample(0));
+                    return;
+                }
+
+                Sample* samples = buffer.data();
+                const FractionT speed = step < FractionT(0) ? -step : step;
+                if (speed > _gather_speed)
+                {
+                    _apply_gathered(samples, num_samples, first, step);
+                    continue;
+                }
+                // Between two table entries the gain is a linear ramp, so the
+                // block is cut into runs that each stay between two entries
+                size_t i = 0;
+                while (i < num_samples)
+                {
+                    const FractionT position = first + step * static_cast<FractionT>(i);
+                    size_t run = num_samples - i;
+                    if (position >= table_end || position <= FractionT(0))
+                    {
+                        // constant gain, 1 or 0, until the position enters the table
+                        const bool above = position >= table_end;
+                        if (above ? step < FractionT(0) : step > FractionT(0))
+                            run = min(run, _run_length((above ? position - table_end : -position) / speed));
+                        if (!above)
+                            std::fill(samples + i, samples + i + run, Sample(0));
+                        i += run;
+                        continue;
+                    }
+                    IndexT index = min(static_cast<IndexT>(position), xfade_table_end - 1);
+                    if (step < FractionT(0) && static_cast<FractionT>(index) == position)
+                        index--;
+                    const FractionT offset = position - static_cast<FractionT>(index);
+                    if (step > FractionT(0))
+                        run = min(run, _run_length((FractionT(1) - offset) / speed));
+                    else if (step < FractionT(0))
+                        run = min(run, _run_length(offset / speed));
+                    const Sample a = table[static_cast<size_t>(index)];
+                    const Sample slope = table[static_cast<size_t>(index) + 1] - a;
+                    for (size_t j = 0; j < run; j++)
+                        samples[i + j] *= a + (offset + step * static_cast<FractionT>(j)) * slope;
+                    i += run;
+                }
+            }
+        }
+
+        inline void FadingPosition::update()
+        {
+            const FractionT table_end = static_cast<FractionT>(xfade_table_end);
+            bool silent = false;
+            for (auto& fade : this->_fades)
+            {
+                if (!fade.is_active())
+                    continue;
+                if (fade.total() >= table_end && fade.total() > fade.ptotal())
+                    fade.deactivate();
+                else if (fade.total() <= FractionT(0) && fade.total() < fade.ptotal())
+                    silent = true;
+            }
+            if (silent)
+            {
+                this->deactivate();
+                for (auto& fade : this->_fades)
+                    fade.reset();
+            }
+        }
+
+
+        inline void Tap::set_loop_parameters(const LoopingParamaters& params)
+        {
+            auto& p = this->_loop_params;
+            p = params;
+            p.data_end = max(p.data_end, p.data_start);
+            p.loop_start = clamp(p.loop_start, p.data_start, p.data_end);
+            p.loop_end = clamp(p.loop_end, p.loop_start, p.data_end);
+            p.loop_fade_length = clamp<IndexT>(p.loop_fade_length, 0, (p.loop_end - p.loop_start) / 2);
+            p.data_fade_length = clamp<IndexT>(p.data_fade_length, 0, (p.data_end - p.data_start) / 2);
+            p.loop_start_fade = p.loop_start + p.loop_fade_length;
+            p.loop_end_fade = p.loop_end - p.loop_fade_length;
+            p.data_start_fade = p.data_start + p.data_fade_length;
+            p.data_end_fade = p.data_end - p.data_fade_length;
+        }
+
+        inline void Tap::activate()
+        {
+            if (this->is_active())
+            {
+                this->restart();
+                return;
+            }
+            this->_fade_in(FadeType::Reset, this->_start_position(), static_cast<size_t>(this->_loop_params.loop_fade_length));
+        }
+
+        inline void Tap::restart()
+        {
+            if (!this->is_active())
+            {
+                this->activate();
+                return;
+            }
+            const size_t length = static_cast<size_t>(this->_loop_params.loop_fade_length);
+            this->_fade_out_active(FadeType::Reset, length);
+            this->_fade_in(FadeType::Reset, this->_start_position(), length);
+        }
+
+        inline void Tap::deactivate()
+        {
+            this->_fade_out_active(FadeType::Deactivate, static_cast<size_t>(this->_loop_params.loop_fade_length));
+        }
+
+        inline void Tap::kill()
+        {
+            this->_fade_out_active(FadeType::Kill, kill_fade_length);
+        }
+
+        inline Position Tap::pause()
+        {
+            const Position paused = this->position();
+            this->_fade_out_active(FadeType::Pause, static_cast<size_t>(this->_loop_params.loop_fade_length));
+            return paused;
+        }
+
+        inline void Tap::unpause(const Position& position)
+        {
+            this->_fade_in(FadeType::Pause, position, static_cast<size_t>(this->_loop_params.loop_fade_length));
+        }
+
+        inline void Tap::process(size_t num_samples)
+        {
+            const auto& p = this->_loop_params;
+            const FractionT step = p.speed * static_cast<FractionT>(num_samples);
+            const bool forward = step >= FractionT(0);
+            const FadeType type = p.looping_enabled ? FadeType::Loop : FadeType::Data;
+            const IndexT start = p.looping_enabled ? p.loop_start : p.data_start;
+            const IndexT end = p.looping_enabled ? p.loop_end : p.data_end;
+            const IndexT start_fade = p.looping_enabled ? p.loop_start_fade : p.data_start_fade;
+            const IndexT end_fade = p.looping_enabled ? p.loop_end_fade : p.data_end_fade;
+            const size_t length = static_cast<size_t>(p.looping_enabled ? p.loop_fade_length : p.data_fade_length);
+
+            // Positions that this move takes past their fade point fade out,
+            // and each is replaced by one the same distance before the other
+            // end of the region, fading in. Both fades are triggered before
+            // the move so they start on the sample the point is crossed on.
+            const auto crossing = this->_active_fp;
+            for (FadingPosition* fp : crossing)
+            {
+                if (fp == nullptr)
+                    break;
+                if (fp->is_fading(type))
+                    continue;
+                // measured from the position's index, so long files keep
+                // sample accuracy where a float total wouldn't
+                const FractionT next = fp->fraction() + step;
+                Position replacement;
+                if (forward && next >= static_cast<FractionT>(end_fade - fp->index()))
+                {
+                    const IndexT from = max(end_fade, fp->index());
+                    fp->trigger_fade(type, from, length, false, forward);
+                    replacement.set(start, fp->fraction());
+                    replacement.process(static_cast<FractionT>(fp->index() - from));
+                }
+                else if (!forward && next <= static_cast<FractionT>(start_fade - fp->index()))
+                {
+                    const IndexT from = min(start_fade, fp->index() + (fp->fraction() > FractionT(0) ? 1 : 0));
+                    fp->trigger_fade(type, from, length, false, forward);
+                    replacement.set(end, fp->fraction());
+                    replacement.process(static_cast<FractionT>(fp->index() - from));
+                }
+                else
+                    continue;
+
+                FadingPosition* fresh = this->_activate(replacement.index(), replacement.fraction());
+                if (fresh == nullptr)
+                    continue;
+                fresh->copy_fades(*fp, type);
+                fresh->trigger_fade(type, forward ? start : end, length, true, forward);
+            }
+
+            for (FadingPosition* fp : this->_active_fp)
+            {
+                if (fp == nullptr)
+                    break;
+                fp->process(step, num_samples);
+            }
+        }
+
+        inline void Tap::render(const idsp::BufferInterface& data, idsp::BufferInterface& output) const
+        {
+            const size_t num_samples = output.size();
+            const IndexT size = static_cast<IndexT>(data.size());
+            if (num_samples == 0 || size == 0)
+                return;
+            std::array<Sample, _block_size> block;
+            for (const FadingPosition* fp : this->_active_fp)
+            {
+                if (fp == nullptr)
+                    break;
+                const FractionT step = _step(*fp, num_samples);
+                for (size_t start = 0; start < num_samples; start += _block_size)
+                {
+                    const size_t n = min(_block_size, num_samples - start);
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const FractionT position = fp->pfraction() + step * static_cast<FractionT>(start + i);
+                        IndexT index = _floor(position);
+                        const FractionT fraction = position - static_cast<FractionT>(index);
+                        index += fp->pindex();
+                        index = index < 0 ? index + size : index >= size ? index - size : index;
+                        const IndexT next = index + 1 == size ? 0 : index + 1;
+                        block[i] = interpolate_2(fraction, data[static_cast<size_t>(index)], data[static_cast<size_t>(next)]);
+                    }
+                    idsp::BufferInterface chunk(block.data(), n);
+                    fp->apply_xfade(chunk, start, num_samples);
+                    for (size_t i = 0; i < n; i++)
+                        output[start + i] += block[i];
+                }
+            }
+        }
+
+        template<class Source>
+        inline void Tap::render_from(Source& source, idsp::BufferInterface& output) const
+        {
+            const size_t num_samples = output.size();
+            if (num_samples == 0)
+                return;
+            std::array<Sample, _block_size> block;
+            std::array<Sample, _span_size> points;
+            for (const FadingPosition* fp : this->_active_fp)
+            {
+                if (fp == nullptr)
+                    break;
+                const FractionT step = _step(*fp, num_samples);
+                const FractionT speed = step < FractionT(0) ? -step : step;
+                // samples per span, so that a span's points fit, with one to
+                // spare for rounding
+                const FractionT reach = static_cast<FractionT>(_span_size - 3);
+                const size_t chunk = speed * static_cast<FractionT>(_block_size) <= reach ? _block_size : max<size_t>(static_cast<size_t>(reach / speed), 1);
+                for (size_t start = 0; start < num_samples; start += chunk)
+                {
+                    const size_t n = min(chunk, num_samples - start);
+                    // relative to the previous index, like render()
+                    const FractionT first = fp->pfraction() + step * static_cast<FractionT>(start);
+                    const FractionT last = fp->pfraction() + step * static_cast<FractionT>(start + n - 1);
+                    const IndexT low = _floor(min(first, last));
+                    const size_t count = static_cast<size_t>(_floor(max(first, last)) - low) + 2;
+                    source.read(fp->pindex() + low, points.data(), count);
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const FractionT position = fp->pfraction() + step * static_cast<FractionT>(start + i);
+                        const IndexT index = _floor(position);
+                        const size_t point = static_cast<size_t>(index - low);
+                        block[i] = interpolate_2(position - static_cast<FractionT>(index), points[point], points[point + 1]);
+                    }
+                    idsp::BufferInterface span(block.data(), n);
+                    fp->apply_xfade(span, start, num_samples);
+                    for (size_t i = 0; i < n; i++)
+                        output[start + i] += block[i];
+                }
+            }
+        }
+
+        inline void Tap::update()
+        {
+            size_t kept = 0;
+            for (FadingPosition* fp : this->_active_fp)
+            {
+                if (fp == nullptr)
+                    break;
+                fp->update();
+                if (fp->is_active())
+                    this->_active_fp[kept++] = fp;
+            }
+            for (size_t i = kept; i < num_fade_pos; i++)
+                this->_active_fp[i] = nullptr;
+        }
+
+        inline void Tap::reset()
+        {
+            for (auto& fp : this->_fading_pos)
+                fp.reset();
+            this->_active_fp.fill(nullptr);
+        }
+
+        inline Position Tap::position() const
+        {
+            const FadingPosition* fp = this->_active_fp[0];
+            return fp != nullptr ? Position(fp->index(), fp->fraction()) : Position();
+        }
+
+        inline Position Tap::coposition() const
+        {
+            const FadingPosition* fp = this->_active_fp[1];
+            return fp != nullptr ? Position(fp->index(), fp->fraction()) : Position();
+        }
+
+        inline void Tap::syncronise(const Position& pos)
+        {
+            const size_t length = static_cast<size_t>(this->_loop_params.loop_fade_length);
+            this->_fade_out_active(FadeType::Sync, length);
+            this->_fade_in(FadeType::Sync, pos, length);
+        }
+
+        inline void Tap::syncronise(const Tap& other)
+        {
+            this->set_loop_parameters(other.loop_parameters());
+            this->syncronise(other.position());
+        }
+
+        inline bool Tap::is_active() const
+        {
+            return this->_active_fp[0] != nullptr;
+        }
+
+        inline FadingPosition* Tap::_activate(IndexT index, FractionT frac)
+        {
+            if (this->_active_fp[num_fade_pos - 1] != nullptr)
+                return nullptr;
+            for (auto& fp : this->_fading_pos)
+            {
+                if (fp.is_active())
+                    continue;
+                fp.activate(index, frac);
+                // newest first
+                for (size_t i = num_fade_pos - 1; i > 0; i--)
+                    this->_active_fp[i] = this->_active_fp[i - 1];
+                this->_active_fp[0] = &fp;
+                return &fp;
+            }
+            return nullptr;
+        }
+
+        inline void Tap::_fade_out_active(FadeType type, size_t xfade_len)
+        {
+            const bool forward = this->_loop_params.speed >= FractionT(0);
+            for (FadingPosition* fp : this->_active_fp)
+            {
+                if (fp == nullptr)
+                    break;
+                fp->trigger_fade(type, fp->index(), xfade_len, false, forward);
+            }
+        }
+
+        inline void Tap::_fade_in(FadeType type, const Position& pos, size_t xfade_len)
+        {
+            FadingPosition* fp = this->_activate(pos.index(), pos.fraction());
+            if (fp != nullptr)
+                fp->trigger_fade(type, pos.index(), xfade_len, true, this->_loop_params.speed >= FractionT(0));
+        }
+
+        inline Position Tap::_start_position() const
+        {
+            const auto& p = this->_loop_params;
+            const IndexT start = p.looping_enabled ? p.loop_start : p.data_start;
+            const IndexT end = p.looping_enabled ? p.loop_end : p.data_end;
+            return p.speed >= FractionT(0) ? Position(start) : Position(max(end - 1, start));
+        }
+
     } // namespace looper
 } // namespace idsp
 
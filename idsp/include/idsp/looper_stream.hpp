@@ -0,0 +1,592 @@
+#ifndef IDSP_LOOPER_STREAM_H
+#define IDSP_LOOPER_STREAM_H
+
+// Host builds only: needs std::thread and POSIX file I/O, which the embedded
+// targets don't have.
+
+#include "idsp/looper.hpp"
+#include "idsp/ringbuffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace idsp
+{
+    namespace looper
+    {
+
+        /** Counters of a @ref StreamingBuffer, since construction or the last
+         * @ref StreamingBuffer::reset_stats. */
+        struct StreamStats
+        {
+            /** Block reads served from the cache. */
+            uint64_t hits;
+            /** Block reads that weren't cached, and played silence. */
+            uint64_t misses;
+            /** Samples of silence played for misses. */
+            uint64_t underruns;
+            /** Samples recorded while the write queue was full, and dropped. */
+            uint64_t overruns;
+            /** Blocks read from the file into the cache. */
+            uint64_t loads;
+            /** Failed reads and writes of the file. */
+            uint64_t io_errors;
+
+            /** @returns The fraction of block reads that hit, 1 if there were none. */
+            double hit_rate() const
+            {
+                const uint64_t reads = this->hits + this->misses;
+                return reads > 0 ? static_cast<double>(this->hits) / static_cast<double>(reads) : 1.0;
+            }
+        };
+
+        /** Looper audio kept in a file, for loops longer than memory.
+         * The audio thread records with @ref write and plays with @ref read,
+         * the source of @ref Tap::render_from, while a background thread does
+         * all file I/O; the audio thread never blocks, locks or allocates.
+         * Writes are queued in order and written to the file behind the
+         * audio thread. Reads come from a cache of @a Slots blocks of
+         * @a BlockSize samples, any block in any slot, found through a table
+         * with an entry per block of the file. Each Tap reports where it is
+         * with @ref follow, and the background thread keeps the blocks
+         * around it cached, ahead in its direction, with those of a position
+         * it is fading out and those where it will jump at the end of its
+         * region, nearest first. A read of a block that isn't cached plays
+         * silence and counts an underrun.
+         * The same thread writes and loads, so a block loaded after a write
+         * holds it, and a write to a cached block updates the cache.
+         * Each slot is guarded by a sequence count that is odd while it is
+         * loaded: a read checks it before and after copying, and misses if it
+         * changed.
+         * Positions are file samples, which must fit in @ref IndexT: over 12
+         * hours at 48 kHz. The defaults cache 2 MB, about 11 seconds at
+         * 48 kHz, queue over a second of writes, and take another 2 MB for
+         * the table.
+         * @note Construct before audio starts: it allocates and starts its
+         * thread.
+         */
+        template<size_t BlockSize = 4096, size_t Slots = 128, size_t MaxCursors = 8, size_t QueueSize = (1 << 16)>
+        class StreamingBuffer
+        {
+            static_assert(BlockSize > 0 && Slots > 0, "StreamingBuffer needs a cache.");
+            static_assert(QueueSize >= BlockSize, "StreamingBuffer loads blocks through its write scratch.");
+
+            public:
+                static constexpr size_t block_size = BlockSize;
+                static constexpr size_t num_slots = Slots;
+                static constexpr size_t max_cursors = MaxCursors;
+
+                /** Opens or creates the file at @a path, keeping what it holds.
+                 * @param max_length Longest the file may grow, in samples,
+                 * which sizes the block table at 4 bytes per block.
+                 * @param prefetch_blocks Blocks kept cached ahead of each
+                 * cursor, past the one it's in. */
+                StreamingBuffer(const std::string& path, IndexT max_length = std::numeric_limits<IndexT>::max(), size_t prefetch_blocks = 4):
+                _prefetch_blocks{prefetch_blocks},
+                _max_length{max(max_length, IndexT(0))},
+                _slots(Slots),
+                _table(static_cast<size_t>(_block_of(_max_length - 1) + 1)),
+                _wanted(Slots, 0),
+                _pass{0},
+                _starved{false},
+                _samples{std::make_unique<RingBuffer<Sample, QueueSize>>()},
+                _writes{std::make_unique<RingBuffer<_Write, _max_writes>>()},
+                _scratch(QueueSize),
+                _file{::open(path.c_str(), O_RDWR | O_CREAT, 0644)},
+                _length{0},
+                _queued_length{0},
+                _miss{-1},
+                _idle_passes{0},
+                _starved_pass{false},
+                _stop{false}
+                {
+                    for (auto& slot : this->_slots)
+                    {
+                        slot.seq.store(0, std::memory_order_relaxed);
+                        slot.tag.store(-1, std::memory_order_relaxed);
+                    }
+                    for (auto& entry : this->_table)
+                        entry.store(-1, std::memory_order_relaxed);
+                    for (auto& cursor : this->_cursors)
+                    {
+                        cursor.block.store(-1, std::memory_order_relaxed);
+                        cursor.tail.store(-1, std::memory_order_relaxed);
+                        cursor.cross.store(-1, std::memory_order_relaxed);
+                        cursor.jump.store(-1, std::memory_order_relaxed);
+                        cursor.back.store(1, std::memory_order_relaxed);
+                        cursor.forward.store(true, std::memory_order_relaxed);
+                    }
+                    this->reset_stats();
+                    if (!this->is_open())
+                        return;
+                    const off_t bytes = ::lseek(this->_file, 0, SEEK_END);
+                    const IndexT length = static_cast<IndexT>(min<off_t>(max<off_t>(bytes, 0) / static_cast<off_t>(sizeof(Sample)), this->_max_length));
+                    this->_length.store(length, std::memory_order_relaxed);
+                    this->_queued_length = length;
+                    this->_thread = std::thread([this]() { this->_run(); });
+                }
+
+                StreamingBuffer(const StreamingBuffer&) = delete;
+                StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+                /** Writes what is queued, then closes the file. */
+                ~StreamingBuffer()
+                {
+                    this->_stop.store(true, std::memory_order_release);
+                    if (this->_thread.joinable())
+                        this->_thread.join();
+                    if (this->is_open())
+                        ::close(this->_file);
+                }
+
+                /** @returns `false` if the file couldn't be opened, in which case
+                 * reads are silent and writes are dropped. */
+                bool is_open() const
+                    { return this->_file >= 0; }
+
+                // Audio thread
+
+                /** Queues @a num_samples samples from @a input to be written at
+                 * @a position, overdubbing or extending the file.
+                 * @returns `false`, dropping them as an overrun, if the queue is
+                 * full or they would pass the maximum length. */
+                bool write(IndexT position, const Sample* input, size_t num_samples)
+                {
+                    if (num_samples == 0)
+                        return true;
+                    if (!this->is_open() || position < 0 || position > this->_max_length - static_cast<IndexT>(num_samples)
+                        || this->_samples->space_available() < num_samples || this->_writes->space_available() == 0)
+                    {
+                        _count(this->_overruns, num_samples);
+                        return false;
+                    }
+                    // the samples go first, so they are there when the write is seen
+                    this->_samples->write(input, num_samples);
+                    this->_writes->write(_Write{position, static_cast<IndexT>(num_samples)});
+                    this->_queued_length = max(this->_queued_length, position + static_cast<IndexT>(num_samples));
+                    return true;
+                }
+
+                /** Copies @a num_samples samples from @a first to @a output.
+                 * Samples outside the recorded data are silent. Samples of blocks
+                 * that aren't cached, or are recorded but not yet written, are
+                 * silent and count as underruns. */
+                void read(IndexT first, Sample* output, size_t num_samples)
+                {
+                    const IndexT end = first + static_cast<IndexT>(num_samples);
+                    const IndexT length = this->_length.load(std::memory_order_acquire);
+                    IndexT index = first;
+                    while (index < end)
+                    {
+                        const IndexT block = _block_of(index);
+                        const IndexT block_end = min(end, (block + 1) * _block_length);
+                        Sample* out = output + (index - first);
+                        const size_t n = static_cast<size_t>(block_end - index);
+                        if (index < 0 || index >= this->_queued_length)
+                            std::fill(out, out + n, Sample(0));
+                        else if (index < length && this->_read_cached(block, index - block * _block_length, out, n))
+                            _count(this->_hits, 1);
+                        else
+                        {
+                            std::fill(out, out + n, Sample(0));
+                            _count(this->_misses, 1);
+                            _count(this->_underruns, n);
+                            this->_miss.store(block, std::memory_order_relaxed);
+                        }
+                        index = block_end;
+                    }
+                }
+
+                /** Tells the prefetcher where @a tap is playing, as cursor
+                 * @a cursor of @a max_cursors. Call once a block per playing
+                 * Tap, after its @ref Tap::process. */
+                void follow(size_t cursor, const Tap& tap)
+                {
+                    if (cursor >= MaxCursors)
+                        return;
+                    auto& c = this->_cursors[cursor];
+                    if (!tap.is_active())
+                    {
+                        c.block.store(-1, std::memory_order_relaxed);
+                        return;
+                    }
+                    const auto& p = tap.loop_parameters();
+                    const bool forward = p.speed >= FractionT(0);
+                    const IndexT start = p.looping_enabled ? p.loop_start : p.data_start;
+                    const IndexT end = p.looping_enabled ? p.loop_end : p.data_end;
+                    const IndexT start_fade = p.looping_enabled ? p.loop_start_fade : p.data_start_fade;
+                    const IndexT end_fade = p.looping_enabled ? p.loop_end_fade : p.data_end_fade;
+                    c.forward.store(forward, std::memory_order_relaxed);
+                    c.cross.store(_block_of(forward ? end_fade : start_fade), std::memory_order_relaxed);
+                    c.jump.store(_block_of(forward ? start : max(end - 1, start)), std::memory_order_relaxed);
+                    c.tail.store(tap.active_list()[1] != nullptr ? _block_of(tap.coposition().index()) : -1, std::memory_order_relaxed);
+                    const FadingPosition& fp = *tap.active_list()[0];
+                    const IndexT moved = fp.index() > fp.pindex() ? fp.index() - fp.pindex() : fp.pindex() - fp.index();
+                    c.back.store(moved / _block_length + 1, std::memory_order_relaxed);
+                    c.block.store(_block_of(fp.index()), std::memory_order_relaxed);
+                }
+
+                /** Stops prefetching for @a cursor. */
+                void unfollow(size_t cursor)
+                {
+                    if (cursor < MaxCursors)
+                        this->_cursors[cursor].block.store(-1, std::memory_order_relaxed);
+                }
+
+                // Either side
+
+                /** @returns The length of the file in samples, as written so far. */
+                IndexT length() const
+                    { return this->_length.load(std::memory_order_acquire); }
+
+                StreamStats get_stats() const
+                {
+                    StreamStats stats;
+                    stats.hits = this->_hits.load(std::memory_order_relaxed);
+                    stats.misses = this->_misses.load(std::memory_order_relaxed);
+                    stats.underruns = this->_underruns.load(std::memory_order_relaxed);
+                    stats.overruns = this->_overruns.load(std::memory_order_relaxed);
+                    stats.loads = this->_loads.load(std::memory_order_relaxed);
+                    stats.io_errors = this->_io_errors.load(std::memory_order_relaxed);
+                    return stats;
+                }
+
+                /** @note Counts made while this runs may be lost. */
+                void reset_stats()
+                {
+                    for (auto* counter : {&this->_hits, &this->_misses, &this->_underruns, &this->_overruns, &this->_loads, &this->_io_errors})
+                        counter->store(0, std::memory_order_relaxed);
+                }
+
+                // Other threads
+
+                /** Blocks until everything queued so far is written and every
+                 * followed block is cached, for offline rendering and tests.
+                 * @returns `false` if that took longer than @a timeout, or if
+                 * the followed blocks don't all fit in the cache. */
+                bool wait_until_idle(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) const
+                {
+                    if (!this->is_open())
+                        return true;
+                    // the second idle pass started after this call
+                    const uint64_t target = this->_idle_passes.load(std::memory_order_acquire) + 2;
+                    const auto deadline = std::chrono::steady_clock::now() + timeout;
+                    while (this->_idle_passes.load(std::memory_order_acquire) < target)
+                    {
+                        if (std::chrono::steady_clock::now() > deadline)
+                            return false;
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    }
+                    return !this->_starved_pass.load(std::memory_order_acquire);
+                }
+
+            private:
+                static constexpr IndexT _block_length = static_cast<IndexT>(BlockSize);
+                static constexpr size_t _max_writes = 1024;
+                /** Sleep of the background thread when it has nothing to do. */
+                static constexpr std::chrono::microseconds _poll_period{500};
+
+                struct _Write
+                {
+                    IndexT position;
+                    IndexT count;
+                };
+
+                struct _Slot
+                {
+                    /** Odd while the slot is being loaded. */
+                    std::atomic<uint32_t> seq;
+                    /** The block held, or -1. */
+                    std::atomic<IndexT> tag;
+                    /** Atomic so that reads racing a load are defined; relaxed
+                     * accesses compile to plain loads and stores. */
+                    std::array<std::atomic<Sample>, BlockSize> data;
+                };
+
+                struct _Cursor
+                {
+                    /** The block the cursor is in, or -1 if it isn't playing. */
+                    std::atomic<IndexT> block;
+                    /** The block of a position it is fading out, or -1. */
+                    std::atomic<IndexT> tail;
+                    /** The block where it starts to cross the end of its region. */
+                    std::atomic<IndexT> cross;
+                    /** The block it continues from at the end of its region. */
+                    std::atomic<IndexT> jump;
+                    /** Blocks the last move spanned, at least 1. */
+                    std::atomic<IndexT> back;
+                    std::atomic<bool> forward;
+                };
+
+                static IndexT _block_of(IndexT index)
+                {
+                    return index >= 0 ? index / _block_length : (index + 1) / _block_length - 1;
+                }
+
+                /** Single-writer counters, so a load and store is enough. */
+                static void _count(std::atomic<uint64_t>& counter, size_t n)
+                {
+                    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+                }
+
+                bool _read_cached(IndexT block, IndexT offset, Sample* output, size_t num_samples) const
+                {
+                    const int32_t index = this->_table[static_cast<size_t>(block)].load(std::memory_order_acquire);
+                    if (index < 0)
+                        return false;
+                    const _Slot& slot = this->_slots[static_cast<size_t>(index)];
+                    const uint32_t seq = slot.seq.load(std::memory_order_acquire);
+                    if ((seq & 1) != 0 || slot.tag.load(std::memory_order_relaxed) != block)
+                        return false;
+                    const auto* data = slot.data.data() + offset;
+                    for (size_t i = 0; i < num_samples; i++)
+                        output[i] = data[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    return slot.seq.load(std::memory_order_relaxed) == seq;
+                }
+
+                // Background thread
+
+                void _run()
+                {
+                    while (!this->_stop.load(std::memory_order_acquire))
+                    {
+                        const bool wrote = this->_write_queued();
+                        const bool loaded = this->_prefetch();
+                        if (wrote || loaded)
+                            continue;
+                        this->_starved_pass.store(this->_starved, std::memory_order_relaxed);
+                        this->_idle_passes.fetch_add(1, std::memory_order_release);
+                        std::this_thread::sleep_for(_poll_period);
+                    }
+                    this->_write_queued();
+                }
+
+                /** Writes everything queued, merging contiguous writes. */
+                bool _write_queued()
+                {
+                    bool wrote = false;
+                    _Write write;
+                    while (this->_writes->read(write))
+                    {
+                        size_t count = this->_samples->read(this->_scratch.data(), static_cast<size_t>(write.count));
+                        while (!this->_writes->is_empty())
+                        {
+                            const _Write next = this->_writes->peek();
+                            if (next.position != write.position + static_cast<IndexT>(count)
+                                || count + static_cast<size_t>(next.count) > this->_scratch.size())
+                                break;
+                            this->_writes->read();
+                            count += this->_samples->read(this->_scratch.data() + count, static_cast<size_t>(next.count));
+                        }
+                        this->_write_file(write.position, this->_scratch.data(), count);
+                        wrote = true;
+                    }
+                    return wrote;
+                }
+
+                void _write_file(IndexT position, const Sample* data, size_t count)
+                {
+                    const size_t bytes = count * sizeof(Sample);
+                    size_t done = 0;
+                    while (done < bytes)
+                    {
+                        const ssize_t n = ::pwrite(this->_file, reinterpret_cast<const char*>(data) + done, bytes - done,
+                            static_cast<off_t>(position) * static_cast<off_t>(sizeof(Sample)) + static_cast<off_t>(done));
+                        if (n <= 0)
+                        {
+                            _count(this->_io_errors, 1);
+                            break;
+                        }
+                        done += static_cast<size_t>(n);
+                    }
+                    const IndexT end = position + static_cast<IndexT>(done / sizeof(Sample));
+
+                    // keep cached blocks in step with the file, before the
+                    // length lets reads see what they hold past its old end
+                    for (IndexT block = _block_of(position); block * _block_length < end; block++)
+                    {
+                        const int32_t index = this->_table[static_cast<size_t>(block)].load(std::memory_order_relaxed);
+                        if (index < 0)
+                            continue;
+                        _Slot* slot = &this->_slots[static_cast<size_t>(index)];
+                        const IndexT first = max(position, block * _block_length);
+                        const IndexT last = min(end, (block + 1) * _block_length);
+                        this->_begin_store(*slot);
+                        for (IndexT i = first; i < last; i++)
+                            slot->data[static_cast<size_t>(i - block * _block_length)].store(data[i - position], std::memory_order_relaxed);
+                        this->_end_store(*slot);
+                    }
+                    if (end > this->_length.load(std::memory_order_relaxed))
+                        this->_length.store(end, std::memory_order_release);
+                }
+
+                /** Loads the nearest wanted block that isn't cached.
+                 * @returns `false` if all are, or no slot is free to take the
+                 * rest, which sets @ref _starved. */
+                bool _prefetch()
+                {
+                    this->_starved = false;
+                    // Slots are marked with the last pass that wanted them, and a
+                    // load takes the one wanted longest ago. One wanted in
+                    // this pass is never taken, so that blocks don't evict
+                    // each other in turn
+                    const uint64_t pass = ++this->_pass;
+                    const auto want = [&](IndexT block) {
+                        if (block < 0 || block * _block_length >= this->_length.load(std::memory_order_relaxed))
+                            return false;
+                        const int32_t index = this->_table[static_cast<size_t>(block)].load(std::memory_order_relaxed);
+                        if (index >= 0)
+                        {
+                            this->_wanted[static_cast<size_t>(index)] = pass;
+                            return false;
+                        }
+                        size_t oldest = 0;
+                        for (size_t s = 1; s < Slots; s++)
+                            if (this->_wanted[s] < this->_wanted[oldest])
+                                oldest = s;
+                        if (this->_wanted[oldest] == pass)
+                        {
+                            this->_starved = true;
+                            return false;
+                        }
+                        this->_wanted[oldest] = pass;
+                        this->_load(block, oldest);
+                        return true;
+                    };
+                    // Playing positions come first, then the jumps of cursors
+                    // getting near their crossing, then the last miss. Each
+                    // window is the block a position is in, the blocks a move
+                    // spans behind it, which the last move read from and a new
+                    // position runs in from, then those ahead, nearest first
+                    const IndexT prefetch = static_cast<IndexT>(this->_prefetch_blocks);
+                    IndexT last_rank = 0;
+                    for (const auto& cursor : this->_cursors)
+                    {
+                        const IndexT back = cursor.back.load(std::memory_order_relaxed);
+                        last_rank = max(last_rank, back + max(prefetch, back));
+                    }
+                    for (size_t phase = 0; phase < 2; phase++)
+                    {
+                        for (IndexT rank = 0; rank <= last_rank; rank++)
+                        {
+                            for (const auto& cursor : this->_cursors)
+                            {
+                                const IndexT block = cursor.block.load(std::memory_order_relaxed);
+                                const IndexT back = cursor.back.load(std::memory_order_relaxed);
+                                const IndexT ahead = max(prefetch, back);
+                                if (block < 0 || rank > back + ahead)
+                                    continue;
+                                const IndexT step = cursor.forward.load(std::memory_order_relaxed) ? 1 : -1;
+                                const IndexT offset = step * (rank <= back ? -rank : rank - back);
+                                if (phase == 0)
+                                {
+                                    const IndexT tail = cursor.tail.load(std::memory_order_relaxed);
+                                    if (want(block + offset) || (tail >= 0 && want(tail + offset)))
+                                        return true;
+                                }
+                                else if (step * (cursor.cross.load(std::memory_order_relaxed) - block) <= ahead
+                                    && want(cursor.jump.load(std::memory_order_relaxed) + offset))
+                                    return true;
+                            }
+                        }
+                    }
+                    return want(this->_miss.exchange(-1, std::memory_order_relaxed));
+                }
+
+                void _load(IndexT block, size_t index)
+                {
+                    const off_t offset = static_cast<off_t>(block) * static_cast<off_t>(_block_length) * static_cast<off_t>(sizeof(Sample));
+                    const size_t bytes = BlockSize * sizeof(Sample);
+                    size_t done = 0;
+                    while (done < bytes)
+                    {
+                        const ssize_t n = ::pread(this->_file, reinterpret_cast<char*>(this->_scratch.data()) + done, bytes - done, offset + static_cast<off_t>(done));
+                        if (n < 0)
+                            _count(this->_io_errors, 1);
+                        if (n <= 0)
+                            break;
+                        done += static_cast<size_t>(n);
+                    }
+                    std::fill(this->_scratch.begin() + static_cast<std::ptrdiff_t>(done / sizeof(Sample)), this->_scratch.begin() + BlockSize, Sample(0));
+
+                    _Slot& slot = this->_slots[index];
+                    this->_begin_store(slot);
+                    const IndexT evicted = slot.tag.load(std::memory_order_relaxed);
+                    if (evicted >= 0)
+                        this->_table[static_cast<size_t>(evicted)].store(-1, std::memory_order_relaxed);
+                    slot.tag.store(block, std::memory_order_relaxed);
+                    for (size_t i = 0; i < BlockSize; i++)
+                        slot.data[i].store(this->_scratch[i], std::memory_order_relaxed);
+                    this->_end_store(slot);
+                    this->_table[static_cast<size_t>(block)].store(static_cast<int32_t>(index), std::memory_order_release);
+                    _count(this->_loads, 1);
+                }
+
+                static void _begin_store(_Slot& slot)
+                {
+                    slot.seq.store(slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                }
+
+                static void _end_store(_Slot& slot)
+                {
+                    slot.seq.store(slot.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+                }
+
+                const size_t _prefetch_blocks;
+                const IndexT _max_length;
+                std::vector<_Slot> _slots;
+                /** The slot holding each block of the file, or -1. */
+                std::vector<std::atomic<int32_t>> _table;
+                /** The last pass that wanted each slot, background thread only. */
+                std::vector<uint64_t> _wanted;
+                uint64_t _pass;
+                /** Whether this pass wanted more blocks than there are slots. */
+                bool _starved;
+                std::array<_Cursor, MaxCursors> _cursors;
+
+                std::unique_ptr<RingBuffer<Sample, QueueSize>> _samples;
+                std::unique_ptr<RingBuffer<_Write, _max_writes>> _writes;
+                /** Background thread's buffer for merged writes and loads. */
+                std::vector<Sample> _scratch;
+
+                const int _file;
+                /** Samples written to the file. */
+                std::atomic<IndexT> _length;
+                /** Samples written or queued, audio thread only. */
+                IndexT _queued_length;
+                /** The last block read that missed, or -1. */
+                std::atomic<IndexT> _miss;
+
+                // counted by the audio thread
+                std::atomic<uint64_t> _hits;
+                std::atomic<uint64_t> _misses;
+                std::atomic<uint64_t> _underruns;
+                std::atomic<uint64_t> _overruns;
+                // counted by the background thread
+                std::atomic<uint64_t> _loads;
+                std::atomic<uint64_t> _io_errors;
+
+                std::atomic<uint64_t> _idle_passes;
+                /** Whether the last idle pass left followed blocks uncached. */
+                std::atomic<bool> _starved_pass;
+                std::atomic<bool> _stop;
+                std::thread _thread;
+        };
+
+    } // namespace looper
+} // namespace idsp
+
+#endif
@@ -48,6 +48,11 @@ namespace idsp
         }
     }//namespace midi
 
+    /** Queues 14-bit MIDI CC messages between two contexts.
+     * The `set_*` methods may be called from one core/thread and the
+     * `get`/`peek` methods from another without locking. The `set_*` methods
+     * return `false` if the queue is full and the message was dropped.
+     */
     class Midi14bitInterface
     {
         public:
@@ -64,39 +69,39 @@ namespace idsp
             {}
 
             /** converts float to midi-compatible message and pops it onto the underlying message queue */
-            inline void set_parameter_value(uint8_t cc_id, float value)
+            inline bool set_parameter_value(uint8_t cc_id, float value)
             {
                 Message message;
                 message.cc = cc_id;
                 message.lsb = midi::float_to_lsb(value);
                 message.msb = midi::float_to_msb(value);
-                message_queue.write(message);
+                return message_queue.write(message);
             }
 
             /** pops an interger message onto the underlying message queue */
-            inline void set_int_value(uint8_t cc_id, uint8_t value)
+            inline bool set_int_value(uint8_t cc_id, uint8_t value)
             {
                 Message message;
                 message.cc = cc_id;
                 message.lsb = 0;
                 message.msb = value & 0x7F;
-                message_queue.write(message);
+                return message_queue.write(message);
             }
 
             /** pops a bool message onto the underlying message queue */
-            inline void set_bool_value(uint8_t cc_id, bool value)
+            inline bool set_bool_value(uint8_t cc_id, bool value)
             {
-                set_int_value(cc_id, value ? 127 : 0);
+                return set_int_value(cc_id, value ? 127 : 0);
             }
 
             /** pops two ints with the same cc onto the underlying message queue */
-            inline void set_two_int_values(uint8_t cc_id, uint16_t value)
+            inline bool set_two_int_values(uint8_t cc_id, uint16_t value)
             {
                 Message message;
                 message.cc = cc_id;
                 message.lsb = midi::int_to_lsb(value);
                 message.msb = midi::int_to_msb(value);
-                message_queue.write(message);
+                return message_queue.write(message);
             }
 
             inline size_t messages_to_read() {return message_queue.data_available();}
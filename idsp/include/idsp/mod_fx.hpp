@@ -6,6 +6,9 @@
 #include "idsp/modulation.hpp"
 #include "idsp/filter.hpp"
 
+#include <algorithm>
+#include <array>
+
 namespace idsp
 {
     class Chorus
@@ -25,16 +28,13 @@ namespace idsp
             }
             void process(const BufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < input.size(); i++)
-                    _process(input[i], output[0][i], output[1][i]);
-
+                _process_block(input.data(), output[0].data(), output[1].data(), input.size());
             }
 
             template<size_t N>
             void process_for(const BufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    _process(input[i], output[0][i], output[1][i]);
+                _process_block(input.data(), output[0].data(), output[1].data(), N);
             }
 
             inline void set_modulation_amount(float f) {modulation_amount = clamp(f, 0.f, 1.f);}
@@ -64,6 +64,42 @@ namespace idsp
 
             private:
 
+            // The taps are always at least 48 samples behind the write index,
+            // so a chunk of up to 44 can be read before it is written
+            void _process_block(const Sample* input, Sample* out_left, Sample* out_right, size_t num_samples)
+            {
+                float blend = idsp::clamp((modulation_amount * 1.5f), 0.f, 1.f);
+                modulation_depth = modulation_amount < 0.25f ? 0 : idsp::rescale(modulation_amount, 0.25f, 1.f, 0.f, 0.5f);
+
+                std::array<float, _block_size> offset_a, offset_b;
+                std::array<Sample, _block_size> dry, chorus, chorus_b;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(num_samples, _block_size);
+                    for(size_t i = 0; i < n; i++)
+                    {
+                        offset_a[i] = (lfo_a.process() * (max_depth * modulation_depth)) + 48;
+                        offset_b[i] = (lfo_b.process() * (max_depth * modulation_depth)) + 48;
+                    }
+                    std::copy_n(input, n, dry.data());
+                    delay->read_offset_smooth_wrap(offset_a.data(), chorus.data(), n);
+                    delay->read_offset_smooth_wrap(offset_b.data(), chorus_b.data(), n);
+                    delay->write(dry.data(), n);
+
+                    for(size_t i = 0; i < n; i++)
+                    {
+                        out_left[i] = interpolate_2(blend, dry[i], (chorus[i] * 0.5f) + (dry[i] * 0.5f));
+                        out_right[i] = interpolate_2(blend, dry[i], (chorus_b[i] * 0.5f) + (dry[i] * 0.5f));
+                    }
+                    input += n;
+                    out_left += n;
+                    out_right += n;
+                    num_samples -= n;
+                }
+            }
+
+            static constexpr size_t _block_size = 44;
+
             float modulation_depth;
 
             float modulation_amount;
@@ -72,7 +108,8 @@ namespace idsp
 
             static constexpr size_t max_depth = 4800;
 
-            Delay<SampleBufferStatic<5280>> delay;
+            // Taps reach at most max_depth / 2 + 48 samples back
+            MaskedDelay<4096, true> delay;
 
             WavetableOscillator<128> lfo_a;
             WavetableOscillator<128> lfo_b;
@@ -256,22 +293,20 @@ namespace idsp
 
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for(size_t i = 0; i < input.size(); i++)
-                    output[i] = _process(input[i]);
+                _process_block(input.data(), output.data(), input.size());
             }
 
             template<size_t N>
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    output[i] = _process(input[i]);
+                _process_block(input.data(), output.data(), N);
             }
 
-            inline void set_modulation_amount(float f) {modulation_amount = f;}
+            inline void set_modulation_amount(float f) {modulation_amount = clamp(f, 0.f, 1.f);}
 
-            inline void set_wow_depth(float f) {wow_depth = f;}
+            inline void set_wow_depth(float f) {wow_depth = max(f, 0.f);}
 
-            inline void set_flutter_depth(float f) {flutter_depth = f;}
+            inline void set_flutter_depth(float f) {flutter_depth = max(f, 0.f);}
 
             inline void set_wow_rate(float f) {wow.set_rate(f*(1.f/sample_rate));}
 
@@ -280,13 +315,53 @@ namespace idsp
         private:
             Sample _process(const Sample input)
              {
-                const float mod_offset = wow_depth + flutter_depth;
-                const Sample mod_value = ((wow.process() * wow_depth) + (flutter.process() * flutter_depth)) * modulation_amount;
-                Sample mod = delay->read_offset_smooth_wrap(mod_offset + mod_value);
+                Sample mod = delay->read_offset_smooth_wrap(_next_offset());
                 Sample output = interpolate_2((modulation_amount/2.f), input, mod);
                 delay->write(input);
                 return output;
             }
+
+            // Deep modulation can bring the tap right up to the write index,
+            // in which case the chunk falls back to per-sample reads and writes
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<float, _block_size> offsets;
+                std::array<Sample, _block_size> dry, mod;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(num_samples, _block_size);
+                    for(size_t i = 0; i < n; i++)
+                        offsets[i] = _next_offset();
+                    std::copy_n(input, n, dry.data());
+                    if(delay->can_read_block(offsets.data(), n))
+                    {
+                        delay->read_offset_smooth_wrap(offsets.data(), mod.data(), n);
+                        delay->write(dry.data(), n);
+                    }
+                    else
+                    {
+                        for(size_t i = 0; i < n; i++)
+                        {
+                            mod[i] = delay->read_offset_smooth_wrap(offsets[i]);
+                            delay->write(dry[i]);
+                        }
+                    }
+                    for(size_t i = 0; i < n; i++)
+                        output[i] = interpolate_2((modulation_amount/2.f), dry[i], mod[i]);
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
+            }
+
+            inline float _next_offset()
+            {
+                const float mod_offset = wow_depth + flutter_depth;
+                const float mod_value = ((wow.process() * wow_depth) + (flutter.process() * flutter_depth)) * modulation_amount;
+                return mod_offset + mod_value;
+            }
+
+            static constexpr size_t _block_size = 32;
             float wow_depth;
             float flutter_depth;
             float wow_rate;
@@ -294,7 +369,7 @@ namespace idsp
             float modulation_amount;
             float sample_rate;
 
-            Delay<SampleBufferStatic<3000>> delay;
+            MaskedDelay<4096, true> delay;
             WavetableOscillator<128> wow;
             WavetableOscillator<128> flutter;
     };
@@ -1,8 +1,12 @@
 #ifndef IDSP_OSCILLATOR_H
 #define IDSP_OSCILLATOR_H
 
+#include "idsp/buffer_interface.hpp"
 #include "idsp/lookup.hpp"
 
+#include <array>
+#include <cstdint>
+
 namespace idsp
 {
     enum class Waveform
@@ -16,7 +20,7 @@ namespace idsp
 
     class RawOscillator
     {
-        using Generator = Sample (*)(Sample);
+        using Generator = Sample (*)(SampleParameter);
 
         public:
             constexpr
@@ -35,24 +39,24 @@ namespace idsp
                     switch (waveform)
                     {
                         case Waveform::sine:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return std::sin(p * twopi);
                             };
                         case Waveform::triangle:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return rescale(std::abs(p - 0.5f), 0.f, 0.5f, -1.f, 1.f);
                             };
                         case Waveform::square:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return p < 0.5f ? 1.f : -1.f;
                             };
                         case Waveform::sawtooth:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return rescale(p, 0.f, 1.f, 1.f, -1.f);
                             };
                         default:
                         case Waveform::ramp:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return rescale(p, 0.f, 1.f, -1.f, 1.f);
                             };
                     }
@@ -62,24 +66,24 @@ namespace idsp
                     switch (waveform)
                     {
                         case Waveform::sine:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return rescale(std::sin(p * twopi), -1.f, 1.f, 0.f, 1.f);
                             };
                         case Waveform::triangle:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return std::abs(p - 0.5f) * 2.f;
                             };
                         case Waveform::square:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return p < 0.5f ? 1.f : 0.f;
                             };
                         case Waveform::sawtooth:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return -p;
                             };
                         default:
                         case Waveform::ramp:
-                            return [](Sample p) -> Sample {
+                            return [](SampleParameter p) -> Sample {
                                 return p;
                             };
                     }
@@ -92,7 +96,7 @@ namespace idsp
             {
                 this->_phase += this->_rate;
                 this->_phase = wrap(this->_phase);
-                return this->_generator(this->_phase);
+                return static_cast<float>(this->_generator(this->_phase));
             }
 
             IDSP_CONSTEXPR_SINCE_CXX14
@@ -122,58 +126,141 @@ namespace idsp
             Generator _generator;
     };
 
+    /** Constexpr generators for the standard waveforms, one period over
+     * [0, 1), so their tables can be built at compile time. */
+    namespace waveforms
+    {
+        IDSP_CONSTEXPR_SINCE_CXX14 Sample sine_bipolar(SampleParameter p)
+        {
+            return idsp::sin_accurate(p * twopi);
+        }
+
+        IDSP_CONSTEXPR_SINCE_CXX14 Sample triangle_bipolar(SampleParameter p)
+        {
+            if (p < 0.75f)
+            {
+                const float d = p - 0.25f;
+                return rescale(1.f - 2.f * (d < 0 ? -d : d), 0.f, 1.f, -1.f, 1.f);
+            }
+            else return rescale((2.f * (p - 0.75f)), 0.f, 1.f, -1.f, 1.f);
+        }
+
+        constexpr Sample square_bipolar(SampleParameter p)
+        {
+            return p < 0.5f ? 1.f : -1.f;
+        }
+
+        constexpr Sample sawtooth_bipolar(SampleParameter p)
+        {
+            return rescale(p, 0.f, 1.f, 1.f, -1.f);
+        }
+
+        constexpr Sample ramp_bipolar(SampleParameter p)
+        {
+            return rescale(p, 0.f, 1.f, -1.f, 1.f);
+        }
+
+        IDSP_CONSTEXPR_SINCE_CXX14 Sample sine_unipolar(SampleParameter p)
+        {
+            return rescale(idsp::sin_accurate(p * twopi), -1.f, 1.f, 0.f, 1.f);
+        }
+
+        IDSP_CONSTEXPR_SINCE_CXX14 Sample triangle_unipolar(SampleParameter p)
+        {
+            if (p < 0.75f)
+            {
+                const float d = p - 0.25f;
+                return 1.f - 2.f * (d < 0 ? -d : d);
+            }
+            else return 2.f * (p - 0.75f);
+        }
+
+        constexpr Sample square_unipolar(SampleParameter p)
+        {
+            return p < 0.5f ? 1.f : 0.f;
+        }
+
+        constexpr Sample sawtooth_unipolar(SampleParameter p)
+        {
+            return 1.f - p;
+        }
+
+        constexpr Sample ramp_unipolar(SampleParameter p)
+        {
+            return p;
+        }
+
+        /** @returns The generator of @a waveform, usable as a template
+         * argument when the arguments are constants. */
+        IDSP_CONSTEXPR_SINCE_CXX14 Sample (*generator(Waveform waveform, bool bipolar))(SampleParameter)
+        {
+            switch (waveform)
+            {
+                default:
+                case Waveform::sine: return bipolar ? sine_bipolar : sine_unipolar;
+                case Waveform::triangle: return bipolar ? triangle_bipolar : triangle_unipolar;
+                case Waveform::square: return bipolar ? square_bipolar : square_unipolar;
+                case Waveform::sawtooth: return bipolar ? sawtooth_bipolar : sawtooth_unipolar;
+                case Waveform::ramp: return bipolar ? ramp_bipolar : ramp_unipolar;
+            }
+        }
+    } // namespace waveforms
+
+    /** Mipmapped tables are built from their generator on first use. */
+    template<size_t Size, size_t Levels>
+    struct _SharedWavetableStorage
+    {
+        template<Sample (*Generator)(SampleParameter)>
+        static const MipmappedWavetable<Size, Levels>& get()
+        {
+            static const MipmappedWavetable<Size, Levels> table {LookupTable<Sample, Size>(Generator)};
+            return table;
+        }
+    };
+
+    /** Single-level tables are constant-initialised, so they are read-only
+     * data (flash on the RP2040) and never built at runtime. */
     template<size_t Size>
-    class WavetableOscillator
+    struct _SharedWavetableStorage<Size, 1>
     {
-        using Generator = Sample (*)(Sample);
-        using Wavetable = LookupTable<Sample, Size>;
+        template<Sample (*Generator)(SampleParameter)>
+        static const MipmappedWavetable<Size, 1>& get()
+        {
+            static constexpr MipmappedWavetable<Size, 1> table {LookupTable<Sample, Size>(Generator)};
+            return table;
+        }
+    };
 
-        public:
-            WavetableOscillator(const Wavetable& table):
-            _rate{0},
-            _phase{0},
-            _offset{0},
-            _table{table}
-            {}
+    /** One table per standard waveform, size and level count, shared by
+     * every oscillator that uses it instead of each holding its own copy.
+     */
+    template<size_t Size, size_t Levels = 1>
+    class SharedWavetable
+    {
+        using Storage = _SharedWavetableStorage<Size, Levels>;
 
-            WavetableOscillator(Wavetable&& table):
-            _rate{0},
-            _phase{0},
-            _offset{0},
-            _table{table}
-            {}
+        public:
+            using Table = MipmappedWavetable<Size, Levels>;
 
-            WavetableOscillator(Generator generator):
-            WavetableOscillator(Wavetable(generator)) {}
+            /** @returns The table of a waveform known at compile time. */
+            template<Waveform W, bool Bipolar>
+            static const Table& get()
+            {
+                return Storage::template get<waveforms::generator(W, Bipolar)>();
+            }
 
-            WavetableOscillator(Waveform waveform, bool bipolar):
-            WavetableOscillator([waveform, bipolar]() -> Generator {
+            static const Table& get(Waveform waveform, bool bipolar)
+            {
                 if (bipolar)
                 {
                     switch (waveform)
                     {
                         default:
-                        case Waveform::sine:
-                            return [](Sample p) -> Sample {
-                                return std::sin(p * twopi);
-                            };
-                        case Waveform::triangle:
-                            return [](Sample p) -> Sample {
-                                if (p < 0.75f) return rescale(1.f - 2.f * std::abs(p - 0.25f), 0.f, 1.f, -1.f, 1.f);
-                                else return rescale((2.f * (p - 0.75f)), 0.f, 1.f, -1.f, 1.f);
-                            };
-                        case Waveform::square:
-                            return [](Sample p) -> Sample {
-                                return p < 0.5f ? 1.f : -1.f;
-                            };
-                        case Waveform::sawtooth:
-                            return [](Sample p) -> Sample {
-                                return rescale(p, 0.f, 1.f, 1.f, -1.f);
-                            };
-                        case Waveform::ramp:
-                            return [](Sample p) -> Sample {
-                                return rescale(p, 0.f, 1.f, -1.f, 1.f);
-                            };
+                        case Waveform::sine: return Storage::template get<waveforms::sine_bipolar>();
+                        case Waveform::triangle: return Storage::template get<waveforms::triangle_bipolar>();
+                        case Waveform::square: return Storage::template get<waveforms::square_bipolar>();
+                        case Waveform::sawtooth: return Storage::template get<waveforms::sawtooth_bipolar>();
+                        case Waveform::ramp: return Storage::template get<waveforms::ramp_bipolar>();
                     }
                 }
                 else
@@ -181,30 +268,44 @@ namespace idsp
                     switch (waveform)
                     {
                         default:
-                        case Waveform::sine:
-                            return [](Sample p) -> Sample {
-                                return rescale(std::sin(p * twopi), -1.f, 1.f, 0.f, 1.f);
-                            };
-                        case Waveform::triangle:
-                            return [](Sample p) -> Sample {
-                                if (p < 0.75f) return 1.f - 2.f * std::abs(p - 0.25f);
-                                else return 2.f * (p - 0.75f);
-                            };
-                        case Waveform::square:
-                            return [](Sample p) -> Sample {
-                                return p < 0.5f ? 1.f : 0.f;
-                            };
-                        case Waveform::sawtooth:
-                            return [](Sample p) -> Sample {
-                                return 1.f - p;
-                            };
-                        case Waveform::ramp:
-                            return [](Sample p) -> Sample {
-                                return p;
-                            };
+                        case Waveform::sine: return Storage::template get<waveforms::sine_unipolar>();
+                        case Waveform::triangle: return Storage::template get<waveforms::triangle_unipolar>();
+                        case Waveform::square: return Storage::template get<waveforms::square_unipolar>();
+                        case Waveform::sawtooth: return Storage::template get<waveforms::sawtooth_unipolar>();
+                        case Waveform::ramp: return Storage::template get<waveforms::ramp_unipolar>();
                     }
                 }
-            }()) {}
+            }
+    };
+
+    /** Wavetable oscillator.
+     * With @a Levels > 1 the table is mipmapped (see MipmappedWavetable) and
+     * each rate reads the richest band-limited level that doesn't alias, so
+     * saw, square and ramp stay clean at audio rates without oversampling.
+     * The level is picked by set_rate(), so it is fixed within a block.
+     * The default of one level reads the table as given, e.g. for LFOs.
+     *
+     * The oscillator only references its table, so any number of them can
+     * share one; the standard waveforms come from SharedWavetable.
+     */
+    template<size_t Size, size_t Levels = 1>
+    class WavetableOscillator
+    {
+        public:
+            using Table = MipmappedWavetable<Size, Levels>;
+
+            /** References @a table, which must outlive the oscillator. */
+            constexpr
+            WavetableOscillator(const Table& table):
+            _rate{0},
+            _phase{0},
+            _offset{0},
+            _level{0},
+            _table{&table}
+            {}
+
+            WavetableOscillator(Waveform waveform, bool bipolar):
+            WavetableOscillator(SharedWavetable<Size, Levels>::get(waveform, bipolar)) {}
 
             template<size_t N>
             void process_for(BufferInterface& output)
@@ -217,20 +318,23 @@ namespace idsp
             {
                 this->_phase += this->_rate;
                 this->_phase = wrap(this->_phase);
-                return this->_table.read(this->_phase);
+                return static_cast<float>(this->_table->read(this->_level, this->_phase));
             }
 
             inline float process_oneshot()
             {
                 this->_phase += this->_rate;
-                if (this->_phase >= 1.f) return this->_table.read(1.f);
-                else return this->_table.read(this->_phase);
+                if (this->_phase >= 1.f) return static_cast<float>(this->_table->read(this->_level, 1.f));
+                else return static_cast<float>(this->_table->read(this->_level, this->_phase));
             }
 
+            /** Sets the rate in cycles per sample and picks the table level
+             * for it. */
             IDSP_CONSTEXPR_SINCE_CXX14
             void set_rate(float rate)
             {
                 this->_rate = rate;
+                this->_level = MipmappedWavetable<Size, Levels>::select_level(rate);
             }
 
             IDSP_CONSTEXPR_SINCE_CXX14
@@ -258,8 +362,365 @@ namespace idsp
             float _rate;
             float _phase;
             float _offset;
-            Wavetable _table;
+            size_t _level;
+            const Table* _table;
+    };
+    /** Bank of N single-level wavetable oscillators stored as structure of
+     * arrays, for LFO-heavy effects, modulation matrices and voice banks.
+     * Each lane has its own rate, phase offset and table, and produces
+     * exactly what a WavetableOscillator with the same settings would.
+     * The block processors advance the phases of all lanes together, which
+     * vectorises, and then read each lane's table into its output channel.
+     */
+    template<size_t N, size_t Size = 128>
+    class OscillatorBank
+    {
+        static_assert(N > 0, "OscillatorBank needs at least one oscillator.");
+
+        /** Frames of phases computed per pass in the block processors. */
+        static constexpr size_t _tile_size = 16;
+
+        public:
+            using Table = MipmappedWavetable<Size, 1>;
+
+            OscillatorBank(Waveform waveform, bool bipolar)
+            {
+                this->_rate.fill(0.f);
+                this->_phase.fill(0.f);
+                this->_offset.fill(0.f);
+                for (size_t n = 0; n < N; n++)
+                    this->set_waveform(n, waveform, bipolar);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~OscillatorBank() = default;
+
+            /** Makes oscillator @a n read one of the shared standard
+             * waveforms. */
+            void set_waveform(size_t n, Waveform waveform, bool bipolar)
+            {
+                this->set_table(n, SharedWavetable<Size>::get(waveform, bipolar));
+            }
+
+            /** Makes oscillator @a n read @a table, which must outlive the
+             * bank. */
+            void set_table(size_t n, const Table& table)
+            {
+                this->_tables[n] = table.table(0).data();
+            }
+
+            /** Sets the rate of oscillator @a n in cycles per sample.
+             * @note Rates must lie in (-1, 1).
+             */
+            void set_rate(size_t n, float rate)
+            {
+                this->_rate[n] = rate;
+            }
+
+            /** Sets the rate of every oscillator. */
+            void set_rate(float rate)
+            {
+                this->_rate.fill(rate);
+            }
+
+            void set_phase(size_t n, float phase)
+            {
+                this->_phase[n] = idsp::wrap(phase + this->_offset[n]);
+            }
+
+            float get_phase(size_t n) const
+            {
+                return this->_phase[n];
+            }
+
+            void set_phase_offset(size_t n, float offset)
+            {
+                const float raw_phase = idsp::wrap(this->_phase[n] - this->_offset[n]);
+                this->_phase[n] = idsp::wrap(raw_phase + offset);
+                this->_offset[n] = offset;
+            }
+
+            /** Frame processor: writes the next sample of each of the N
+             * oscillators to @a output. */
+            void process(Sample* output)
+            {
+                this->_advance();
+                for (size_t n = 0; n < N; n++)
+                    output[n] = this->_read(n, this->_phase[n]);
+            }
+
+            /** Block processor: fills channel n of @a output with
+             * oscillator n.
+             * @note @a output must have at least N channels.
+             */
+            void process(PolyBufferInterface& output)
+            {
+                this->_process_block(output, output.data_size());
+            }
+
+            template<size_t Bs>
+            void process_for(PolyBufferInterface& output)
+            {
+                this->_process_block(output, Bs);
+            }
+
+        private:
+            // Branch-free equivalent of wrap() for rates in (-1, 1), so the
+            // loop over lanes vectorises
+            inline void _advance()
+            {
+                for (size_t n = 0; n < N; n++)
+                {
+                    float phase = this->_phase[n] + this->_rate[n];
+                    phase -= phase >= 1.f ? 1.f : 0.f;
+                    phase += phase < 0.f ? 1.f : 0.f;
+                    this->_phase[n] = phase;
+                }
+            }
+
+            // Same interpolation as MipmappedWavetable::read()
+            inline Sample _read(size_t n, float phase) const
+            {
+                const float scaled = phase * static_cast<float>(Size - 1);
+                const size_t ind = static_cast<size_t>(scaled);
+                const float frac = scaled - static_cast<float>(ind);
+                return idsp::interpolate_2(frac, this->_tables[n][ind], this->_tables[n][ind + 1]);
+            }
+
+            void _process_block(PolyBufferInterface& output, size_t num_frames)
+            {
+                std::array<std::array<float, N>, _tile_size> tile;
+                for (size_t start = 0; start < num_frames; start += _tile_size)
+                {
+                    const size_t size = idsp::min(_tile_size, num_frames - start);
+                    for (size_t i = 0; i < size; i++)
+                    {
+                        this->_advance();
+                        tile[i] = this->_phase;
+                    }
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        Sample* out = output[n].data() + start;
+                        for (size_t i = 0; i < size; i++)
+                            out[i] = this->_read(n, tile[i][n]);
+                    }
+                }
+            }
+
+            alignas(16) std::array<float, N> _rate;
+            alignas(16) std::array<float, N> _phase;
+            alignas(16) std::array<float, N> _offset;
+            std::array<const Sample*, N> _tables;
+    };
+    /** 32-bit fixed-point phase, where a full cycle is 2^32.
+     * Wrapping comes free from unsigned overflow, so advancing costs one
+     * integer add, and the top bits can index a power-of-two table
+     * directly. Negative rates work through the same overflow.
+     */
+    class PhaseAccumulator
+    {
+        public:
+            constexpr PhaseAccumulator():
+            _phase{0},
+            _increment{0},
+            _offset{0}
+            {}
+
+            /** @returns @a x cycles as a 32-bit phase, wrapped.
+             * @note |x| must be below 2^31.
+             */
+            static constexpr uint32_t from_float(float x)
+            {
+                return static_cast<uint32_t>(static_cast<int64_t>(x * 4294967296.f));
+            }
+
+            /** @returns @a phase in cycles, in [0, 1). Uses the top 24 bits,
+             * which a float holds exactly. */
+            static constexpr float to_float(uint32_t phase)
+            {
+                return static_cast<float>(phase >> 8) * (1.f / 16777216.f);
+            }
+
+            /** Advances by one sample. @returns The new phase. */
+            inline uint32_t advance()
+            {
+                this->_phase += this->_increment;
+                return this->_phase;
+            }
+
+            constexpr uint32_t get() const
+            {
+                return this->_phase;
+            }
+
+            /** Sets the rate in cycles per sample. */
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_rate(float rate)
+            {
+                this->_increment = from_float(rate);
+            }
+
+            /** Sets the rate as a raw increment, avoiding any float work. */
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_increment(uint32_t increment)
+            {
+                this->_increment = increment;
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase(float phase)
+            {
+                this->_phase = from_float(phase) + this->_offset;
+            }
+
+            constexpr float get_phase() const
+            {
+                return to_float(this->_phase);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase_offset(float offset)
+            {
+                const uint32_t new_offset = from_float(offset);
+                this->_phase = this->_phase - this->_offset + new_offset;
+                this->_offset = new_offset;
+            }
+
+        private:
+            uint32_t _phase;
+            uint32_t _increment;
+            uint32_t _offset;
+    };
+
+    /** RawOscillator with an integer phase accumulator and the waveform
+     * fixed at compile time, so the generator is inlined instead of called
+     * through a pointer and the phase never needs floor().
+     */
+    template<Waveform W, bool Bipolar>
+    class FixedRawOscillator
+    {
+        public:
+            inline float process()
+            {
+                return _generate(PhaseAccumulator::to_float(this->_phase.advance()));
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                for (size_t i = 0; i < N; i++)
+                    output[i] = this->process();
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_rate(float rate)
+            {
+                this->_phase.set_rate(rate);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase(float phase)
+            {
+                this->_phase.set_phase(phase);
+            }
+
+            constexpr float get_phase() const
+            {
+                return this->_phase.get_phase();
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase_offset(float offset)
+            {
+                this->_phase.set_phase_offset(offset);
+            }
+
+        private:
+            // Same shapes as RawOscillator; the branches fold away
+            static inline float _generate(float p)
+            {
+                switch (W)
+                {
+                    default:
+                    case Waveform::sine:
+                        return Bipolar ? std::sin(p * twopi) : rescale(std::sin(p * twopi), -1.f, 1.f, 0.f, 1.f);
+                    case Waveform::triangle:
+                        return Bipolar ? rescale(std::abs(p - 0.5f), 0.f, 0.5f, -1.f, 1.f) : std::abs(p - 0.5f) * 2.f;
+                    case Waveform::square:
+                        return p < 0.5f ? 1.f : (Bipolar ? -1.f : 0.f);
+                    case Waveform::sawtooth:
+                        return Bipolar ? rescale(p, 0.f, 1.f, 1.f, -1.f) : -p;
+                    case Waveform::ramp:
+                        return Bipolar ? rescale(p, 0.f, 1.f, -1.f, 1.f) : p;
+                }
+            }
+
+            PhaseAccumulator _phase;
     };
+
+    /** WavetableOscillator with an integer phase accumulator: the top
+     * @a Bits of the phase index the table directly and the bits below
+     * them are the interpolation fraction. The waveform is fixed at compile
+     * time, so the shared constexpr table's address is a constant.
+     * The table has 2^Bits + 1 points, the last repeating the first.
+     */
+    template<Waveform W, bool Bipolar, size_t Bits = 7>
+    class FixedWavetableOscillator
+    {
+        static_assert(Bits > 0 && Bits <= 24, "Table index must leave room for the fraction.");
+
+        public:
+            static constexpr size_t table_size = (size_t(1) << Bits) + 1;
+
+            inline float process()
+            {
+                const uint32_t phase = this->_phase.advance();
+                const uint32_t ind = phase >> (32 - Bits);
+                const float frac = PhaseAccumulator::to_float(phase << Bits);
+                const auto& table = SharedWavetable<table_size>::template get<W, Bipolar>().table(0);
+                return static_cast<float>(idsp::interpolate_2(frac, table[ind], table[ind + 1]));
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                for (size_t i = 0; i < N; i++)
+                    output[i] = this->process();
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_rate(float rate)
+            {
+                this->_phase.set_rate(rate);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_increment(uint32_t increment)
+            {
+                this->_phase.set_increment(increment);
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase(float phase)
+            {
+                this->_phase.set_phase(phase);
+            }
+
+            constexpr float get_phase() const
+            {
+                return this->_phase.get_phase();
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX14
+            void set_phase_offset(float offset)
+            {
+                this->_phase.set_phase_offset(offset);
+            }
+
+        private:
+            PhaseAccumulator _phase;
+    };
+
 } // namespace idsp
 
 #endif
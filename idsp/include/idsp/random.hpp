@@ -3,33 +3,155 @@
 
 #include "idsp/oscillator.hpp"
 
-#include <random>
+#include <array>
+#include <cstdint>
 
 namespace idsp
 {
-    /** White Noise - uniform distribution */
-    class WhiteNoise
+    /** xoshiro128+ pseudo-random generator: 16 bytes of state and a
+     * handful of 32-bit integer operations per number.
+     * The same seed always gives the same sequence. Its top bits are the
+     * strongest, so the float conversions use those.
+     * Satisfies UniformRandomBitGenerator, so it also drives the standard
+     * distributions.
+     */
+    class Xoshiro128
     {
         public:
+            using result_type = uint32_t;
+
+            /** Seeds from the next value of a global sequence, so instances
+             * differ from each other but a program built the same way
+             * always gets the same streams.
+             * @note Not thread-safe; construct generators from one core.
+             */
+            Xoshiro128():
+            Xoshiro128(_next_seed())
+            {}
+
+            explicit Xoshiro128(uint32_t seed)
+            {
+                this->seed(seed);
+            }
+
+            /** Restarts the sequence from @a seed, expanded into the full
+             * state with splitmix32 so that nearby seeds are unrelated. */
+            void seed(uint32_t seed)
+            {
+                for (auto& s : this->_state)
+                    s = _splitmix(seed);
+            }
+
+            inline uint32_t operator()()
+            {
+                const uint32_t result = this->_state[0] + this->_state[3];
+                const uint32_t t = this->_state[1] << 9;
+                this->_state[2] ^= this->_state[0];
+                this->_state[3] ^= this->_state[1];
+                this->_state[1] ^= this->_state[2];
+                this->_state[0] ^= this->_state[3];
+                this->_state[2] ^= t;
+                this->_state[3] = (this->_state[3] << 11) | (this->_state[3] >> 21);
+                return result;
+            }
+
+            /** @returns The top 24 bits of @a x as a float in [0, 1). */
+            static constexpr float to_positive(uint32_t x)
+            {
+                return static_cast<float>(x >> 8) * (1.f / 16777216.f);
+            }
+
+            /** @returns The top 24 bits of @a x as a float in [-1, 1). */
+            static constexpr float to_bipolar(uint32_t x)
+            {
+                return to_positive(x) * 2.f - 1.f;
+            }
+
+            inline float positive()
+            {
+                return to_positive((*this)());
+            }
+
+            inline float bipolar()
+            {
+                return to_bipolar((*this)());
+            }
+
+            static constexpr uint32_t min() { return 0; }
+            static constexpr uint32_t max() { return UINT32_MAX; }
 
-            WhiteNoise()
+        private:
+            static uint32_t _splitmix(uint32_t& x)
+            {
+                uint32_t z = (x += 0x9e3779b9u);
+                z = (z ^ (z >> 16)) * 0x85ebca6bu;
+                z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+                return z ^ (z >> 16);
+            }
+
+            static uint32_t _next_seed()
             {
-                randomiser = std::mt19937(random_device());
-                distribution = std::uniform_real_distribution<float>(0.f, 1.f);
+                static uint32_t sequence = 0x2545f491u;
+                return _splitmix(sequence);
             }
 
+            std::array<uint32_t, 4> _state;
+    };
+
+    /** White Noise - uniform distribution */
+    class WhiteNoise
+    {
+        /** Random numbers drawn per pass in the block processors. */
+        static constexpr size_t _tile_size = 32;
+
+        public:
+            WhiteNoise() = default;
+
+            explicit WhiteNoise(uint32_t seed):
+            randomiser{seed}
+            {}
+
+            /** Restarts the noise sequence from @a seed. */
+            inline void seed(uint32_t seed) { randomiser.seed(seed); }
+
             inline float positive() {
-                return distribution(randomiser);
+                return randomiser.positive();
             }
 
             inline float bipolar() {
-                return (distribution(randomiser) * 2.f) - 1.f;
+                return randomiser.bipolar();
+            }
+
+            /** Block processor: fills @a output with bipolar noise, the same
+             * samples that successive bipolar() calls would give. */
+            void process(BufferInterface& output)
+            {
+                this->_process_block(output.data(), output.size());
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                this->_process_block(output.data(), N);
             }
 
         private:
-            std::random_device random_device;
-            std::mt19937 randomiser;
-            std::uniform_real_distribution<float> distribution;
+            // The generator is serial, so draw a tile of integers first and
+            // then convert them in a loop that vectorises
+            void _process_block(Sample* output, size_t size)
+            {
+                std::array<uint32_t, _tile_size> raw;
+                for (size_t start = 0; start < size; start += _tile_size)
+                {
+                    const size_t n = idsp::min(_tile_size, size - start);
+                    for (size_t i = 0; i < n; i++)
+                        raw[i] = randomiser();
+                    for (size_t i = 0; i < n; i++)
+                        output[start + i] = Sample(Xoshiro128::to_bipolar(raw[i]));
+                }
+            }
+
+            Xoshiro128 randomiser;
     };
 
     /** Pink Noise - -3db per octave */
@@ -38,6 +160,12 @@ namespace idsp
         public:
             PinkNoise() = default;
 
+            explicit PinkNoise(uint32_t seed):
+            white_noise{seed}
+            {}
+
+            inline void seed(uint32_t seed) { white_noise.seed(seed); }
+
             constexpr
             inline float positive() { return (bipolar() + 1.f) * 0.5f; }
 
@@ -50,19 +178,39 @@ namespace idsp
                     frame = 0;
                 int diff = lastFrame ^ frame;
 
-                float pink = 0.f;
-                for (size_t i = 0; i < QUALITY; i++) {
-                    if (diff & (1 << i)) {
-                        values[i] = white_noise.positive() - 0.5f;
-                    }
-                    pink += values[i];
+                // The changed rows are always the lowest ones, so update them
+                // and keep a running sum, recomputed exactly once a cycle
+                for (size_t i = 0; i < QUALITY && (diff & (1 << i)); i++) {
+                    const float value = white_noise.positive() - 0.5f;
+                    pink += value - values[i];
+                    values[i] = value;
+                }
+                if (frame == 0) {
+                    pink = 0.f;
+                    for (size_t i = 0; i < QUALITY; i++)
+                        pink += values[i];
                 }
                 return clamp((pink*0.5f), -1.f, 1.f);
             }
 
+            /** Block processor: fills @a output with bipolar noise. */
+            void process(BufferInterface& output)
+            {
+                for (size_t i = 0; i < output.size(); i++)
+                    output[i] = this->bipolar();
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                for (size_t i = 0; i < N; i++)
+                    output[i] = this->bipolar();
+            }
+
         private:
             static constexpr size_t QUALITY = 8;
             int frame = -1;
+            float pink = 0.f;
             std::array<float, QUALITY> values{0};
             WhiteNoise white_noise;
     };
@@ -74,6 +222,12 @@ namespace idsp
 
             BlueNoise() = default;
 
+            explicit BlueNoise(uint32_t seed):
+            pink_noise{seed}
+            {}
+
+            inline void seed(uint32_t seed) { pink_noise.seed(seed); }
+
             constexpr
             inline float positive() { return (bipolar() + 1.f) * 0.5f; }
 
@@ -85,10 +239,24 @@ namespace idsp
                 return clamp(blue, -1.f, 1.f);
             }
 
+            /** Block processor: fills @a output with bipolar noise. */
+            void process(BufferInterface& output)
+            {
+                for (size_t i = 0; i < output.size(); i++)
+                    output[i] = this->bipolar();
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                for (size_t i = 0; i < N; i++)
+                    output[i] = this->bipolar();
+            }
+
         private:
             PinkNoise pink_noise;
-            float new_value;
-            float last_value;
+            float new_value = 0.f;
+            float last_value = 0.f;
     };
 
     class NoiseSource
@@ -106,6 +274,15 @@ namespace idsp
             noise_colour{Colour::white}
             {}
 
+            /** Seeds the three generators from @a seed, so the output
+             * depends only on the seed and the colours used. */
+            explicit NoiseSource(uint32_t seed) :
+            white_noise{seed},
+            pink_noise{seed + 1},
+            blue_noise{seed + 2},
+            noise_colour{Colour::white}
+            {}
+
             constexpr
             inline float positive()
             {
@@ -152,6 +329,47 @@ namespace idsp
                 }
             }
 
+            /** Block processor: fills @a output with bipolar noise of the
+             * current colour, choosing the colour once per block. */
+            void process(BufferInterface& output)
+            {
+                switch (noise_colour)
+                {
+                    case Colour::pink:
+                        pink_noise.process(output);
+                    break;
+
+                    case Colour::blue:
+                        blue_noise.process(output);
+                    break;
+
+                    case Colour::white:
+                    default:
+                        white_noise.process(output);
+                    break;
+                }
+            }
+
+            template<size_t N>
+            void process_for(BufferInterface& output)
+            {
+                switch (noise_colour)
+                {
+                    case Colour::pink:
+                        pink_noise.process_for<N>(output);
+                    break;
+
+                    case Colour::blue:
+                        blue_noise.process_for<N>(output);
+                    break;
+
+                    case Colour::white:
+                    default:
+                        white_noise.process_for<N>(output);
+                    break;
+                }
+            }
+
             constexpr
             inline void set_noise_colour(Colour colour) {noise_colour = colour;}
 
@@ -0,0 +1,148 @@
+#ifndef IDSP_RESAMPLER_H
+#define IDSP_RESAMPLER_H
+
+#include "idsp/constants.hpp"
+#include "idsp/functions.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace idsp
+{
+
+/** Polyphase windowed-sinc interpolator, a higher quality alternative to the
+ * 4-point reads of @ref AudioRingBuffer for pitched playback.
+ * @a Taps sets the quality tier: 4, 8, 16 or 32 points per read at level 0.
+ * Each of the @a Levels levels is band-limited for one octave of read rate,
+ * like the levels of @ref MipmappedWavetable: level k passes content below
+ * 1 / 2^k of the source Nyquist and spans Taps << k points, so reads faster
+ * than the source rate are filtered instead of aliasing, at the same
+ * relative quality and twice the cost per octave.
+ * A level stores the kernel at @a Phases + 1 fractional offsets, and a read
+ * blends the two rows either side of its fraction. The tables are built at
+ * construction, so build it before audio starts and share it between
+ * readers; with the defaults the 32-tap tier holds about 115 KB.
+ */
+template<size_t Taps, size_t Phases = 128, size_t Levels = 3>
+class SincInterpolator
+{
+    static_assert(Taps == 4 || Taps == 8 || Taps == 16 || Taps == 32, "SincInterpolator has 4, 8, 16 and 32-tap tiers.");
+    static_assert(Phases > 0, "SincInterpolator needs at least one phase.");
+    static_assert(Levels > 0, "SincInterpolator needs at least one level.");
+
+    public:
+        /** Points read at level 0 and at the last level. */
+        static constexpr size_t taps = Taps;
+        static constexpr size_t max_taps = Taps << (Levels - 1);
+
+        /** Cutoff of level 0, where its response is halved, as a fraction
+         * of Nyquist. */
+        static constexpr float cutoff = 0.9f;
+
+        SincInterpolator()
+        {
+            for (size_t level = 0; level < Levels; level++)
+                this->_build(level);
+        }
+
+        /** @returns The points read at @a level. */
+        static constexpr size_t level_taps(size_t level) {return Taps << level;}
+
+        /** @returns The points a read at @a level needs before and after its
+         * integer index: a read at index i spans [i - before, i + after]. */
+        static constexpr size_t before(size_t level) {return level_taps(level) / 2 - 1;}
+        static constexpr size_t after(size_t level) {return level_taps(level) / 2;}
+
+        /** @returns The lowest level that doesn't alias when the source is
+         * read at @a ratio samples per output sample, or the last level. */
+        IDSP_CONSTEXPR_SINCE_CXX14
+        static size_t select_level(float ratio)
+        {
+            const float magnitude = ratio < 0.f ? -ratio : ratio;
+            size_t level = 0;
+            while (level + 1 < Levels && static_cast<float>(1 << level) < magnitude)
+                level++;
+            return level;
+        }
+
+        /** Reads between data[0] and data[1] at @a fraction, [0:1).
+         * data[-before(level)] to data[after(level)] must be readable. */
+        inline Sample read(size_t level, const Sample* data, float fraction) const
+        {
+            const size_t n = level_taps(level);
+            const float scaled = fraction * static_cast<float>(Phases);
+            // an int cast converts faster than a size_t one
+            const size_t row = min(static_cast<size_t>(static_cast<int>(scaled)), Phases - 1);
+            const Sample blend = Sample(scaled - static_cast<float>(row));
+            const Sample* w0 = this->_table.data() + _offset(level) + row * n;
+            const Sample* w1 = w0 + n;
+            const Sample* x = data - before(level);
+            // four partial sums per row, so the products vectorise
+            std::array<Sample, 4> a{}, b{};
+            for (size_t k = 0; k < n; k += 4)
+            {
+                for (size_t j = 0; j < 4; j++)
+                {
+                    a[j] += w0[k + j] * x[k + j];
+                    b[j] += w1[k + j] * x[k + j];
+                }
+            }
+            const Sample a_sum = (a[0] + a[1]) + (a[2] + a[3]);
+            const Sample b_sum = (b[0] + b[1]) + (b[2] + b[3]);
+            return a_sum + blend * (b_sum - a_sum);
+        }
+
+        /** Block form of read(): output[i] is the read at @a positions[i],
+         * where position @a start is data[0]. Positions must not be negative,
+         * and must keep their points readable. The start is taken off the
+         * whole part of each position, so the fractions stay exact. */
+        inline void read(size_t level, const Sample* data, long int start, const float* positions, Sample* output, size_t num_samples) const
+        {
+            for (size_t i = 0; i < num_samples; i++)
+            {
+                // positions aren't negative, so truncation is floor
+                const long int index = static_cast<long int>(positions[i]);
+                output[i] = this->read(level, data + (index - start), positions[i] - static_cast<float>(index));
+            }
+        }
+
+    private:
+        /** Levels 0 to @a level - 1 hold Taps * (2^level - 1) points per row. */
+        static constexpr size_t _offset(size_t level)
+        {
+            return Taps * ((size_t(1) << level) - 1) * (Phases + 1);
+        }
+
+        // Blackman-windowed sinc, each row normalised to unity gain at DC
+        void _build(size_t level)
+        {
+            const size_t n = level_taps(level);
+            const double half = static_cast<double>(n) / 2.0;
+            const double fc = 0.5 * static_cast<double>(cutoff) / static_cast<double>(1 << level);
+            for (size_t row = 0; row <= Phases; row++)
+            {
+                const double fraction = static_cast<double>(row) / static_cast<double>(Phases);
+                Sample* w = this->_table.data() + _offset(level) + row * n;
+                double sum = 0.0;
+                std::array<double, max_taps> h;
+                for (size_t k = 0; k < n; k++)
+                {
+                    const double t = static_cast<double>(k) - static_cast<double>(before(level)) - fraction;
+                    const double x = 2.0 * fc * t;
+                    const double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+                    const double window = 0.42 + 0.5 * std::cos(M_PI * t / half) + 0.08 * std::cos(2.0 * M_PI * t / half);
+                    h[k] = sinc * window;
+                    sum += h[k];
+                }
+                for (size_t k = 0; k < n; k++)
+                    w[k] = Sample(h[k] / sum);
+            }
+        }
+
+        std::array<Sample, Taps * ((size_t(1) << Levels) - 1) * (Phases + 1)> _table;
+};
+
+} // namespace idsp
+
+#endif
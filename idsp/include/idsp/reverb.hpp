@@ -15,34 +15,57 @@ namespace idsp
     class SmallRoom
     {
         using FilterType = typename idsp::OnepoleFilter::Type;
+
+        /** Every delay line of both channels, packed in the order the
+         * processors take them, left then right for each stage. */
+        using Lines = SampleBufferArena<(24*(SAMPLE_RATE/1000)),
+                                        (25*(SAMPLE_RATE/1000)),
+                                        static_cast<size_t>(8.3f * static_cast<float>((SAMPLE_RATE/1000))),
+                                        static_cast<size_t>(8.f * static_cast<float>((SAMPLE_RATE/1000))),
+                                        (22 * (SAMPLE_RATE/1000)),
+                                        (23 * (SAMPLE_RATE/1000)),
+                                        (35 * (SAMPLE_RATE/1000)),
+                                        (34 * (SAMPLE_RATE/1000)),
+                                        (30 * (SAMPLE_RATE/1000)),
+                                        (31 * (SAMPLE_RATE/1000)),
+                                        (66 * (SAMPLE_RATE/1000)),
+                                        (65 * (SAMPLE_RATE/1000))>;
+
         public:
+            /** Samples of delay memory, all in one arena. */
+            static constexpr size_t arena_size = Lines::total_size;
+
             SmallRoom()   :
-            dampening_l{FilterType::Lowpass, (4500*(1.f/SAMPLE_RATE))},
+            delay_l{_lines[0]},
+            delay_r{_lines[1]},
+            double_nested_allpass{&_lines[2], &_lines[4], &_lines[6]},
+            nested_allpass{&_lines[8], &_lines[10]},
             feedback_l{0},
-            dampening_r{FilterType::Lowpass, (4500*(1.f/SAMPLE_RATE))},
             feedback_r{0},
-            gain{0}
+            dampening{FilterType::Lowpass, (4500*(1.f/SAMPLE_RATE))},
+            gain{0},
+            _silence{SAMPLE_RATE}
             {
-                double_nested_allpass_l->set_gain(0.6, 0.4, 0.8);
-                nested_allpass_l->set_gain(0.4, 0.1);
-                double_nested_allpass_r->set_gain(0.6, 0.4, 0.8);
-                nested_allpass_r->set_gain(0.4, 0.1);
+                double_nested_allpass.set_gain(0.6, 0.4, 0.8);
+                nested_allpass.set_gain(0.4, 0.1);
+            }
+
+            /** Frame processor: one sample per channel. */
+            void process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
+            {
+                _process(in_l, in_r, out_l, out_r);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
             /**assumes left/right/in/out buffers are all of equal length*/
             void process(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < input[0].size(); i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, input[0].size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, N);
             }
 
             constexpr
@@ -50,83 +73,190 @@ namespace idsp
 
             inline void set_dampening(float f) {dampen = f;}
 
-            inline void set_cutoff(float f)
+            inline void set_cutoff(float f) {dampening.set_cutoff(f);}
+
+            /** Input level at or below which, once the output has also stayed
+             * at or below the tail floor for a second, the block processors
+             * skip the network and write silence. Negative disables it. */
+            inline void set_silence_threshold(Sample threshold) {_silence.set_threshold(threshold);}
+
+            inline void set_tail_floor(Sample floor) {_silence.set_floor(floor);}
+
+            /** @returns True while silence is skipping the network. */
+            inline bool is_bypassed() const {return _silence.is_closed();}
+
+        private:
+            void _process_gated(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
             {
-                dampening_l.set_cutoff(f);
-                dampening_r.set_cutoff(f);
+                if (_silence.skip(input, output, num_frames))
+                    return;
+                _process_block(input, output, num_frames);
+                _silence.update(output, num_frames);
             }
 
-        private:
             void _process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
             {
                 // apply dampening to feedback tap
-                Sample damp_l = interpolate_2(dampen, feedback_r, dampening_l.process(feedback_r));
-                Sample damp_r = interpolate_2(dampen, feedback_l, dampening_r.process(feedback_l));
-                // calculate feedforward tap
-                Sample feedforward_l = double_nested_allpass_l->process(delay_l->read());
-                Sample feedforward_r = double_nested_allpass_r->process(delay_r->read());
+                std::array<Sample, 2> damped {feedback_r, feedback_l};
+                dampening.process(damped.data(), damped.data());
+                Sample damp_l = interpolate_2(dampen, feedback_r, damped[0]);
+                Sample damp_r = interpolate_2(dampen, feedback_l, damped[1]);
+                // calculate feedforward tap, left and right together
+                std::array<Sample, 2> feedforward {delay_l.read(), delay_r.read()};
+                double_nested_allpass.process(feedforward.data(), feedforward.data());
                 // sample new input + varaible amount of feedback
-                delay_l->write(in_l +  (damp_l * gain));
-                delay_r->write(in_r +  (damp_r * gain));
+                delay_l.write(in_l +  (damp_l * gain));
+                delay_r.write(in_r +  (damp_r * gain));
                 // calculate feedback tap
-                feedback_l = nested_allpass_l->process(feedforward_l);
-                feedback_r = nested_allpass_r->process(feedforward_r);
+                std::array<Sample, 2> feedback {feedforward};
+                nested_allpass.process(feedback.data(), feedback.data());
+                feedback_l = feedback[0];
+                feedback_r = feedback[1];
                 // output a mix of feedforward and feedback tap
-                out_l = (feedback_l * 0.2f) + (feedforward_l * 0.6f);
-                out_r = (feedback_r * 0.2f) + (feedforward_r * 0.6f);
+                out_l = (feedback_l * 0.2f) + (feedforward[0] * 0.6f);
+                out_r = (feedback_r * 0.2f) + (feedforward[1] * 0.6f);
             }
 
-            Delay<SampleBufferStatic<(24*(SAMPLE_RATE/1000))>>  delay_l;
-            DoubleNestedAllpass <SampleBufferStatic<static_cast<size_t>(8.3f * static_cast<float>((SAMPLE_RATE/1000)))>,
-                                SampleBufferStatic<(22 * (SAMPLE_RATE/1000))>,
-                                SampleBufferStatic<(35 * (SAMPLE_RATE/1000))>> double_nested_allpass_l;
-            NestedAllpass<SampleBufferStatic<(30 * (SAMPLE_RATE/1000))>, SampleBufferStatic<(66 * (SAMPLE_RATE/1000))>> nested_allpass_l;
-            OnepoleFilter dampening_l;
-            Sample feedback_l;
+            // The only loop runs through the input delays, so a chunk no
+            // longer than them reads nothing it writes: each allpass chain
+            // runs over the whole chunk and only the dampened feedback, which
+            // crosses channels one sample later, is computed frame by frame
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                auto& feedforward_l = _scratch[0];
+                auto& feedforward_r = _scratch[1];
+                auto& tap_l = _scratch[2];
+                auto& tap_r = _scratch[3];
+                auto& write_l = _scratch[4];
+                auto& write_r = _scratch[5];
+                const size_t chunk = min(_block_size, min(delay_l.get_length(), delay_r.get_length()));
+                for (size_t start = 0; start < num_frames; start += chunk)
+                {
+                    const size_t n = min(chunk, num_frames - start);
+                    std::array<BufferInterface, 2> ff {BufferInterface(feedforward_l.data(), n), BufferInterface(feedforward_r.data(), n)};
+                    std::array<BufferInterface, 2> fb {BufferInterface(tap_l.data(), n), BufferInterface(tap_r.data(), n)};
+                    PolyBufferInterface poly_ff(ff.data(), 2), poly_fb(fb.data(), 2);
+
+                    delay_l.read_block(delay_l.get_length(), ff[0]);
+                    delay_r.read_block(delay_r.get_length(), ff[1]);
+                    double_nested_allpass.process(poly_ff, poly_ff);
+                    std::copy_n(feedforward_l.data(), n, tap_l.data());
+                    std::copy_n(feedforward_r.data(), n, tap_r.data());
+                    nested_allpass.process(poly_fb, poly_fb);
+
+                    const Sample* in_l = input[0].data() + start;
+                    const Sample* in_r = input[1].data() + start;
+                    Sample* out_l = output[0].data() + start;
+                    Sample* out_r = output[1].data() + start;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        std::array<Sample, 2> damped {feedback_r, feedback_l};
+                        dampening.process(damped.data(), damped.data());
+                        Sample damp_l = interpolate_2(dampen, feedback_r, damped[0]);
+                        Sample damp_r = interpolate_2(dampen, feedback_l, damped[1]);
+                        write_l[i] = in_l[i] +  (damp_l * gain);
+                        write_r[i] = in_r[i] +  (damp_r * gain);
+                        feedback_l = tap_l[i];
+                        feedback_r = tap_r[i];
+                        out_l[i] = (feedback_l * 0.2f) + (feedforward_l[i] * 0.6f);
+                        out_r[i] = (feedback_r * 0.2f) + (feedforward_r[i] * 0.6f);
+                    }
+                    delay_l.write(write_l.data(), n);
+                    delay_r.write(write_r.data(), n);
+                }
+            }
 
-            Delay<SampleBufferStatic<(25*(SAMPLE_RATE/1000))>>  delay_r;
-            DoubleNestedAllpass <SampleBufferStatic<static_cast<size_t>(8.f * static_cast<float>((SAMPLE_RATE/1000)))>,
-                                SampleBufferStatic<(23 * (SAMPLE_RATE/1000))>,
-                                SampleBufferStatic<(34 * (SAMPLE_RATE/1000))>> double_nested_allpass_r;
-            NestedAllpass<SampleBufferStatic<(31 * (SAMPLE_RATE/1000))>, SampleBufferStatic<(65 * (SAMPLE_RATE/1000))>> nested_allpass_r;
-            OnepoleFilter dampening_r;
+            Lines _lines;
+            AudioRingBuffer delay_l;
+            AudioRingBuffer delay_r;
+            /** Left and right allpass chains, one lane each. */
+            DoubleNestedAllpassBank<2> double_nested_allpass;
+            NestedAllpassBank<2> nested_allpass;
+            Sample feedback_l;
             Sample feedback_r;
 
+            /** Left and right feedback dampening. */
+            OnepoleBank<2> dampening;
+
             Sample gain;
             float dampen;
+
+            static constexpr size_t _block_size = 64;
+            std::array<std::array<Sample, _block_size>, 6> _scratch;
+
+            /** Skips the network once input and tail are silent. */
+            SilenceGate _silence;
     };
 
     template<size_t SAMPLE_RATE>
     class MediumRoom
     {
         using FilterType = typename idsp::OnepoleFilter::Type;
+
+        /** Every delay line of both channels, packed in the order the
+         * processors take them, left then right for each stage. */
+        using Lines = SampleBufferArena<(22*(SAMPLE_RATE/1000)),
+                                        (21*(SAMPLE_RATE/1000)),
+                                        static_cast<size_t>(8.3f * static_cast<float>((SAMPLE_RATE/1000))),
+                                        static_cast<size_t>(8.4f * static_cast<float>((SAMPLE_RATE/1000))),
+                                        (35*(SAMPLE_RATE/1000)),
+                                        (34*(SAMPLE_RATE/1000)),
+                                        (5*(SAMPLE_RATE/1000)),
+                                        (6*(SAMPLE_RATE/1000)),
+                                        (30*(SAMPLE_RATE/1000)),
+                                        (29*(SAMPLE_RATE/1000)),
+                                        (67*(SAMPLE_RATE/1000)),
+                                        (68*(SAMPLE_RATE/1000)),
+                                        (15*(SAMPLE_RATE/1000)),
+                                        (14*(SAMPLE_RATE/1000)),
+                                        (10 * (SAMPLE_RATE/1000)),
+                                        (11 * (SAMPLE_RATE/1000)),
+                                        (39 * (SAMPLE_RATE/1000)),
+                                        (38 * (SAMPLE_RATE/1000)),
+                                        (108*(SAMPLE_RATE/1000)),
+                                        (107*(SAMPLE_RATE/1000))>;
+
         public:
+            /** Samples of delay memory, all in one arena. */
+            static constexpr size_t arena_size = Lines::total_size;
+
             MediumRoom()  :
-            dampening_l{FilterType::Lowpass, (2500*(1.f/SAMPLE_RATE))},
+            double_nested_allpass{&_lines[0], &_lines[2], &_lines[4]},
+            delay0_l{_lines[6]},
+            delay0_r{_lines[7]},
+            allpass{&_lines[8]},
+            delay1_l{_lines[10]},
+            delay1_r{_lines[11]},
+            delay2_l{_lines[12]},
+            delay2_r{_lines[13]},
+            nested_allpass{&_lines[14], &_lines[16]},
+            delay3_l{_lines[18]},
+            delay3_r{_lines[19]},
             feedback_l{0},
-            dampening_r{FilterType::Lowpass, (2500*(1.f/SAMPLE_RATE))},
-            feedback_r{0}
+            feedback_r{0},
+            dampening{FilterType::Lowpass, (2500*(1.f/SAMPLE_RATE))},
+            _silence{SAMPLE_RATE}
             {
-                allpass_l->set_gain(0.5f);
-                nested_allpass_l->set_gain(0.6, 0.3);
-                allpass_r->set_gain(0.5f);
-                nested_allpass_r->set_gain(0.6, 0.3);
+                allpass.set_gain(0.5f);
+                nested_allpass.set_gain(0.6, 0.3);
+            }
+
+            /** Frame processor: one sample per channel. */
+            void process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
+            {
+                _process(in_l, in_r, out_l, out_r);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
             /**assumes left/right/in/out buffers are all of equal length*/
             void process(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < input[0].size(); i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, input[0].size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, N);
             }
 
             constexpr
@@ -134,112 +264,249 @@ namespace idsp
 
             inline void set_dampening(float f) {dampen = f;}
 
-            inline void set_cutoff(float f)
+            inline void set_cutoff(float f) {dampening.set_cutoff(f);}
+
+            /** Input level at or below which, once the output has also stayed
+             * at or below the tail floor for a second, the block processors
+             * skip the network and write silence. Negative disables it. */
+            inline void set_silence_threshold(Sample threshold) {_silence.set_threshold(threshold);}
+
+            inline void set_tail_floor(Sample floor) {_silence.set_floor(floor);}
+
+            /** @returns True while silence is skipping the network. */
+            inline bool is_bypassed() const {return _silence.is_closed();}
+
+        private:
+            void _process_gated(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
             {
-                dampening_l.set_cutoff(f);
-                dampening_r.set_cutoff(f);
+                if (_silence.skip(input, output, num_frames))
+                    return;
+                _process_block(input, output, num_frames);
+                _silence.update(output, num_frames);
             }
 
-        private:
             void _process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
              {
-                Sample damp_l = interpolate_2(dampen, delay3_l->read(), dampening_l.process(delay3_l->read()));
-                Sample damp_r = interpolate_2(dampen, delay3_r->read(), dampening_r.process(delay3_r->read()));
+                std::array<Sample, 2> damped {delay3_l.read(), delay3_r.read()};
+                dampening.process(damped.data(), damped.data());
+                Sample damp_l = interpolate_2(dampen, delay3_l.read(), damped[0]);
+                Sample damp_r = interpolate_2(dampen, delay3_r.read(), damped[1]);
 
-                Sample feedforward0_l = double_nested_allpass_l->process((in_l + (damp_l * gain)));
-                Sample feedforward0_r = double_nested_allpass_r->process((in_r + (damp_r * gain)));
+                std::array<Sample, 2> feedforward0 {(in_l + (damp_l * gain)), (in_r + (damp_r * gain))};
+                double_nested_allpass.process(feedforward0.data(), feedforward0.data());
+                Sample feedforward0_l = feedforward0[0];
+                Sample feedforward0_r = feedforward0[1];
 
-                Sample feedforward1_l = allpass_l->process(delay0_l->read());
-                Sample feedforward1_r = allpass_r->process(delay0_r->read());
+                std::array<Sample, 2> feedforward1 {delay0_l.read(), delay0_r.read()};
+                allpass.process(feedforward1.data(), feedforward1.data());
 
-                delay0_l->write(feedforward0_l);
-                delay0_r->write(feedforward0_r);
+                delay0_l.write(feedforward0_l);
+                delay0_r.write(feedforward0_r);
 
-                Sample del1_out_l =  delay1_l->read();
-                Sample del1_out_r =  delay1_r->read();
-                delay1_l->write(feedforward1_l);
-                delay1_r->write(feedforward1_r);
-                feedforward1_l = del1_out_l;
-                feedforward1_r = del1_out_r;
+                Sample del1_out_l =  delay1_l.read();
+                Sample del1_out_r =  delay1_r.read();
+                delay1_l.write(feedforward1[0]);
+                delay1_r.write(feedforward1[1]);
+                Sample feedforward1_l = del1_out_l;
+                Sample feedforward1_r = del1_out_r;
 
-                feedback_r = nested_allpass_l->process(((delay2_l->read() * gain) + in_l));
-                feedback_l = nested_allpass_r->process(((delay2_r->read() * gain) + in_r));
+                // the left nested allpass feeds the right channel's feedback
+                std::array<Sample, 2> nested {((delay2_l.read() * gain) + in_l), ((delay2_r.read() * gain) + in_r)};
+                nested_allpass.process(nested.data(), nested.data());
+                feedback_r = nested[0];
+                feedback_l = nested[1];
 
-                delay2_l->write(feedforward1_l);
-                delay2_r->write(feedforward1_r);
+                delay2_l.write(feedforward1_l);
+                delay2_r.write(feedforward1_r);
 
-                delay3_l->write(feedback_l);
-                delay3_r->write(feedback_r);
+                delay3_l.write(feedback_l);
+                delay3_r.write(feedback_r);
 
                 out_l = (feedforward0_l * 0.34f) + (feedforward1_l * 0.14f) + (feedback_l * 0.14f);
                 out_r = (feedforward0_r * 0.34f) + (feedforward1_r * 0.14f) + (feedback_r * 0.14f);
             }
 
+            // Every loop runs through at least one of the delays, so a chunk no
+            // longer than the shortest reads nothing it writes and each stage
+            // runs over the whole chunk. Only the dampening is frame by frame.
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                auto& tap3_l = _scratch[0];
+                auto& tap3_r = _scratch[1];
+                auto& tap0_l = _scratch[2];
+                auto& tap0_r = _scratch[3];
+                auto& tap1_l = _scratch[4];
+                auto& tap1_r = _scratch[5];
+                auto& tap2_l = _scratch[6];
+                auto& tap2_r = _scratch[7];
+                auto& feedforward0_l = _scratch[8];
+                auto& feedforward0_r = _scratch[9];
+                const size_t chunk = min(min(_block_size, min(delay0_l.get_length(), delay0_r.get_length())),
+                                         min(min(delay1_l.get_length(), delay1_r.get_length()),
+                                             min(min(delay2_l.get_length(), delay2_r.get_length()),
+                                                 min(delay3_l.get_length(), delay3_r.get_length()))));
+                for (size_t start = 0; start < num_frames; start += chunk)
+                {
+                    const size_t n = min(chunk, num_frames - start);
+                    std::array<BufferInterface, 2> ff0 {BufferInterface(feedforward0_l.data(), n), BufferInterface(feedforward0_r.data(), n)};
+                    std::array<BufferInterface, 2> ap {BufferInterface(tap0_l.data(), n), BufferInterface(tap0_r.data(), n)};
+                    std::array<BufferInterface, 2> nap {BufferInterface(tap2_l.data(), n), BufferInterface(tap2_r.data(), n)};
+                    PolyBufferInterface poly_ff0(ff0.data(), 2), poly_ap(ap.data(), 2), poly_nap(nap.data(), 2);
+
+                    delay3_l.read_block(delay3_l.get_length(), tap3_l.data(), n);
+                    delay3_r.read_block(delay3_r.get_length(), tap3_r.data(), n);
+                    delay0_l.read_block(delay0_l.get_length(), ap[0]);
+                    delay0_r.read_block(delay0_r.get_length(), ap[1]);
+                    delay1_l.read_block(delay1_l.get_length(), tap1_l.data(), n);
+                    delay1_r.read_block(delay1_r.get_length(), tap1_r.data(), n);
+                    delay2_l.read_block(delay2_l.get_length(), nap[0]);
+                    delay2_r.read_block(delay2_r.get_length(), nap[1]);
+
+                    const Sample* in_l = input[0].data() + start;
+                    const Sample* in_r = input[1].data() + start;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        std::array<Sample, 2> damped {tap3_l[i], tap3_r[i]};
+                        dampening.process(damped.data(), damped.data());
+                        Sample damp_l = interpolate_2(dampen, tap3_l[i], damped[0]);
+                        Sample damp_r = interpolate_2(dampen, tap3_r[i], damped[1]);
+                        feedforward0_l[i] = in_l[i] + (damp_l * gain);
+                        feedforward0_r[i] = in_r[i] + (damp_r * gain);
+                        tap2_l[i] = (tap2_l[i] * gain) + in_l[i];
+                        tap2_r[i] = (tap2_r[i] * gain) + in_r[i];
+                    }
+
+                    double_nested_allpass.process(poly_ff0, poly_ff0);
+                    allpass.process(poly_ap, poly_ap);
+                    // the left nested allpass feeds the right channel's
+                    // feedback and vice versa
+                    nested_allpass.process(poly_nap, poly_nap);
+
+                    delay0_l.write(feedforward0_l.data(), n);
+                    delay0_r.write(feedforward0_r.data(), n);
+                    delay1_l.write(tap0_l.data(), n);
+                    delay1_r.write(tap0_r.data(), n);
+                    delay2_l.write(tap1_l.data(), n);
+                    delay2_r.write(tap1_r.data(), n);
+                    delay3_l.write(tap2_r.data(), n);
+                    delay3_r.write(tap2_l.data(), n);
+
+                    Sample* out_l = output[0].data() + start;
+                    Sample* out_r = output[1].data() + start;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        out_l[i] = (feedforward0_l[i] * 0.34f) + (tap1_l[i] * 0.14f) + (tap2_r[i] * 0.14f);
+                        out_r[i] = (feedforward0_r[i] * 0.34f) + (tap1_r[i] * 0.14f) + (tap2_l[i] * 0.14f);
+                    }
+                    feedback_l = tap2_r[n - 1];
+                    feedback_r = tap2_l[n - 1];
+                }
+            }
 
-            DoubleNestedAllpass <SampleBufferStatic<22 *(SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<static_cast<size_t>(8.3f * static_cast<float>((SAMPLE_RATE/1000)))>,
-                                SampleBufferStatic<(35*(SAMPLE_RATE/1000))>> double_nested_allpass_l;
-            Delay<SampleBufferStatic<(5*(SAMPLE_RATE/1000))>>  delay0_l;
-            Allpass<SampleBufferStatic<(30*(SAMPLE_RATE/1000))>> allpass_l;
-            Delay<SampleBufferStatic<(67*(SAMPLE_RATE/1000))>>  delay1_l;
-            Delay<SampleBufferStatic<(15*(SAMPLE_RATE/1000))>>  delay2_l;
-            NestedAllpass<SampleBufferStatic<(10 * (SAMPLE_RATE/1000))>, SampleBufferStatic<(39 * (SAMPLE_RATE/1000))>> nested_allpass_l;
-            Delay<SampleBufferStatic<(108*(SAMPLE_RATE/1000))>>  delay3_l;
-            OnepoleFilter dampening_l;
-            Sample feedback_l;
 
-            DoubleNestedAllpass <SampleBufferStatic<21 *(SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<static_cast<size_t>(8.4f * static_cast<float>((SAMPLE_RATE/1000)))>,
-                                SampleBufferStatic<(34*(SAMPLE_RATE/1000))>> double_nested_allpass_r;
-            Delay<SampleBufferStatic<(6*(SAMPLE_RATE/1000))>>  delay0_r;
-            Allpass<SampleBufferStatic<(29*(SAMPLE_RATE/1000))>> allpass_r;
-            Delay<SampleBufferStatic<(68*(SAMPLE_RATE/1000))>>  delay1_r;
-            Delay<SampleBufferStatic<(14*(SAMPLE_RATE/1000))>>  delay2_r;
-            NestedAllpass<SampleBufferStatic<(11 * (SAMPLE_RATE/1000))>, SampleBufferStatic<(38 * (SAMPLE_RATE/1000))>> nested_allpass_r;
-            Delay<SampleBufferStatic<(107*(SAMPLE_RATE/1000))>>  delay3_r;
-            OnepoleFilter dampening_r;
+            Lines _lines;
+            /** Left and right allpass chains, one lane each. */
+            DoubleNestedAllpassBank<2> double_nested_allpass;
+            AudioRingBuffer delay0_l;
+            AudioRingBuffer delay0_r;
+            AllpassBank<2> allpass;
+            AudioRingBuffer delay1_l;
+            AudioRingBuffer delay1_r;
+            AudioRingBuffer delay2_l;
+            AudioRingBuffer delay2_r;
+            NestedAllpassBank<2> nested_allpass;
+            AudioRingBuffer delay3_l;
+            AudioRingBuffer delay3_r;
+            Sample feedback_l;
             Sample feedback_r;
 
+            /** Left and right feedback dampening. */
+            OnepoleBank<2> dampening;
+
             Sample gain;
             float dampen;
+
+            static constexpr size_t _block_size = 64;
+            std::array<std::array<Sample, _block_size>, 10> _scratch;
+
+            /** Skips the network once input and tail are silent. */
+            SilenceGate _silence;
     };
 
     template<size_t SAMPLE_RATE>
     class LargeRoom
     {
         using FilterType = typename idsp::OnepoleFilter::Type;
+
+        /** Every delay line of both channels, packed in the order the
+         * processors take them, left then right for each stage. */
+        using Lines = SampleBufferArena<(8*(SAMPLE_RATE/1000)),
+                                        (9*(SAMPLE_RATE/1000)),
+                                        (12*(SAMPLE_RATE/1000)),
+                                        (11*(SAMPLE_RATE/1000)),
+                                        (4*(SAMPLE_RATE/1000)),
+                                        (5*(SAMPLE_RATE/1000)),
+                                        (17*(SAMPLE_RATE/1000)),
+                                        (16*(SAMPLE_RATE/1000)),
+                                        (62 * (SAMPLE_RATE/1000)),
+                                        (61 * (SAMPLE_RATE/1000)),
+                                        (87 * (SAMPLE_RATE/1000)),
+                                        (86 * (SAMPLE_RATE/1000)),
+                                        (31*(SAMPLE_RATE/1000)),
+                                        (32*(SAMPLE_RATE/1000)),
+                                        (3*(SAMPLE_RATE/1000)),
+                                        (2*(SAMPLE_RATE/1000)),
+                                        (30*(SAMPLE_RATE/1000)),
+                                        (31*(SAMPLE_RATE/1000)),
+                                        (76*(SAMPLE_RATE/1000)),
+                                        (75*(SAMPLE_RATE/1000)),
+                                        (120*(SAMPLE_RATE/1000)),
+                                        (121*(SAMPLE_RATE/1000))>;
+
         public:
+            /** Samples of delay memory, all in one arena. */
+            static constexpr size_t arena_size = Lines::total_size;
+
             LargeRoom()  :
-            dampening_l{FilterType::Lowpass, (2600*(1.f/SAMPLE_RATE))},
+            allpass{&_lines[0]},
+            allpass1{&_lines[2]},
+            delay_l{_lines[4]},
+            delay_r{_lines[5]},
+            delay1_l{_lines[6]},
+            delay1_r{_lines[7]},
+            nested_allpass{&_lines[8], &_lines[10]},
+            delay2_l{_lines[12]},
+            delay2_r{_lines[13]},
+            delay3_l{_lines[14]},
+            delay3_r{_lines[15]},
+            double_nested_allpass{&_lines[16], &_lines[18], &_lines[20]},
             feedback_l{0},
-            dampening_r{FilterType::Lowpass, (2600*(1.f/SAMPLE_RATE))},
-            feedback_r{0}
+            feedback_r{0},
+            dampening{FilterType::Lowpass, (2600*(1.f/SAMPLE_RATE))},
+            _silence{SAMPLE_RATE}
             {
-                allpass_l->set_gain(0.3f);
-                allpass1_l->set_gain(0.3f);
-                nested_allpass_l->set_gain(0.25, 0.5);
-                double_nested_allpass_l->set_gain(0.25, 0.25, 0.5);
+                allpass.set_gain(0.3f);
+                allpass1.set_gain(0.3f);
+                nested_allpass.set_gain(0.25, 0.5);
+                double_nested_allpass.set_gain(0.25, 0.25, 0.5);
+            }
 
-                allpass_r->set_gain(0.3f);
-                allpass1_r->set_gain(0.3f);
-                nested_allpass_r->set_gain(0.25, 0.5);
-                double_nested_allpass_r->set_gain(0.25, 0.25, 0.5);
+            /** Frame processor: one sample per channel. */
+            void process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
+            {
+                _process(in_l, in_r, out_l, out_r);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
             /**assumes left/right/in/out buffers are all of equal length*/
             void process(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < input[0].size(); i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, input[0].size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
             {
-                for(size_t i = 0; i < N; i++)
-                    _process(input[0][i], input[1][i], output[0][i], output[1][i]);
+                _process_gated(input, output, N);
             }
 
             constexpr
@@ -247,75 +514,166 @@ namespace idsp
 
             inline void set_dampening(float f) {dampen = f;}
 
-            inline void set_cutoff(float f)
-            {
-                dampening_l.set_cutoff(f);
-                dampening_r.set_cutoff(f);
-            }
-
-        private:
-            void _process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
-            {
-                feedback_r = double_nested_allpass_l->process(delay3_l->read());
-                feedback_l = double_nested_allpass_r->process(delay3_r->read());
+            inline void set_cutoff(float f) {dampening.set_cutoff(f);}
 
-                Sample dampened_feedback_l = interpolate_2(dampen, feedback_l, dampening_l.process(feedback_l)) * gain;
-                Sample dampened_feedback_r = interpolate_2(dampen, feedback_r, dampening_r.process(feedback_r)) * gain;
+            /** Input level at or below which, once the output has also stayed
+             * at or below the tail floor for a second, the block processors
+             * skip the network and write silence. Negative disables it. */
+            inline void set_silence_threshold(Sample threshold) {_silence.set_threshold(threshold);}
 
-                Sample feedforward_1_l = delay_l->read();
-                Sample feedforward_1_r = delay_r->read();
-                Sample ap_out_l = allpass_l->process(in_l + dampened_feedback_l);
-                Sample ap_out_r = allpass_r->process(in_r + dampened_feedback_r);
-                delay_l->write(allpass1_l->process(ap_out_l));
-                delay_r->write(allpass1_r->process(ap_out_r));
+            inline void set_tail_floor(Sample floor) {_silence.set_floor(floor);}
 
-                Sample nested_ap_out_l = nested_allpass_l->process(delay1_l->read());
-                Sample nested_ap_out_r = nested_allpass_r->process(delay1_r->read());
-                delay1_l->write(feedforward_1_l);
-                delay1_r->write(feedforward_1_r);
+            /** @returns True while silence is skipping the network. */
+            inline bool is_bypassed() const {return _silence.is_closed();}
 
-                Sample feedforward_2_l = delay2_l->read();
-                Sample feedforward_2_r = delay2_r->read();
-                delay2_l->write(nested_ap_out_l);
-                delay2_r->write(nested_ap_out_r);
+        private:
+            void _process_gated(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                if (_silence.skip(input, output, num_frames))
+                    return;
+                _process_block(input, output, num_frames);
+                _silence.update(output, num_frames);
+            }
 
-                delay3_l->write(feedforward_2_l);
-                delay3_r->write(feedforward_2_r);
+            void _process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
+            {
+                // the left double nested allpass feeds the right channel's
+                // feedback and vice versa
+                std::array<Sample, 2> tap3 {delay3_l.read(), delay3_r.read()};
+                double_nested_allpass.process(tap3.data(), tap3.data());
+                feedback_r = tap3[0];
+                feedback_l = tap3[1];
+
+                std::array<Sample, 2> damped {feedback_l, feedback_r};
+                dampening.process(damped.data(), damped.data());
+                Sample dampened_feedback_l = interpolate_2(dampen, feedback_l, damped[0]) * gain;
+                Sample dampened_feedback_r = interpolate_2(dampen, feedback_r, damped[1]) * gain;
+
+                Sample feedforward_1_l = delay_l.read();
+                Sample feedforward_1_r = delay_r.read();
+                std::array<Sample, 2> ap_out {in_l + dampened_feedback_l, in_r + dampened_feedback_r};
+                allpass.process(ap_out.data(), ap_out.data());
+                allpass1.process(ap_out.data(), ap_out.data());
+                delay_l.write(ap_out[0]);
+                delay_r.write(ap_out[1]);
+
+                std::array<Sample, 2> nested_ap_out {delay1_l.read(), delay1_r.read()};
+                nested_allpass.process(nested_ap_out.data(), nested_ap_out.data());
+                delay1_l.write(feedforward_1_l);
+                delay1_r.write(feedforward_1_r);
+
+                Sample feedforward_2_l = delay2_l.read();
+                Sample feedforward_2_r = delay2_r.read();
+                delay2_l.write(nested_ap_out[0]);
+                delay2_r.write(nested_ap_out[1]);
+
+                delay3_l.write(feedforward_2_l);
+                delay3_r.write(feedforward_2_r);
 
                 out_l = (feedforward_1_l * 0.34f) + (feedforward_2_l * 0.14f) + (feedback_l * 0.14f);
                 out_r = (feedforward_1_r * 0.34f) + (feedforward_2_r * 0.14f) + (feedback_r * 0.14f);
             }
 
-            Allpass<SampleBufferStatic<(8*(SAMPLE_RATE/1000))>> allpass_l;
-            Allpass<SampleBufferStatic<(12*(SAMPLE_RATE/1000))>> allpass1_l;
-            Delay<SampleBufferStatic<(4*(SAMPLE_RATE/1000))>>  delay_l;
-            Delay<SampleBufferStatic<(17*(SAMPLE_RATE/1000))>>  delay1_l;
-            NestedAllpass<SampleBufferStatic<(62 * (SAMPLE_RATE/1000))>,
-                        SampleBufferStatic<(87 * (SAMPLE_RATE/1000))>> nested_allpass_l;
-            Delay<SampleBufferStatic<(31*(SAMPLE_RATE/1000))>>  delay2_l;
-            Delay<SampleBufferStatic<(3*(SAMPLE_RATE/1000))>>  delay3_l;
-            DoubleNestedAllpass <SampleBufferStatic<30 *(SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<76 * (SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<120*(SAMPLE_RATE/1000)>> double_nested_allpass_l;
-            OnepoleFilter dampening_l;
-            Sample feedback_l;
+            // Every loop runs through at least one of the delays, so a chunk no
+            // longer than the shortest reads nothing it writes and each stage
+            // runs over the whole chunk. Only the dampening is frame by frame.
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                auto& tap3_l = _scratch[0];
+                auto& tap3_r = _scratch[1];
+                auto& feedforward_1_l = _scratch[2];
+                auto& feedforward_1_r = _scratch[3];
+                auto& tap1_l = _scratch[4];
+                auto& tap1_r = _scratch[5];
+                auto& feedforward_2_l = _scratch[6];
+                auto& feedforward_2_r = _scratch[7];
+                auto& write_l = _scratch[8];
+                auto& write_r = _scratch[9];
+                const size_t chunk = min(min(_block_size, min(delay_l.get_length(), delay_r.get_length())),
+                                         min(min(delay1_l.get_length(), delay1_r.get_length()),
+                                             min(min(delay2_l.get_length(), delay2_r.get_length()),
+                                                 min(delay3_l.get_length(), delay3_r.get_length()))));
+                for (size_t start = 0; start < num_frames; start += chunk)
+                {
+                    const size_t n = min(chunk, num_frames - start);
+                    std::array<BufferInterface, 2> dnap {BufferInterface(tap3_l.data(), n), BufferInterface(tap3_r.data(), n)};
+                    std::array<BufferInterface, 2> nap {BufferInterface(tap1_l.data(), n), BufferInterface(tap1_r.data(), n)};
+                    std::array<BufferInterface, 2> w {BufferInterface(write_l.data(), n), BufferInterface(write_r.data(), n)};
+                    PolyBufferInterface poly_dnap(dnap.data(), 2), poly_nap(nap.data(), 2), poly_w(w.data(), 2);
+
+                    // the left double nested allpass feeds the right channel's
+                    // feedback and vice versa
+                    delay3_l.read_block(delay3_l.get_length(), dnap[0]);
+                    delay3_r.read_block(delay3_r.get_length(), dnap[1]);
+                    double_nested_allpass.process(poly_dnap, poly_dnap);
+                    delay_l.read_block(delay_l.get_length(), feedforward_1_l.data(), n);
+                    delay_r.read_block(delay_r.get_length(), feedforward_1_r.data(), n);
+                    delay1_l.read_block(delay1_l.get_length(), nap[0]);
+                    delay1_r.read_block(delay1_r.get_length(), nap[1]);
+                    nested_allpass.process(poly_nap, poly_nap);
+                    delay2_l.read_block(delay2_l.get_length(), feedforward_2_l.data(), n);
+                    delay2_r.read_block(delay2_r.get_length(), feedforward_2_r.data(), n);
+
+                    const Sample* in_l = input[0].data() + start;
+                    const Sample* in_r = input[1].data() + start;
+                    Sample* out_l = output[0].data() + start;
+                    Sample* out_r = output[1].data() + start;
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        feedback_l = tap3_r[i];
+                        feedback_r = tap3_l[i];
+                        std::array<Sample, 2> damped {feedback_l, feedback_r};
+                        dampening.process(damped.data(), damped.data());
+                        Sample dampened_feedback_l = interpolate_2(dampen, feedback_l, damped[0]) * gain;
+                        Sample dampened_feedback_r = interpolate_2(dampen, feedback_r, damped[1]) * gain;
+                        write_l[i] = in_l[i] + dampened_feedback_l;
+                        write_r[i] = in_r[i] + dampened_feedback_r;
+                        out_l[i] = (feedforward_1_l[i] * 0.34f) + (feedforward_2_l[i] * 0.14f) + (feedback_l * 0.14f);
+                        out_r[i] = (feedforward_1_r[i] * 0.34f) + (feedforward_2_r[i] * 0.14f) + (feedback_r * 0.14f);
+                    }
+
+                    allpass.process(poly_w, poly_w);
+                    allpass1.process(poly_w, poly_w);
+
+                    delay_l.write(write_l.data(), n);
+                    delay_r.write(write_r.data(), n);
+                    delay1_l.write(feedforward_1_l.data(), n);
+                    delay1_r.write(feedforward_1_r.data(), n);
+                    delay2_l.write(tap1_l.data(), n);
+                    delay2_r.write(tap1_r.data(), n);
+                    delay3_l.write(feedforward_2_l.data(), n);
+                    delay3_r.write(feedforward_2_r.data(), n);
+                }
+            }
 
-            Allpass<SampleBufferStatic<(9*(SAMPLE_RATE/1000))>> allpass_r;
-            Allpass<SampleBufferStatic<(11*(SAMPLE_RATE/1000))>> allpass1_r;
-            Delay<SampleBufferStatic<(5*(SAMPLE_RATE/1000))>>  delay_r;
-            Delay<SampleBufferStatic<(16*(SAMPLE_RATE/1000))>>  delay1_r;
-            NestedAllpass<SampleBufferStatic<(61 * (SAMPLE_RATE/1000))>,
-                        SampleBufferStatic<(86 * (SAMPLE_RATE/1000))>> nested_allpass_r;
-            Delay<SampleBufferStatic<(32*(SAMPLE_RATE/1000))>>  delay2_r;
-            Delay<SampleBufferStatic<(2*(SAMPLE_RATE/1000))>>  delay3_r;
-            DoubleNestedAllpass <SampleBufferStatic<31 *(SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<75 * (SAMPLE_RATE/1000)>,
-                                SampleBufferStatic<121*(SAMPLE_RATE/1000)>> double_nested_allpass_r;
-            OnepoleFilter dampening_r;
+            Lines _lines;
+            /** Left and right allpass chains, one lane each. */
+            AllpassBank<2> allpass;
+            AllpassBank<2> allpass1;
+            AudioRingBuffer delay_l;
+            AudioRingBuffer delay_r;
+            AudioRingBuffer delay1_l;
+            AudioRingBuffer delay1_r;
+            NestedAllpassBank<2> nested_allpass;
+            AudioRingBuffer delay2_l;
+            AudioRingBuffer delay2_r;
+            AudioRingBuffer delay3_l;
+            AudioRingBuffer delay3_r;
+            DoubleNestedAllpassBank<2> double_nested_allpass;
+            Sample feedback_l;
             Sample feedback_r;
 
+            /** Left and right feedback dampening. */
+            OnepoleBank<2> dampening;
+
             Sample gain;
             float dampen;
+
+            static constexpr size_t _block_size = 64;
+            std::array<std::array<Sample, _block_size>, 10> _scratch;
+
+            /** Skips the network once input and tail are silent. */
+            SilenceGate _silence;
     };
 
     template<size_t SAMPLE_RATE>
@@ -325,17 +683,18 @@ namespace idsp
         public:
             DattorroPlate():
             diffusion{FilterType::Lowpass, (9600*(1.f/SAMPLE_RATE))},
-            dampening_A{FilterType::Lowpass, (6500*(1.f/SAMPLE_RATE))},
-            dampening_B{FilterType::Lowpass, (6500*(1.f/SAMPLE_RATE))}
+            dampening{FilterType::Lowpass, (6500*(1.f/SAMPLE_RATE))}
             {
                 allpass1->set_gain(0.75f);
                 allpass2->set_gain(0.75f);
                 allpass3->set_gain(0.625f);
                 allpass4->set_gain(0.625f);
+                ap_mod_A->set_length(ap_mod_A_length);
                 ap_mod_A->set_gain(0.35f);
                 ap_mod_A->set_modulation_rate(0.7f*(1.f/SAMPLE_RATE));
                 ap_mod_A->set_sample_depth(50);
                 allpass_A->set_gain(0.5);
+                ap_mod_B->set_length(ap_mod_B_length);
                 ap_mod_B->set_gain(0.475f);
                 ap_mod_B->set_modulation_rate(0.6f*(1.f/SAMPLE_RATE));
                 ap_mod_B->set_sample_depth(50);
@@ -393,10 +752,10 @@ namespace idsp
                 feedbackA = delay2_A->read() * gain;
                 feedbackB = delay2_B->read() * gain;
 
-                Sample damp_out_A = dampening_A.process(delay1_A->read());
-                Sample damp_out_B = dampening_B.process(delay1_B->read());
-                delay2_A->write(allpass_A->process(damp_out_A));
-                delay2_B->write(allpass_B->process(damp_out_B));
+                std::array<Sample, 2> damp_out {delay1_A->read(), delay1_B->read()};
+                dampening.process(damp_out.data(), damp_out.data());
+                delay2_A->write(allpass_A->process(damp_out[0]));
+                delay2_B->write(allpass_B->process(damp_out[1]));
 
                 delay1_A->write(ap_mod_A->process(ap_out4 + feedbackB));
                 delay1_B->write(ap_mod_B->process(ap_out4 + feedbackA));
@@ -412,18 +771,21 @@ namespace idsp
             Allpass<SampleBufferStatic<static_cast<size_t>(12.721f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass3;
             Allpass<SampleBufferStatic<static_cast<size_t>(9.297f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass4;
 
-            ModulatedAllpass<SampleBufferStatic<static_cast<size_t>(12.f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> ap_mod_A;
+            static constexpr size_t ap_mod_A_length = static_cast<size_t>(12.f*(static_cast<float>(SAMPLE_RATE)/1000.f));
+            MaskedModulatedAllpass<next_power_of_two(ap_mod_A_length)> ap_mod_A;
             Delay<SampleBufferStatic<static_cast<size_t>(141.51f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> delay1_A;
-            OnepoleFilter dampening_A;
             Allpass<SampleBufferStatic<static_cast<size_t>(60.40f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass_A;
             Delay<SampleBufferStatic<static_cast<size_t>(105.238f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> delay2_A;
 
-            ModulatedAllpass<SampleBufferStatic<static_cast<size_t>(8.f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> ap_mod_B;
+            static constexpr size_t ap_mod_B_length = static_cast<size_t>(8.f*(static_cast<float>(SAMPLE_RATE)/1000.f));
+            MaskedModulatedAllpass<next_power_of_two(ap_mod_B_length)> ap_mod_B;
             Delay<SampleBufferStatic<static_cast<size_t>(149.433f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> delay1_B;
-            OnepoleFilter dampening_B;
             Allpass<SampleBufferStatic<static_cast<size_t>(89.32f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass_B;
             Delay<SampleBufferStatic<static_cast<size_t>(124.829f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> delay2_B;
 
+            /** Dampening of tanks A and B. */
+            OnepoleBank<2> dampening;
+
             Sample gain;
             Sample feedbackA;
             Sample feedbackB;
@@ -438,14 +800,17 @@ namespace idsp
             dampening_a{FilterType::Lowpass, (22000*(1.f/SAMPLE_RATE))},
             dampening_b{FilterType::Lowpass, (22000*(1.f/SAMPLE_RATE))}
             {
+                allpass1->set_length(allpass1_length);
                 allpass1->set_gain(0.625f);
                 allpass2->set_gain(0.625f);
                 allpass3->set_gain(0.625f);
                 allpass4->set_gain(0.625f);
+                del_a->set_length(del_a_length);
                 del_a->set_modulation_rate(0.3f*(1.f/SAMPLE_RATE));
                 del_a->set_sample_depth(100);
                 allpass1_a->set_gain(0.625f);
                 allpass2_a->set_gain(0.625f);
+                del_b->set_length(del_b_length);
                 del_b->set_modulation_rate(0.35f*(1.f/SAMPLE_RATE));
                 del_b->set_sample_depth(100);
                 allpass1_b->set_gain(0.625f);
@@ -496,17 +861,20 @@ namespace idsp
             }
 
 
-            ModulatedAllpass<SampleBufferStatic<static_cast<size_t>(4.76f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass1;
+            static constexpr size_t allpass1_length = static_cast<size_t>(4.76f * (static_cast<float>(SAMPLE_RATE)/1000.f));
+            MaskedModulatedAllpass<next_power_of_two(allpass1_length)> allpass1;
             Allpass<SampleBufferStatic<static_cast<size_t>(3.58f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass2;
             Allpass<SampleBufferStatic<static_cast<size_t>(12.721f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass3;
             Allpass<SampleBufferStatic<static_cast<size_t>(9.297f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass4;
 
-            ModulatedDelay<SampleBufferStatic<static_cast<size_t>(106.59375f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> del_a;
+            static constexpr size_t del_a_length = static_cast<size_t>(106.59375f*(static_cast<float>(SAMPLE_RATE)/1000.f));
+            MaskedModulatedDelay<next_power_of_two(del_a_length)> del_a;
             OnepoleFilter dampening_a;
             Allpass<SampleBufferStatic<static_cast<size_t>(51.625f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass1_a;
             Allpass<SampleBufferStatic<static_cast<size_t>(63.68725f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass2_a;
 
-            ModulatedDelay<SampleBufferStatic<static_cast<size_t>(149.4375f*(static_cast<float>(SAMPLE_RATE)/1000.f))>> del_b;
+            static constexpr size_t del_b_length = static_cast<size_t>(149.4375f*(static_cast<float>(SAMPLE_RATE)/1000.f));
+            MaskedModulatedDelay<next_power_of_two(del_b_length)> del_b;
             OnepoleFilter dampening_b;
             Allpass<SampleBufferStatic<static_cast<size_t>(59.78125f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass1_b;
             Allpass<SampleBufferStatic<static_cast<size_t>(51.96875f * (static_cast<float>(SAMPLE_RATE)/1000.f))>> allpass2_b;
@@ -523,10 +891,7 @@ namespace idsp
 
         public:
             FDN_4() :
-            dampening1{FilterType::Lowpass, (6500.f*(1.f/SAMPLE_RATE))},
-            dampening2{FilterType::Lowpass, (6500.f*(1.f/SAMPLE_RATE))},
-            dampening3{FilterType::Lowpass, (6500.f*(1.f/SAMPLE_RATE))},
-            dampening4{FilterType::Lowpass, (6500.f*(1.f/SAMPLE_RATE))},
+            dampening{FilterType::Lowpass, (6500.f*(1.f/SAMPLE_RATE))},
             decay{0}
             {}
 
@@ -559,10 +924,7 @@ namespace idsp
                 delay3->write(matrix_out[2]);
                 delay4->write(matrix_out[3]);
                 //dampening
-                matrix_in[0] = dampening1.process(matrix_in[0]);
-                matrix_in[1] = dampening2.process(matrix_in[1]);
-                matrix_in[2] = dampening3.process(matrix_in[2]);
-                matrix_in[3] = dampening4.process(matrix_in[3]);
+                dampening.process(matrix_in.data(), matrix_in.data());
                 // input
                 matrix_in[0] += in_l;
                 matrix_in[1] += in_l;
@@ -580,21 +942,12 @@ namespace idsp
                 out_r = matrix_in[1] * decay;
             }
 
-            inline void set_dampening(float f)
-            {
-                dampening1.set_cutoff(f * (1.f/SAMPLE_RATE));
-                dampening2.set_cutoff(f * (1.f/SAMPLE_RATE));
-                dampening3.set_cutoff(f * (1.f/SAMPLE_RATE));
-                dampening4.set_cutoff(f * (1.f/SAMPLE_RATE));
-            }
+            inline void set_dampening(float f) {dampening.set_cutoff(f * (1.f/SAMPLE_RATE));}
 
             inline void set_decay(float f) {decay = f * 0.5f;}
 
         private:
-            OnepoleFilter dampening1;
-            OnepoleFilter dampening2;
-            OnepoleFilter dampening3;
-            OnepoleFilter dampening4;
+            OnepoleBank<4> dampening;
 
             float decay;
 
@@ -610,6 +963,223 @@ namespace idsp
 
 
 
+    /** Feedback delay network reverb with 8 or 16 lines.
+     * The lines share one power-of-two DelayArena and are fed back through
+     * a fast Walsh-Hadamard transform, an orthogonal mix that costs
+     * Lines * log2(Lines) additions instead of a full matrix multiply.
+     * Even lines take and give the left channel, odd lines the right.
+     * Line lengths are primes spread evenly between 30 and 80 ms (8 lines)
+     * or 20 and 60 ms (16 lines), so the echoes never line up.
+     * Each chunk, no longer than the shortest line, is copied out of the
+     * arena a line at a time, then dampened, mixed and summed a frame at a
+     * time with the lines as the inner, fixed-length dimension.
+     * The setters match the rooms: set_gain() for the feedback gain,
+     * set_dampening() for how much of the lowpassed feedback is mixed in and
+     * set_cutoff() for the lowpass' normalised cutoff.
+     */
+    template<size_t SAMPLE_RATE, size_t Lines = 8>
+    class FDNReverb
+    {
+        static_assert(Lines == 8 || Lines == 16, "FDNReverb supports 8 or 16 lines.");
+
+        static constexpr bool _is_prime(size_t x)
+        {
+            for (size_t d = 2; d * d <= x; d++)
+                if (x % d == 0)
+                    return false;
+            return x > 1;
+        }
+
+        static constexpr size_t _length(size_t line)
+        {
+            const float first = Lines == 8 ? 30.f : 20.f;
+            const float last = Lines == 8 ? 80.f : 60.f;
+            const float ms = first + (last - first) * static_cast<float>(line) / static_cast<float>(Lines - 1);
+            size_t length = static_cast<size_t>(ms * (static_cast<float>(SAMPLE_RATE) / 1000.f));
+            while (!_is_prime(length))
+                length++;
+            return length;
+        }
+
+        static constexpr size_t _total_length(size_t line = 0)
+        {
+            return line < Lines ? _length(line) + _total_length(line + 1) : 0;
+        }
+
+        static std::array<size_t, Lines> _lengths()
+        {
+            std::array<size_t, Lines> lengths;
+            for (size_t n = 0; n < Lines; n++)
+                lengths[n] = _length(n);
+            return lengths;
+        }
+
+        public:
+            /** Samples of delay memory, the sum of the line lengths rounded
+             * up to a power of two. */
+            static constexpr size_t arena_size = next_power_of_two(_total_length());
+
+            FDNReverb():
+            gain{0},
+            dampen{0},
+            _x{},
+            _y{},
+            arena{_lengths()},
+            _silence{SAMPLE_RATE}
+            {
+                set_cutoff(6500*(1.f/SAMPLE_RATE));
+            }
+
+            /** Frame processor: one sample per channel. */
+            void process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
+            {
+                std::array<BufferInterface, 2> in {BufferInterface(const_cast<Sample*>(&in_l), 1), BufferInterface(const_cast<Sample*>(&in_r), 1)};
+                std::array<BufferInterface, 2> out {BufferInterface(&out_l, 1), BufferInterface(&out_r, 1)};
+                PolyBufferInterface poly_in(in.data(), 2), poly_out(out.data(), 2);
+                _process_block(poly_in, poly_out, 1);
+            }
+
+            /**assumes left/right/in/out buffers are all of equal length*/
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                _process_gated(input, output, input[0].size());
+            }
+
+            template<size_t N>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                _process_gated(input, output, N);
+            }
+
+            inline void set_gain(Sample g) {gain = g;}
+
+            inline void set_dampening(float f) {dampen = f;}
+
+            inline void set_cutoff(float f)
+            {
+                _input_gain = SampleCompute(OnepoleFilter::input_gain(f));
+                _feedback_gain = SampleCompute(OnepoleFilter::feedback_gain(f));
+            }
+
+            /** Input level at or below which, once the output has also stayed
+             * at or below the tail floor for a second, the block processors
+             * skip the network and write silence. Negative disables it. */
+            inline void set_silence_threshold(Sample threshold) {_silence.set_threshold(threshold);}
+
+            inline void set_tail_floor(Sample floor) {_silence.set_floor(floor);}
+
+            /** @returns True while silence is skipping the network. */
+            inline bool is_bypassed() const {return _silence.is_closed();}
+
+            /** @returns The length of @a line in samples. */
+            static constexpr size_t line_length(size_t line) {return _length(line);}
+
+        private:
+            void _process_gated(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                if (_silence.skip(input, output, num_frames))
+                    return;
+                _process_block(input, output, num_frames);
+                _silence.update(output, num_frames);
+            }
+
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                const size_t chunk = min(_block_size, arena.min_length());
+                for (size_t start = 0; start < num_frames; start += chunk)
+                {
+                    const size_t n = min(chunk, num_frames - start);
+                    const Sample* in_l = input[0].data() + start;
+                    const Sample* in_r = input[1].data() + start;
+                    Sample* out_l = output[0].data() + start;
+                    Sample* out_r = output[1].data() + start;
+                    // A constant trip count lets the compiler vectorise the
+                    // loops over full chunks without runtime checks
+                    if (n == _block_size)
+                        _process_chunk(in_l, in_r, out_l, out_r, std::integral_constant<size_t, _block_size>());
+                    else
+                        _process_chunk(in_l, in_r, out_l, out_r, n);
+                }
+            }
+
+            template<class Size>
+            void _process_chunk(const Sample* in_l, const Sample* in_r, Sample* out_l, Sample* out_r, Size n)
+            {
+                // Scales for the orthogonal transform and for spreading each
+                // channel over, and summing it from, half of the lines
+                const SampleCompute feedback = SampleCompute(gain * Sample(1.f / std::sqrt(static_cast<float>(Lines))));
+                const SampleCompute spread = SampleCompute(1.f / std::sqrt(static_cast<float>(Lines / 2)));
+                const SampleCompute wet = SampleCompute(dampen);
+
+                for (size_t line = 0; line < Lines; line++)
+                    arena.read_block(line, _taps[line].data(), n);
+
+                for (size_t i = 0; i < n; i++)
+                {
+                    // Dampening, mixed with the undampened feedback
+                    std::array<SampleCompute, Lines> frame;
+                    for (size_t line = 0; line < Lines; line++)
+                    {
+                        const SampleCompute x = SampleCompute(_taps[line][i]);
+                        const SampleCompute y = _input_gain * (x + _x[line]) - _feedback_gain * _y[line];
+                        _x[line] = x;
+                        _y[line] = y;
+                        frame[line] = x + wet * (y - x);
+                    }
+
+                    // Fast Walsh-Hadamard transform, unrolled over the lines
+                    for (size_t h = 1; h < Lines; h *= 2)
+                        for (size_t a = 0; a < Lines; a += 2 * h)
+                            for (size_t b = a; b < a + h; b++)
+                            {
+                                const SampleCompute x = frame[b];
+                                const SampleCompute y = frame[b + h];
+                                frame[b] = x + y;
+                                frame[b + h] = x - y;
+                            }
+
+                    // Input, alternating in sign between the lines of each
+                    // channel so it doesn't sit on one Hadamard basis vector
+                    const SampleCompute l = SampleCompute(in_l[i]) * spread;
+                    const SampleCompute r = SampleCompute(in_r[i]) * spread;
+                    SampleCompute sum_l = 0, sum_r = 0;
+                    for (size_t line = 0; line < Lines; line += 4)
+                    {
+                        _mix[line][i] = Sample(frame[line] * feedback + l);
+                        _mix[line + 1][i] = Sample(frame[line + 1] * feedback + r);
+                        _mix[line + 2][i] = Sample(frame[line + 2] * feedback - l);
+                        _mix[line + 3][i] = Sample(frame[line + 3] * feedback - r);
+                        sum_l += SampleCompute(_taps[line][i]) + SampleCompute(_taps[line + 2][i]);
+                        sum_r += SampleCompute(_taps[line + 1][i]) + SampleCompute(_taps[line + 3][i]);
+                    }
+                    out_l[i] = Sample(sum_l * spread);
+                    out_r[i] = Sample(sum_r * spread);
+                }
+
+                for (size_t line = 0; line < Lines; line++)
+                    arena.write_block(line, _mix[line].data(), n);
+                arena.advance(n);
+            }
+
+            static constexpr size_t _block_size = 64;
+
+            Sample gain;
+            float dampen;
+
+            /** Lowpass dampening shared by every line, see OnepoleFilter. */
+            SampleCompute _input_gain;
+            SampleCompute _feedback_gain;
+            std::array<SampleCompute, Lines> _x;
+            std::array<SampleCompute, Lines> _y;
+
+            DelayArena<arena_size, Lines> arena;
+            std::array<std::array<Sample, _block_size>, Lines> _taps;
+            std::array<std::array<Sample, _block_size>, Lines> _mix;
+
+            /** Skips the network once input and tail are silent. */
+            SilenceGate _silence;
+    };
+
 }// namespace idsp
 
 #endif
\ No newline at end of file
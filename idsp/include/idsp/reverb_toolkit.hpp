@@ -7,7 +7,9 @@
 #include "idsp/modulation.hpp"
 #include "idsp/buffer_types.hpp"
 
+#include <algorithm>
 #include <array>
+#include <utility>
 
 namespace idsp
 {
@@ -32,26 +34,24 @@ namespace idsp
                 return this->_process_sample(input);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
+            /** Block processor. Moves up to `_block_size` samples through the
+             * delay line per read/write. Works in place. */
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < input.size(); i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), input.size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < N; i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), N);
             }
 
             constexpr
             Sample read_offset(size_t offset) {return delay.read_offset(offset);}
 
             constexpr
-            void set_gain(float g) {gain = g;}
+            void set_gain(float g) {gain = SampleCompute(g);}
 
         private:
 
@@ -59,18 +59,41 @@ namespace idsp
             Sample _process_sample(const Sample input)
             {
                 // read the delay line to get w(n-D)
-                Sample wnD = delay.read();
+                SampleCompute wnD = SampleCompute(delay.read());
                 // form w(n) = x(n) + gw(n-D)
-                Sample wn = input + gain * wnD;
+                SampleCompute wn = SampleCompute(input) + gain * wnD;
                 // form y(n) = -gw(n) + w(n-D)
-                Sample yn = -gain*wn + wnD;
+                SampleCompute yn = -gain*wn + wnD;
                 // write delay line
-                delay.write(wn);
-                return yn;
+                delay.write(Sample(wn));
+                return Sample(yn);
+            }
+
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<Sample, _block_size> wnD, wn;
+                while (num_samples > 0)
+                {
+                    // A chunk no longer than the delay never reads what it writes
+                    const size_t n = min(min(num_samples, _block_size), delay.get_length());
+                    delay.read_block(delay.get_length(), wnD.data(), n);
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const SampleCompute w = SampleCompute(input[i]) + gain * SampleCompute(wnD[i]);
+                        wn[i] = Sample(w);
+                        output[i] = Sample(-gain*w + SampleCompute(wnD[i]));
+                    }
+                    delay.write(wn.data(), n);
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
             }
 
+            static constexpr size_t _block_size = 64;
+
             AudioRingBuffer delay;
-            float gain;
+            SampleCompute gain;
     };
 
     template<class BufferT>
@@ -79,11 +102,12 @@ namespace idsp
     /**
      * Mudulated-Allpass Filter
      * */
+    template<class RingBufferT = AudioRingBuffer>
     class ModulatedAllpassProcessor
     {
         public:
             ModulatedAllpassProcessor(BufferInterface& buff) :
-            delay{AudioRingBuffer(buff)},
+            delay{RingBufferT(buff)},
             gain{0.5},
             sample_depth{0},
             delay_samples{0},
@@ -115,7 +139,7 @@ namespace idsp
             Sample read_offset(size_t offset) {return delay.read_offset(offset);}
 
             constexpr
-            void set_gain(float g) {gain = g;}
+            void set_gain(float g) {gain = SampleCompute(g);}
 
             constexpr
             void set_modulation_depth(float f) {sample_depth *= f;}
@@ -126,33 +150,45 @@ namespace idsp
             constexpr
             void set_modulation_rate(float f) {lfo.set_rate(f);}
 
+            /**Sets the unmodulated delay D, for ring buffers larger than the delay*/
+            constexpr
+            void set_length(size_t length) {delay.set_length(length);}
+
         private:
 
             Sample _process_sample(const Sample input)
             {
                 //calculate modulation
-                Sample modulation = lfo.process() * sample_depth;
-                if(modulation > static_cast<float>(delay.get_size()-1)) modulation -= (delay.get_size()-1);
+                float modulation = lfo.process() * sample_depth;
+                if(modulation > static_cast<float>(delay.get_length()-1)) modulation -= (delay.get_length()-1);
                 // read the delay line to get w(n-D)
-                Sample wnD = delay.read_offset_smooth_wrap(static_cast<float>(delay.get_size()) - modulation);
+                SampleCompute wnD = SampleCompute(delay.read_offset_smooth_wrap(static_cast<float>(delay.get_length()) - modulation));
                 // form w(n) = x(n) + gw(n-D)
-                Sample wn = input + gain * wnD;
+                SampleCompute wn = SampleCompute(input) + gain * wnD;
                 // form y(n) = -gw(n) + w(n-D)
-                Sample yn = -gain*wn + wnD;
+                SampleCompute yn = -gain*wn + wnD;
                 // write delay line
-                delay.write(wn);
-                return yn;
+                delay.write(Sample(wn));
+                return Sample(yn);
             }
 
-            AudioRingBuffer delay;
-            float gain;
+            RingBufferT delay;
+            SampleCompute gain;
             float sample_depth;
             float delay_samples;
             WavetableOscillator<128> lfo;
     };
 
     template<class BufferT>
-    using ModulatedAllpass = ProcessWrapper<ModulatedAllpassProcessor, BufferT>;
+    using ModulatedAllpass = ProcessWrapper<ModulatedAllpassProcessor<>, BufferT>;
+
+    /**
+     * Mudulated-Allpass Filter on a mirrored power-of-two ring buffer of capacity S.
+     * The delay defaults to S, set_length() sets anything shorter.
+     * */
+    template<size_t S>
+    using MaskedModulatedAllpass = ProcessWrapper<ModulatedAllpassProcessor<MaskedAudioRingBuffer<S, true>>,
+                                                  SampleBufferStatic<MaskedAudioRingBuffer<S, true>::storage_size>>;
 
 
     /**
@@ -177,19 +213,17 @@ namespace idsp
                 return this->_process_sample(input);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
+            /** Block processor. Moves up to `_block_size` samples through the
+             * delay line per read/write. Works in place. */
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < input.size(); i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), input.size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < N; i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), N);
             }
 
             constexpr
@@ -198,7 +232,7 @@ namespace idsp
             constexpr
             void set_gain(float g0, float g1)
             {
-                gain = g0;
+                gain = SampleCompute(g0);
                 allpass.set_gain(g1);
             }
 
@@ -208,21 +242,46 @@ namespace idsp
             Sample _process_sample(const Sample input)
             {
                 // read the delay line to get w(n-D)
-                Sample wnD = delay.read();
+                SampleCompute wnD = SampleCompute(delay.read());
                 // form w(n) = x(n) + gw(n-D)
-                Sample wn = input + gain * wnD;
+                SampleCompute wn = SampleCompute(input) + gain * wnD;
                 // process wn through inner APF
-                Sample y_inner = allpass.process(wn);
+                Sample y_inner = allpass.process(Sample(wn));
                 // form y(n) = -gw(n) + w(n-D)
-                Sample yn = -gain*wn + wnD;
+                SampleCompute yn = -gain*wn + wnD;
                 // write delay line
                 delay.write(y_inner);
-                return yn;
+                return Sample(yn);
+            }
+
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<Sample, _block_size> wnD, wn;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(min(num_samples, _block_size), delay.get_length());
+                    delay.read_block(delay.get_length(), wnD.data(), n);
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const SampleCompute w = SampleCompute(input[i]) + gain * SampleCompute(wnD[i]);
+                        wn[i] = Sample(w);
+                        output[i] = Sample(-gain*w + SampleCompute(wnD[i]));
+                    }
+                    // the inner APF only touches its own delay line, so it can run over the whole chunk
+                    BufferInterface inner(wn.data(), n);
+                    allpass.process(inner, inner);
+                    delay.write(wn.data(), n);
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
             }
 
+            static constexpr size_t _block_size = 64;
+
             AudioRingBuffer delay;
             AllpassProcessor allpass;
-            float gain;
+            SampleCompute gain;
     };
 
     template<class BufferT, class NestedBufferT>
@@ -270,19 +329,17 @@ namespace idsp
                 return this->_process_sample(input);
             }
 
-            IDSP_CONSTEXPR_SINCE_CXX14
+            /** Block processor. Moves up to `_block_size` samples through the
+             * delay line per read/write. Works in place. */
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < input.size(); i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), input.size());
             }
 
             template<size_t N>
-            IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < N; i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), N);
             }
 
             constexpr
@@ -291,7 +348,7 @@ namespace idsp
             constexpr
             void set_gain(float g0, float g1, float g2)
             {
-                gain = g0;
+                gain = SampleCompute(g0);
                 allpass1.set_gain(g1);
                 allpass2.set_gain(g2);
             }
@@ -302,24 +359,49 @@ namespace idsp
             Sample _process_sample(const Sample input)
             {
                 // read the delay line to get w(n-D)
-                Sample wnD = delay.read();
+                SampleCompute wnD = SampleCompute(delay.read());
                 // form w(n) = x(n) + gw(n-D)
-                Sample wn = input + gain * wnD;
+                SampleCompute wn = SampleCompute(input) + gain * wnD;
                 // process wn through inner APF
-                Sample y_inner = allpass1.process(wn);
+                Sample y_inner = allpass1.process(Sample(wn));
                 // process y_inner through 2nd APF
                 Sample y_outer = allpass2.process(y_inner);
                 // form y(n) = -gw(n) + w(n-D)
-                Sample yn = -gain*wn + wnD;
+                SampleCompute yn = -gain*wn + wnD;
                 // write delay line
                 delay.write(y_outer);
-                return yn;
+                return Sample(yn);
+            }
+
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<Sample, _block_size> wnD, wn;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(min(num_samples, _block_size), delay.get_length());
+                    delay.read_block(delay.get_length(), wnD.data(), n);
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const SampleCompute w = SampleCompute(input[i]) + gain * SampleCompute(wnD[i]);
+                        wn[i] = Sample(w);
+                        output[i] = Sample(-gain*w + SampleCompute(wnD[i]));
+                    }
+                    BufferInterface inner(wn.data(), n);
+                    allpass1.process(inner, inner);
+                    allpass2.process(inner, inner);
+                    delay.write(wn.data(), n);
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
             }
 
+            static constexpr size_t _block_size = 64;
+
             AudioRingBuffer delay;
             AllpassProcessor allpass1;
             AllpassProcessor allpass2;
-            float gain;
+            SampleCompute gain;
     };
 
     template<class BufferT, class Buffer1T, class Buffer2T>
@@ -344,20 +426,353 @@ namespace idsp
             DoubleNestedAllpassProcessor processor;
     };
 
+    namespace _toolkit
+    {
+        /** @returns Ring buffers on the @a N consecutive interfaces at @a buffers. */
+        template<size_t N, size_t... I>
+        std::array<AudioRingBuffer, N> ring_buffers(BufferInterface* buffers, std::index_sequence<I...>)
+        {
+            return {{AudioRingBuffer(buffers[I])...}};
+        }
+    } // namespace _toolkit
+
+    /**
+     * Allpass Filter Bank
+     * N allpass filters with their own delay lines and gains, processed a
+     * frame (one sample per filter) at a time so the arithmetic runs across
+     * the filters, as in OnepoleBank. Lanes can be the left and right stages
+     * of a stereo network, or the same stage of several networks.
+     * */
+    template<size_t N>
+    class AllpassBank
+    {
+        static_assert(N > 0, "AllpassBank needs at least one filter.");
+
+        public:
+            /** @param buffers N consecutive delay buffers, one per filter. */
+            AllpassBank(BufferInterface* buffers):
+            delays{_toolkit::ring_buffers<N>(buffers, std::make_index_sequence<N>())}
+            {
+                this->gain.fill(SampleCompute(0.5));
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~AllpassBank() = default;
+
+            /** Frame processor: one sample per filter. Works in place. */
+            void process(const Sample* input, Sample* output)
+            {
+                std::array<SampleCompute, N> wnD, wn;
+                for (size_t n = 0; n < N; n++)
+                    wnD[n] = SampleCompute(this->delays[n].read());
+                for (size_t n = 0; n < N; n++)
+                {
+                    wn[n] = SampleCompute(input[n]) + this->gain[n] * wnD[n];
+                    output[n] = Sample(-this->gain[n] * wn[n] + wnD[n]);
+                }
+                for (size_t n = 0; n < N; n++)
+                    this->delays[n].write(Sample(wn[n]));
+            }
+
+            /** Planar block processor: one buffer per filter. Works in place. */
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                for (size_t n = 0; n < N; n++)
+                    this->_process_block(n, input[n].data(), output[n].data(), input[n].size());
+            }
+
+            template<size_t Bs>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                for (size_t n = 0; n < N; n++)
+                    this->_process_block(n, input[n].data(), output[n].data(), Bs);
+            }
+
+            /** Sets the gain of filter @a n. */
+            constexpr
+            void set_gain(size_t n, float g) {this->gain[n] = SampleCompute(g);}
+
+            /** Sets the gain of every filter. */
+            constexpr
+            void set_gain(float g) {this->gain.fill(SampleCompute(g));}
+
+        private:
+            // Same chunking as AllpassProcessor, one filter at a time
+            void _process_block(size_t n, const Sample* input, Sample* output, size_t num_samples)
+            {
+                auto& delay = this->delays[n];
+                const SampleCompute g = this->gain[n];
+                std::array<Sample, _block_size> wnD, wn;
+                while (num_samples > 0)
+                {
+                    const size_t count = min(min(num_samples, _block_size), delay.get_length());
+                    delay.read_block(delay.get_length(), wnD.data(), count);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        const SampleCompute w = SampleCompute(input[i]) + g * SampleCompute(wnD[i]);
+                        wn[i] = Sample(w);
+                        output[i] = Sample(-g*w + SampleCompute(wnD[i]));
+                    }
+                    delay.write(wn.data(), count);
+                    input += count;
+                    output += count;
+                    num_samples -= count;
+                }
+            }
+
+            static constexpr size_t _block_size = 64;
+
+            std::array<AudioRingBuffer, N> delays;
+            std::array<SampleCompute, N> gain;
+    };
+
+    /**
+     * Nested Allpass Filter Bank
+     * N nested allpass filters processed a frame at a time, see AllpassBank.
+     * */
+    template<size_t N>
+    class NestedAllpassBank
+    {
+        public:
+            /** @param buffers N consecutive outer delay buffers, one per filter.
+             * @param buffers1 The N inner allpass buffers. */
+            NestedAllpassBank(BufferInterface* buffers, BufferInterface* buffers1):
+            delays{_toolkit::ring_buffers<N>(buffers, std::make_index_sequence<N>())},
+            allpass{buffers1}
+            {
+                this->gain.fill(SampleCompute(0.5));
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~NestedAllpassBank() = default;
+
+            /** Frame processor: one sample per filter. Works in place. */
+            void process(const Sample* input, Sample* output)
+            {
+                std::array<SampleCompute, N> wnD;
+                std::array<Sample, N> wn;
+                for (size_t n = 0; n < N; n++)
+                    wnD[n] = SampleCompute(this->delays[n].read());
+                for (size_t n = 0; n < N; n++)
+                {
+                    const SampleCompute w = SampleCompute(input[n]) + this->gain[n] * wnD[n];
+                    wn[n] = Sample(w);
+                    output[n] = Sample(-this->gain[n] * w + wnD[n]);
+                }
+                this->allpass.process(wn.data(), wn.data());
+                for (size_t n = 0; n < N; n++)
+                    this->delays[n].write(wn[n]);
+            }
+
+            /** Planar block processor: one buffer per filter. Works in place. */
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, input[0].size());
+            }
+
+            template<size_t Bs>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, Bs);
+            }
+
+            /** Sets the outer and inner gains of filter @a n. */
+            constexpr
+            void set_gain(size_t n, float g0, float g1)
+            {
+                this->gain[n] = SampleCompute(g0);
+                this->allpass.set_gain(n, g1);
+            }
+
+            /** Sets the outer and inner gains of every filter. */
+            constexpr
+            void set_gain(float g0, float g1)
+            {
+                this->gain.fill(SampleCompute(g0));
+                this->allpass.set_gain(g1);
+            }
+
+        private:
+            // Same chunking as NestedAllpassProcessor, across all filters
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_samples)
+            {
+                size_t chunk = _block_size;
+                for (size_t n = 0; n < N; n++)
+                    chunk = min(chunk, this->delays[n].get_length());
+                for (size_t start = 0; start < num_samples; start += chunk)
+                {
+                    const size_t count = min(chunk, num_samples - start);
+                    std::array<BufferInterface, N> inner;
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        auto& delay = this->delays[n];
+                        const SampleCompute g = this->gain[n];
+                        const Sample* in = input[n].data() + start;
+                        Sample* out = output[n].data() + start;
+                        delay.read_block(delay.get_length(), this->_wnD[n].data(), count);
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const SampleCompute w = SampleCompute(in[i]) + g * SampleCompute(this->_wnD[n][i]);
+                            this->_wn[n][i] = Sample(w);
+                            out[i] = Sample(-g*w + SampleCompute(this->_wnD[n][i]));
+                        }
+                        inner[n] = BufferInterface(this->_wn[n].data(), count);
+                    }
+                    // the inner APFs only touch their own delay lines, so they
+                    // can run over the whole chunk
+                    PolyBufferInterface poly_inner(inner.data(), N);
+                    this->allpass.process(poly_inner, poly_inner);
+                    for (size_t n = 0; n < N; n++)
+                        this->delays[n].write(this->_wn[n].data(), count);
+                }
+            }
+
+            static constexpr size_t _block_size = 64;
+
+            std::array<AudioRingBuffer, N> delays;
+            AllpassBank<N> allpass;
+            std::array<SampleCompute, N> gain;
+            std::array<std::array<Sample, _block_size>, N> _wnD, _wn;
+    };
+
+    /**
+     * Double Nested Allpass Filter Bank
+     * N double nested allpass filters processed a frame at a time, see
+     * AllpassBank.
+     * */
+    template<size_t N>
+    class DoubleNestedAllpassBank
+    {
+        public:
+            /** @param buffers N consecutive outer delay buffers, one per filter.
+             * @param buffers1 The N first inner allpass buffers.
+             * @param buffers2 The N second inner allpass buffers. */
+            DoubleNestedAllpassBank(BufferInterface* buffers, BufferInterface* buffers1, BufferInterface* buffers2):
+            delays{_toolkit::ring_buffers<N>(buffers, std::make_index_sequence<N>())},
+            allpass1{buffers1},
+            allpass2{buffers2}
+            {
+                this->gain.fill(SampleCompute(0.5));
+            }
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~DoubleNestedAllpassBank() = default;
+
+            /** Frame processor: one sample per filter. Works in place. */
+            void process(const Sample* input, Sample* output)
+            {
+                std::array<SampleCompute, N> wnD;
+                std::array<Sample, N> wn;
+                for (size_t n = 0; n < N; n++)
+                    wnD[n] = SampleCompute(this->delays[n].read());
+                for (size_t n = 0; n < N; n++)
+                {
+                    const SampleCompute w = SampleCompute(input[n]) + this->gain[n] * wnD[n];
+                    wn[n] = Sample(w);
+                    output[n] = Sample(-this->gain[n] * w + wnD[n]);
+                }
+                this->allpass1.process(wn.data(), wn.data());
+                this->allpass2.process(wn.data(), wn.data());
+                for (size_t n = 0; n < N; n++)
+                    this->delays[n].write(wn[n]);
+            }
+
+            /** Planar block processor: one buffer per filter. Works in place. */
+            void process(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, input[0].size());
+            }
+
+            template<size_t Bs>
+            void process_for(const PolyBufferInterface& input, PolyBufferInterface& output)
+            {
+                this->_process_block(input, output, Bs);
+            }
+
+            /** Sets the outer and both inner gains of filter @a n. */
+            constexpr
+            void set_gain(size_t n, float g0, float g1, float g2)
+            {
+                this->gain[n] = SampleCompute(g0);
+                this->allpass1.set_gain(n, g1);
+                this->allpass2.set_gain(n, g2);
+            }
+
+            /** Sets the outer and both inner gains of every filter. */
+            constexpr
+            void set_gain(float g0, float g1, float g2)
+            {
+                this->gain.fill(SampleCompute(g0));
+                this->allpass1.set_gain(g1);
+                this->allpass2.set_gain(g2);
+            }
+
+        private:
+            // Same chunking as DoubleNestedAllpassProcessor, across all filters
+            void _process_block(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_samples)
+            {
+                size_t chunk = _block_size;
+                for (size_t n = 0; n < N; n++)
+                    chunk = min(chunk, this->delays[n].get_length());
+                for (size_t start = 0; start < num_samples; start += chunk)
+                {
+                    const size_t count = min(chunk, num_samples - start);
+                    std::array<BufferInterface, N> inner;
+                    for (size_t n = 0; n < N; n++)
+                    {
+                        auto& delay = this->delays[n];
+                        const SampleCompute g = this->gain[n];
+                        const Sample* in = input[n].data() + start;
+                        Sample* out = output[n].data() + start;
+                        delay.read_block(delay.get_length(), this->_wnD[n].data(), count);
+                        for (size_t i = 0; i < count; i++)
+                        {
+                            const SampleCompute w = SampleCompute(in[i]) + g * SampleCompute(this->_wnD[n][i]);
+                            this->_wn[n][i] = Sample(w);
+                            out[i] = Sample(-g*w + SampleCompute(this->_wnD[n][i]));
+                        }
+                        inner[n] = BufferInterface(this->_wn[n].data(), count);
+                    }
+                    PolyBufferInterface poly_inner(inner.data(), N);
+                    this->allpass1.process(poly_inner, poly_inner);
+                    this->allpass2.process(poly_inner, poly_inner);
+                    for (size_t n = 0; n < N; n++)
+                        this->delays[n].write(this->_wn[n].data(), count);
+                }
+            }
+
+            static constexpr size_t _block_size = 64;
+
+            std::array<AudioRingBuffer, N> delays;
+            AllpassBank<N> allpass1;
+            AllpassBank<N> allpass2;
+            std::array<SampleCompute, N> gain;
+            std::array<std::array<Sample, _block_size>, N> _wnD, _wn;
+    };
+
     /**
     * Delay
     */
     template<class BufferT>
     using Delay = ProcessWrapper<AudioRingBuffer, BufferT>;
 
+    /**
+    * Delay on a power-of-two ring buffer of capacity S, see MaskedAudioRingBuffer
+    */
+    template<size_t S, bool Mirrored = false>
+    using MaskedDelay = ProcessWrapper<MaskedAudioRingBuffer<S, Mirrored>, SampleBufferStatic<MaskedAudioRingBuffer<S, Mirrored>::storage_size>>;
+
     /**
     * Modulated Delay
     */
+    template<class RingBufferT = AudioRingBuffer>
     class ModDelayProcessor
     {
         public:
             ModDelayProcessor(BufferInterface& buff) :
-            delay{AudioRingBuffer(buff)},
+            delay{RingBufferT(buff)},
+            modulation_depth{1.f},
+            sample_depth{1.f},
             lfo(idsp::Waveform::triangle, false)
             {}
 
@@ -392,7 +807,7 @@ namespace idsp
             inline void set_modulation_depth(float f) {modulation_depth = clamp(f, 0.f, 1.f);}
 
             constexpr
-            inline void set_sample_depth(float f) {sample_depth = clamp(f, 1.f, static_cast<float>(delay.get_size()) -1.f);}
+            inline void set_sample_depth(float f) {sample_depth = clamp(f, 1.f, static_cast<float>(delay.get_length()) -1.f);}
 
             constexpr
             inline void set_modulation_rate(float f) {lfo.set_rate(f);}
@@ -400,17 +815,21 @@ namespace idsp
             constexpr
             inline size_t get_size() {return delay.get_size();}
 
+            /**Sets the unmodulated delay, for ring buffers larger than the delay*/
+            constexpr
+            inline void set_length(size_t length) {delay.set_length(length);}
+
         private:
             inline Sample _process_sample(const Sample input)
             {
-                Sample modulation = lfo.process() * (sample_depth * modulation_depth);
-                if(modulation > static_cast<float>(delay.get_size()-1)) modulation -= (delay.get_size()-1);
-                Sample output = delay.read_offset_smooth_wrap(static_cast<float>(delay.get_size()) - modulation);
+                float modulation = lfo.process() * (sample_depth * modulation_depth);
+                if(modulation > static_cast<float>(delay.get_length()-1)) modulation -= (delay.get_length()-1);
+                Sample output = delay.read_offset_smooth_wrap(static_cast<float>(delay.get_length()) - modulation);
                 delay.write(input);
                 return output;
             }
 
-            AudioRingBuffer delay;
+            RingBufferT delay;
             float modulation_depth;
             float sample_depth;
             float delay_samples;
@@ -418,7 +837,15 @@ namespace idsp
 
     };
     template<class BufferT>
-    using ModulatedDelay = ProcessWrapper<ModDelayProcessor, BufferT>;
+    using ModulatedDelay = ProcessWrapper<ModDelayProcessor<>, BufferT>;
+
+    /**
+    * Modulated Delay on a mirrored power-of-two ring buffer of capacity S.
+    * The delay defaults to S, set_length() sets anything shorter.
+    */
+    template<size_t S>
+    using MaskedModulatedDelay = ProcessWrapper<ModDelayProcessor<MaskedAudioRingBuffer<S, true>>,
+                                                SampleBufferStatic<MaskedAudioRingBuffer<S, true>::storage_size>>;
 
     template<size_t SAMPLE_RATE>
 	class DiffuserRev3
@@ -436,29 +863,64 @@ namespace idsp
             IDSP_CONSTEXPR_SINCE_CXX14
 			inline void process_for(const PolyBufferInterface &input, PolyBufferInterface &output)
 			{
-				for(size_t i = 0; i < N; i++)
-					process(input[0][i], input[1][i], output[0][i], output[1][i]);
+				_process_block(input[0].data(), input[1].data(), output[0].data(), output[1].data(), N);
 			}
 
 			inline void process(const Sample in_l, const Sample in_r, Sample& out_l, Sample& out_r)
 			{
 				for(size_t tap = 0; tap < num_taps; tap++)
-					out[tap] = delay[tap]->read();
+					out[tap] = SampleCompute(delay[tap]->read());
 
-				out_l = ((out[2] + (out[1] + (out[0] + in_l))) * normalisation);
-				out_r = out[3] * normalisation;
+				const SampleCompute l = SampleCompute(in_l);
+				out_l = Sample((out[2] + (out[1] + (out[0] + l))) * normalisation);
+				out_r = Sample(out[3] * normalisation);
 
 				delay[0]->write(in_r);
-				delay[1]->write(in_l - out[0]);
-				delay[2]->write((out[0] + in_l) - out[1]);
-				delay[3]->write((out[1] + (out[0] + in_l)) - out[2]);
+				delay[1]->write(Sample(l - out[0]));
+				delay[2]->write(Sample((out[0] + l) - out[1]));
+				delay[3]->write(Sample((out[1] + (out[0] + l)) - out[2]));
 			}
 
 		private:
+			// Each chunk is no longer than the shortest tap, so every tap can be
+			// read for the whole chunk before any of them is written
+			inline void _process_block(const Sample* in_l, const Sample* in_r, Sample* out_l, Sample* out_r, size_t num_samples)
+			{
+				std::array<std::array<Sample, _block_size>, num_taps> taps;
+				std::array<Sample, _block_size> right;
+				while (num_samples > 0)
+				{
+					const size_t n = min(min(num_samples, _block_size), delay[0]->get_length());
+					for(size_t tap = 0; tap < num_taps; tap++)
+						delay[tap]->read_block(delay[tap]->get_length(), taps[tap].data(), n);
+					std::copy_n(in_r, n, right.data());
+					for(size_t i = 0; i < n; i++)
+					{
+						for(size_t tap = 0; tap < num_taps; tap++)
+							out[tap] = SampleCompute(taps[tap][i]);
+						const SampleCompute l = SampleCompute(in_l[i]);
+						out_l[i] = Sample((out[2] + (out[1] + (out[0] + l))) * normalisation);
+						out_r[i] = Sample(out[3] * normalisation);
+						taps[0][i] = right[i];
+						taps[1][i] = Sample(l - out[0]);
+						taps[2][i] = Sample((out[0] + l) - out[1]);
+						taps[3][i] = Sample((out[1] + (out[0] + l)) - out[2]);
+					}
+					for(size_t tap = 0; tap < num_taps; tap++)
+						delay[tap]->write(taps[tap].data(), n);
+					in_l += n;
+					in_r += n;
+					out_l += n;
+					out_r += n;
+					num_samples -= n;
+				}
+			}
+
+			static constexpr size_t _block_size = 64;
 			static constexpr size_t num_taps = 4;
 			std::array<Delay<SampleBufferStatic<static_cast<size_t>(7.82312f * (static_cast<float>(SAMPLE_RATE)/1000.f))>>, num_taps> delay;
-			std::array<Sample, num_taps> out;
-			static constexpr float normalisation = 0.34;
+			std::array<SampleCompute, num_taps> out;
+			static constexpr SampleCompute normalisation {SampleCompute(0.34)};
 	};
 
 
@@ -480,31 +942,266 @@ namespace idsp
             IDSP_CONSTEXPR_SINCE_CXX14
 			inline void process_for(const PolyBufferInterface &input, PolyBufferInterface &output)
 			{
-				for(size_t i = 0; i < N; i++)
-					process(input[0][i], input[1][i], output[0][i], output[1][i]);
+				_process_block(input[0].data(), input[1].data(), output[0].data(), output[1].data(), N);
 			}
 
 			inline void process(const Sample in_l, Sample in_r, Sample& out_l, Sample& out_r)
 			{
 				for(size_t tap = 0; tap < num_taps; tap++)
-					out[tap] = delay[tap]->read();
+					out[tap] = SampleCompute(delay[tap]->read());
 
-				out_l = (out[4] + (out[3] + (out[2] +(out[1] +(out[0] + in_l))))) * normalisation;
-				out_r = out[5] * normalisation;
+				const SampleCompute l = SampleCompute(in_l);
+				out_l = Sample((out[4] + (out[3] + (out[2] +(out[1] +(out[0] + l))))) * normalisation);
+				out_r = Sample(out[5] * normalisation);
 
 				delay[0]->write(in_r);
-				delay[1]->write(in_l - out[0]);
-				delay[2]->write((out[0] + in_l) - out[1]);
-				delay[3]->write((out[1] + (out[0] + in_l)) - out[2]);
-				delay[4]->write((out[2] + (out[1] + (out[0] + in_l))) - out[3]);
-				delay[5]->write((out[3] + (out[2] + (out[1] + (out[0] + in_l)))) - out[4]);
+				delay[1]->write(Sample(l - out[0]));
+				delay[2]->write(Sample((out[0] + l) - out[1]));
+				delay[3]->write(Sample((out[1] + (out[0] + l)) - out[2]));
+				delay[4]->write(Sample((out[2] + (out[1] + (out[0] + l))) - out[3]));
+				delay[5]->write(Sample((out[3] + (out[2] + (out[1] + (out[0] + l)))) - out[4]));
 			}
 
         private:
+            inline void _process_block(const Sample* in_l, const Sample* in_r, Sample* out_l, Sample* out_r, size_t num_samples)
+            {
+                std::array<std::array<Sample, _block_size>, num_taps> taps;
+                std::array<Sample, _block_size> right;
+                while (num_samples > 0)
+                {
+                    const size_t n = min(min(num_samples, _block_size), delay[5]->get_length());
+                    for(size_t tap = 0; tap < num_taps; tap++)
+                        delay[tap]->read_block(delay[tap]->get_length(), taps[tap].data(), n);
+                    std::copy_n(in_r, n, right.data());
+                    for(size_t i = 0; i < n; i++)
+                    {
+                        for(size_t tap = 0; tap < num_taps; tap++)
+                            out[tap] = SampleCompute(taps[tap][i]);
+                        const SampleCompute l = SampleCompute(in_l[i]);
+                        out_l[i] = Sample((out[4] + (out[3] + (out[2] +(out[1] +(out[0] + l))))) * normalisation);
+                        out_r[i] = Sample(out[5] * normalisation);
+                        taps[0][i] = right[i];
+                        taps[1][i] = Sample(l - out[0]);
+                        taps[2][i] = Sample((out[0] + l) - out[1]);
+                        taps[3][i] = Sample((out[1] + (out[0] + l)) - out[2]);
+                        taps[4][i] = Sample((out[2] + (out[1] + (out[0] + l))) - out[3]);
+                        taps[5][i] = Sample((out[3] + (out[2] + (out[1] + (out[0] + l)))) - out[4]);
+                    }
+                    for(size_t tap = 0; tap < num_taps; tap++)
+                        delay[tap]->write(taps[tap].data(), n);
+                    in_l += n;
+                    in_r += n;
+                    out_l += n;
+                    out_r += n;
+                    num_samples -= n;
+                }
+            }
+
+            static constexpr size_t _block_size = 64;
             static constexpr size_t num_taps = 6;
             std::array<Delay<SampleBufferStatic<static_cast<size_t>(43.5337f  * (static_cast<float>(SAMPLE_RATE)/1000.f))>>, num_taps> delay;
-            std::array<Sample, num_taps> out;
-            static constexpr float normalisation = 0.28;
+            std::array<SampleCompute, num_taps> out;
+            static constexpr SampleCompute normalisation {SampleCompute(0.28)};
+    };
+
+    /**
+    * Silence Gate
+    * Tracks the peak level of a reverb's input and output block by block, so
+    * the network can be skipped once everything in it has died away.
+    * The gate closes when the input has stayed at or below the threshold,
+    * and the output at or below the floor, for at least the hold time: long
+    * enough for anything left in the delay lines to have reached the output.
+    * Any input above the threshold opens it again. The network then picks up
+    * from the state it was left in, which is below the floor.
+    * A negative threshold keeps the gate open.
+    */
+    class SilenceGate
+    {
+        public:
+            /** The default levels are one 16-bit LSB. */
+            SilenceGate(size_t hold_frames, Sample threshold = Sample(1.f / 32768.f), Sample floor = Sample(1.f / 32768.f)):
+            _threshold{threshold},
+            _floor{floor},
+            _hold{hold_frames},
+            _quiet_frames{0},
+            _input_quiet{false},
+            _closed{false}
+            {}
+
+            inline void set_threshold(Sample threshold) {this->_threshold = threshold;}
+
+            inline void set_floor(Sample floor) {this->_floor = floor;}
+
+            inline void set_hold(size_t hold_frames) {this->_hold = hold_frames;}
+
+            /** @returns True while the network is being skipped. */
+            inline bool is_closed() const {return this->_closed;}
+
+            /** Checks the next @a num_frames of @a input, before they are
+             * processed. If the gate stays closed, @a output is silenced.
+             * @returns True if the network can be skipped for this block. */
+            bool skip(const PolyBufferInterface& input, PolyBufferInterface& output, size_t num_frames)
+            {
+                this->_input_quiet = _is_below(input, num_frames, this->_threshold);
+                if (!this->_input_quiet)
+                {
+                    this->_closed = false;
+                    this->_quiet_frames = 0;
+                }
+                if (!this->_closed)
+                    return false;
+                for (size_t c = 0; c < output.size(); c++)
+                    std::fill_n(output[c].data(), num_frames, Sample(0));
+                return true;
+            }
+
+            /** Checks the @a num_frames of @a output the network produced for
+             * the block last passed to skip(). */
+            void update(const PolyBufferInterface& output, size_t num_frames)
+            {
+                if (this->_input_quiet && _is_below(output, num_frames, this->_floor))
+                {
+                    this->_quiet_frames += num_frames;
+                    this->_closed = this->_quiet_frames >= this->_hold;
+                }
+                else
+                    this->_quiet_frames = 0;
+            }
+
+        private:
+            static bool _is_below(const PolyBufferInterface& buffers, size_t num_frames, Sample level)
+            {
+                for (size_t c = 0; c < buffers.size(); c++)
+                {
+                    const Sample* data = buffers[c].data();
+                    Sample lowest = Sample(0), highest = Sample(0);
+                    for (size_t i = 0; i < num_frames; i++)
+                    {
+                        lowest = min(lowest, data[i]);
+                        highest = max(highest, data[i]);
+                    }
+                    if (highest > level || lowest < -level)
+                        return false;
+                }
+                return true;
+            }
+
+            Sample _threshold;
+            Sample _floor;
+            size_t _hold;
+            size_t _quiet_frames;
+            bool _input_quiet;
+            bool _closed;
+    };
+
+    /**
+    * Delay Arena
+    * Lines delay lines of fixed lengths sharing one power-of-two ring of
+    * Capacity samples and a single write index. Line n occupies the span
+    * just behind line n + 1, and all spans rotate together, so they never
+    * overlap: the ring only has to hold the sum of the lengths.
+    * Each frame, every line must be read before any is written, since line
+    * n writes where line n + 1 reads. Reading and writing whole chunks no
+    * longer than the shortest line keeps that order.
+    */
+    template<size_t Capacity, size_t Lines>
+    class DelayArena
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Arena capacity must be a power of two.");
+
+        public:
+            static constexpr size_t capacity = Capacity;
+
+            /** @note The lengths must sum to no more than Capacity. */
+            explicit DelayArena(const std::array<size_t, Lines>& lengths):
+            _write_index{0}
+            {
+                size_t end = 0;
+                for (size_t n = 0; n < Lines; n++)
+                {
+                    this->_lengths[n] = lengths[n];
+                    this->_starts[n] = end;
+                    end += lengths[n];
+                }
+                this->erase();
+            }
+
+            /** @returns The capacity that @a lengths need. */
+            static constexpr size_t required(const std::array<size_t, Lines>& lengths, size_t n = 0)
+            {
+                return n < Lines ? lengths[n] + required(lengths, n + 1) : 0;
+            }
+
+            inline size_t get_length(size_t line) const {return this->_lengths[line];}
+
+            /** @returns The shortest line, the longest chunk that can be
+             * moved through the arena at once. */
+            inline size_t min_length() const
+            {
+                size_t shortest = this->_lengths[0];
+                for (size_t n = 1; n < Lines; n++)
+                    shortest = min(shortest, this->_lengths[n]);
+                return shortest;
+            }
+
+            /** Reads the next @a num_samples outputs of @a line: the samples
+             * written to it one line length before the current frame. */
+            inline void read_block(size_t line, Sample* output, size_t num_samples) const
+            {
+                this->_copy_out(this->_write_index + this->_starts[line], output, num_samples);
+            }
+
+            /** Writes the next @a num_samples inputs of @a line. */
+            inline void write_block(size_t line, const Sample* input, size_t num_samples)
+            {
+                this->_copy_in(this->_write_index + this->_starts[line] + this->_lengths[line], input, num_samples);
+            }
+
+            /** Moves every line on by @a num_samples frames, once each line
+             * has been read and written for them. */
+            inline void advance(size_t num_samples)
+            {
+                this->_write_index = (this->_write_index + num_samples) & _mask;
+            }
+
+            inline void erase()
+            {
+                this->_data.fill(Sample(0));
+            }
+
+        private:
+            inline void _copy_out(size_t pos, Sample* output, size_t num_samples) const
+            {
+                while (num_samples > 0)
+                {
+                    const size_t start = pos & _mask;
+                    const size_t span = min(num_samples, Capacity - start);
+                    std::copy_n(this->_data.data() + start, span, output);
+                    output += span;
+                    pos += span;
+                    num_samples -= span;
+                }
+            }
+
+            inline void _copy_in(size_t pos, const Sample* input, size_t num_samples)
+            {
+                while (num_samples > 0)
+                {
+                    const size_t start = pos & _mask;
+                    const size_t span = min(num_samples, Capacity - start);
+                    std::copy_n(input, span, this->_data.data() + start);
+                    input += span;
+                    pos += span;
+                    num_samples -= span;
+                }
+            }
+
+            static constexpr size_t _mask = Capacity - 1;
+
+            std::array<Sample, Capacity> _data;
+            std::array<size_t, Lines> _lengths;
+            std::array<size_t, Lines> _starts;
+            size_t _write_index;
     };
 
 } // namespace idsp
@@ -4,6 +4,10 @@
 #include "idsp/std_helpers.hpp"
 #include "idsp/functions.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
 
 namespace idsp
@@ -28,19 +32,19 @@ namespace idsp
                 return this->_process_sample(input);
             }
 
+            /** Block processor: delays @a input by the buffer length. Works
+             * in place. */
             // IDSP_CONSTEXPR_SINCE_CXX14
             void process(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < input.size(); i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), idsp::min(input.size(), output.size()));
             }
 
             template<size_t N>
             // IDSP_CONSTEXPR_SINCE_CXX14
             void process_for(const BufferInterface& input, BufferInterface& output)
             {
-                for (size_t i = 0; i < N; i++)
-                    output[i] = this->_process_sample(input[i]);
+                this->_process_block(input.data(), output.data(), N);
             }
 
             /**Writes a new sample to the underlying buffer at the current write index and increments the write index by 1*/
@@ -52,6 +56,48 @@ namespace idsp
                 if(write_index >= length) write_index = 0;
             }
 
+            /**Writes a block of samples from the write index onwards and advances the write index past them.
+             * The block is copied in at most two contiguous spans, split where it wraps*/
+            inline void write(const BufferInterface& input)
+            {
+                this->write(input.data(), input.size());
+            }
+            inline void write(const Sample* input, size_t num_samples)
+            {
+                while (num_samples > 0)
+                {
+                    const size_t span = idsp::min(num_samples, this->length - this->write_index);
+                    std::copy_n(input, span, this->buffer.data() + this->write_index);
+                    input += span;
+                    num_samples -= span;
+                    this->_advance(span);
+                }
+            }
+
+            /**Reads a block of samples, the first of which is @a offset samples behind the write index.
+             * Sample i of the block is the one read_offset(offset) would return after i more writes,
+             * so a block read followed by a block write of the same size behaves like per-sample
+             * read_offset/write pairs as long as @a offset >= the block size.
+             * offset is clipped to length. The block is copied in at most two contiguous spans*/
+            inline void read_block(size_t offset, BufferInterface& output)
+            {
+                this->read_block(offset, output.data(), output.size());
+            }
+            inline void read_block(size_t offset, Sample* output, size_t num_samples)
+            {
+                offset = idsp::min(offset, this->length);
+                size_t pos = this->write_index >= offset ? this->write_index - offset : this->write_index + this->length - offset;
+                while (num_samples > 0)
+                {
+                    if (pos >= this->length) pos = 0;
+                    const size_t span = idsp::min(num_samples, this->length - pos);
+                    std::copy_n(this->buffer.data() + pos, span, output);
+                    output += span;
+                    num_samples -= span;
+                    pos += span;
+                }
+            }
+
             /**Writes a new sample at the specified index in the underlying buffer
              * index is clipped to length-1
              * doesn't increment the write index*/
@@ -84,7 +130,7 @@ namespace idsp
             inline Sample read_at_smooth_safe(float read_pos)
             {
                 clamp<float>(read_pos, 0.f, (length -1.f));
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4_safe(buffer, read_index, fraction);
             }
@@ -95,7 +141,7 @@ namespace idsp
             inline Sample read_at_smooth_wrap(float read_pos)
             {
                 clamp<float>(read_pos, 0.f, (length -1.f));
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4_wrap(buffer, read_index, fraction);
             }
@@ -106,7 +152,7 @@ namespace idsp
             inline Sample read_at_smooth_raw(float read_pos)
             {
                 clamp<float>(read_pos, 0.f, (length -1.f));
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4(buffer, read_index, fraction);
             }
@@ -130,7 +176,7 @@ namespace idsp
             {
                 clamp<float>(offset, 2.f, (length -1.f));
                 float read_pos = static_cast<float>(write_index) - offset;
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4_safe(buffer, read_index, fraction);
             }
@@ -142,7 +188,7 @@ namespace idsp
             {
                 clamp<float>(offset, 2.f, (length -1.f));
                 float read_pos = static_cast<float>(write_index) - offset;
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4_wrap(buffer, read_index, fraction);
             }
@@ -154,11 +200,100 @@ namespace idsp
             {
                 clamp<float>(offset, 2.f, (length -1.f));
                 float read_pos = static_cast<float>(write_index) - offset;
-                int read_index = static_cast<int>(read_pos);
+                int read_index = static_cast<int>(std::floor(read_pos));
                 float fraction = (read_pos - static_cast<float>(read_index));
                 return interpolate_4(buffer, read_index, fraction);
             }
 
+            /**Block form of read_offset_smooth_wrap: output[i] is what read_offset_smooth_wrap(offsets[i])
+             * would return after i more writes. Only equivalent when offsets[i] > i + 2 for every i, so that
+             * no read touches a sample that the following block write will replace. See can_read_block()*/
+            inline void read_offset_smooth_wrap(const float* offsets, Sample* output, size_t num_samples)
+            {
+                size_t index = write_index;
+                for (size_t i = 0; i < num_samples; i++)
+                {
+                    output[i] = read_at_smooth_wrap(static_cast<float>(index) - offsets[i]);
+                    if (++index >= length) index = 0;
+                }
+            }
+
+            /**Block form of read_offset_smooth_safe, with the same conditions as the block read_offset_smooth_wrap*/
+            inline void read_offset_smooth_safe(const float* offsets, Sample* output, size_t num_samples)
+            {
+                size_t index = write_index;
+                for (size_t i = 0; i < num_samples; i++)
+                {
+                    output[i] = read_at_smooth_safe(static_cast<float>(index) - offsets[i]);
+                    if (++index >= length) index = 0;
+                }
+            }
+
+            /**Block form of read_at_smooth_safe for non-decreasing @a positions: output[i] is
+             * read_at_smooth_safe(positions[i]). A span that doesn't cross the ends of the buffer, after
+             * wrapping by whole buffer sizes, is read without wrapping each point*/
+            inline void read_at_smooth_safe(const float* positions, Sample* output, size_t num_samples)
+            {
+                if (num_samples == 0) return;
+                const long int size = static_cast<long int>(buffer.size());
+                const long int first = static_cast<long int>(std::floor(positions[0]));
+                const long int last = static_cast<long int>(std::floor(positions[num_samples - 1]));
+                const long int shift = first >= 0 ? (first / size) * size : 0;
+                if (first - shift < 1 || last - shift + 2 >= size)
+                {
+                    for (size_t i = 0; i < num_samples; i++)
+                        output[i] = read_at_smooth_safe(positions[i]);
+                    return;
+                }
+                // every position is positive, so truncation is floor
+                const Sample* data = buffer.data();
+                for (size_t i = 0; i < num_samples; i++)
+                {
+                    const long int read_index = static_cast<long int>(positions[i]);
+                    const float fraction = positions[i] - static_cast<float>(read_index);
+                    const long int index = read_index - shift;
+                    output[i] = interpolate_4(fraction, data[index - 1], data[index], data[index + 1], data[index + 2]);
+                }
+            }
+
+            /**Block read of non-decreasing @a positions through @a interpolator, e.g. a
+             * SincInterpolator, at its @a level. Positions wrap as in read_at_smooth_safe, and a
+             * span that doesn't cross the ends of the buffer is read without wrapping each point*/
+            template<class Interpolator>
+            inline void read_at(const Interpolator& interpolator, size_t level, const float* positions, Sample* output, size_t num_samples)
+            {
+                if (num_samples == 0) return;
+                const long int size = static_cast<long int>(buffer.size());
+                const long int before = static_cast<long int>(interpolator.before(level));
+                const long int after = static_cast<long int>(interpolator.after(level));
+                const long int first = static_cast<long int>(std::floor(positions[0]));
+                const long int last = static_cast<long int>(std::floor(positions[num_samples - 1]));
+                const long int shift = first >= 0 ? (first / size) * size : 0;
+                if (first - shift >= before && last - shift + after < size)
+                {
+                    interpolator.read(level, buffer.data(), shift, positions, output, num_samples);
+                    return;
+                }
+                std::array<Sample, Interpolator::max_taps> points;
+                const size_t taps = interpolator.level_taps(level);
+                for (size_t i = 0; i < num_samples; i++)
+                {
+                    const long int read_index = static_cast<long int>(std::floor(positions[i]));
+                    for (size_t k = 0; k < taps; k++)
+                        points[k] = buffer[wrap_safe<long int>(read_index - before + static_cast<long int>(k), 0, buffer.size())];
+                    output[i] = interpolator.read(level, points.data() + before, positions[i] - static_cast<float>(read_index));
+                }
+            }
+
+            /**Returns true if a block of 4-point reads at @a offsets can be taken before the block write
+             * that follows it, i.e. offsets[i] > i + 2 for every i*/
+            static inline bool can_read_block(const float* offsets, size_t num_samples)
+            {
+                for (size_t i = 0; i < num_samples; i++)
+                    if (offsets[i] <= static_cast<float>(i) + 2.f) return false;
+                return true;
+            }
+
             /**Increments the write index*/
             IDSP_CONSTEXPR_SINCE_CXX14
             inline void increment()
@@ -209,64 +344,393 @@ namespace idsp
                 return output;
             }
 
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                while (num_samples > 0)
+                {
+                    const size_t span = idsp::min(num_samples, this->length - this->write_index);
+                    Sample* line = this->buffer.data() + this->write_index;
+                    if (input == output)
+                        std::swap_ranges(line, line + span, output);
+                    else
+                    {
+                        std::copy_n(line, span, output);
+                        std::copy_n(input, span, line);
+                    }
+                    input += span;
+                    output += span;
+                    num_samples -= span;
+                    this->_advance(span);
+                }
+            }
+
+            void _advance(size_t num_samples)
+            {
+                this->write_index += num_samples;
+                if (this->write_index >= this->length) this->write_index -= this->length;
+            }
+
             BufferInterface& buffer;
             size_t write_index;
             size_t length;
     };
 
+    /** AudioRingBuffer with a compile-time power-of-two capacity @a S.
+     * The write position is a free-running counter that is masked with `S - 1`
+     * on access, so no read or write branches on wraparound. read() and
+     * process() delay by the length set with set_length(), which defaults to S
+     * and can be anything up to S, so delay times are not rounded to powers of two.
+     * With @a Mirrored, the first three samples are mirrored past the end of the
+     * buffer, so the four points of an interpolated read are always contiguous
+     * in memory and need no wrap handling at all.
+     * @note The underlying buffer must hold at least `storage_size` samples.
+     */
+    template<size_t S, bool Mirrored = false>
+    class MaskedAudioRingBuffer
+    {
+        static_assert(S >= 4 && (S & (S - 1)) == 0, "MaskedAudioRingBuffer size must be a power of two.");
+
+        static constexpr size_t _mask = S - 1;
+        static constexpr size_t _block_size = 64;
+
+        public:
+            /** Number of samples mirrored past the end of the buffer. */
+            static constexpr size_t guard_size = Mirrored ? 3 : 0;
+            /** Number of samples the underlying buffer must hold. */
+            static constexpr size_t storage_size = S + guard_size;
+
+            constexpr
+            MaskedAudioRingBuffer(BufferInterface& buff) :
+            data{buff.data()},
+            write_index{0},
+            length{S}
+            {}
+
+            IDSP_CONSTEXPR_SINCE_CXX20
+            ~MaskedAudioRingBuffer() = default;
+
+            Sample process(const Sample input)
+            {
+                Sample output = read();
+                write(input);
+                return output;
+            }
+
+            /** Block processor: delays @a input by the buffer length. Works
+             * in place. */
+            void process(const BufferInterface& input, BufferInterface& output)
+            {
+                this->_process_block(input.data(), output.data(), idsp::min(input.size(), output.size()));
+            }
+
+            template<size_t N>
+            void process_for(const BufferInterface& input, BufferInterface& output)
+            {
+                this->_process_block(input.data(), output.data(), N);
+            }
+
+            /**Writes a new sample at the write index and increments the write index by 1*/
+            inline void write(Sample input)
+            {
+                const size_t index = write_index++ & _mask;
+                data[index] = input;
+                if (index < guard_size) data[S + index] = input;
+            }
+
+            /**Writes a block of samples from the write index onwards in at most two contiguous spans*/
+            inline void write(const BufferInterface& input)
+            {
+                this->write(input.data(), input.size());
+            }
+            inline void write(const Sample* input, size_t num_samples)
+            {
+                while (num_samples > 0)
+                {
+                    const size_t start = write_index & _mask;
+                    const size_t span = idsp::min(num_samples, S - start);
+                    std::copy_n(input, span, data + start);
+                    if (start < guard_size) std::copy_n(data, guard_size, data + S);
+                    input += span;
+                    num_samples -= span;
+                    write_index += span;
+                }
+            }
+
+            /**Returns the sample written length samples ago*/
+            inline Sample read() const {return data[(write_index - length) & _mask];}
+
+            /**Returns the sample written @a offset samples ago. An offset of 0 is the same as S*/
+            inline Sample read_offset(size_t offset) const {return data[(write_index - offset) & _mask];}
+
+            /**Block form of read_offset(), see AudioRingBuffer::read_block()*/
+            inline void read_block(size_t offset, BufferInterface& output) const
+            {
+                this->read_block(offset, output.data(), output.size());
+            }
+            inline void read_block(size_t offset, Sample* output, size_t num_samples) const
+            {
+                size_t pos = write_index - offset;
+                while (num_samples > 0)
+                {
+                    const size_t start = pos & _mask;
+                    const size_t span = idsp::min(num_samples, S - start);
+                    std::copy_n(data + start, span, output);
+                    output += span;
+                    num_samples -= span;
+                    pos += span;
+                }
+            }
+
+            /**Returns a 4-point interpolated read at a position relative to the start of the buffer.
+             * Positions outside the buffer wrap around*/
+            inline Sample read_at_smooth(float read_pos) const
+            {
+                const float index = std::floor(read_pos);
+                return _interpolate(static_cast<size_t>(static_cast<long int>(index) - 1), read_pos - index);
+            }
+
+            /**Returns a 4-point interpolated read @a offset samples behind the write index.
+             * Negative offsets wrap around, as in AudioRingBuffer*/
+            inline Sample read_offset_smooth(float offset) const
+            {
+                return _read_offset_smooth(write_index, offset);
+            }
+
+            /**Block form of read_offset_smooth(), see AudioRingBuffer::read_offset_smooth_wrap()*/
+            inline void read_offset_smooth(const float* offsets, Sample* output, size_t num_samples) const
+            {
+                for (size_t i = 0; i < num_samples; i++)
+                    output[i] = _read_offset_smooth(write_index + i, offsets[i]);
+            }
+
+            /**Every read wraps, so these are the same as read_offset_smooth(). They make the class a
+             * drop-in replacement for AudioRingBuffer*/
+            inline Sample read_offset_smooth_wrap(float offset) const {return read_offset_smooth(offset);}
+            inline Sample read_offset_smooth_safe(float offset) const {return read_offset_smooth(offset);}
+            inline void read_offset_smooth_wrap(const float* offsets, Sample* output, size_t num_samples) const
+            {
+                read_offset_smooth(offsets, output, num_samples);
+            }
+            inline void read_offset_smooth_safe(const float* offsets, Sample* output, size_t num_samples) const
+            {
+                read_offset_smooth(offsets, output, num_samples);
+            }
+
+            /**See AudioRingBuffer::can_read_block()*/
+            static inline bool can_read_block(const float* offsets, size_t num_samples)
+            {
+                return AudioRingBuffer::can_read_block(offsets, num_samples);
+            }
+
+            /**Sets the delay of read() and process(), clipped between 1 and S*/
+            inline void set_length(const size_t new_length) {length = idsp::clamp<size_t>(new_length, 1, S);}
+
+            /**Returns the current write index*/
+            constexpr
+            inline size_t get_index() const {return write_index & _mask;}
+
+            /**Returns the capacity of the buffer*/
+            static constexpr
+            inline size_t get_size() {return S;}
+
+            /**Returns the delay of read() and process()*/
+            constexpr
+            inline size_t get_length() const {return length;}
+
+            /**Sets all values in the buffer to 0*/
+            inline void erase() {std::fill_n(data, storage_size, Sample(0));}
+
+        private:
+            // Splitting the offset rather than the absolute position needs no
+            // floor() and keeps the fraction's precision independent of the
+            // write index. The fraction lands in (0, 1], which interpolates fine.
+            // The cast truncates towards zero, so a negative offset steps down
+            // to its floor, then wraps through the unsigned index.
+            inline Sample _read_offset_smooth(size_t index, float offset) const
+            {
+                long int whole = static_cast<long int>(offset);
+                whole -= offset < static_cast<float>(whole) ? 1 : 0;
+                return _interpolate(index - static_cast<size_t>(whole) - 2, 1.f - (offset - static_cast<float>(whole)));
+            }
+
+            inline Sample _interpolate(size_t first, float fraction) const
+            {
+                const size_t base = first & _mask;
+                if (Mirrored)
+                {
+                    const Sample* p = data + base;
+                    return interpolate_4(fraction, p[0], p[1], p[2], p[3]);
+                }
+                return interpolate_4(fraction, data[base], data[(base + 1) & _mask], data[(base + 2) & _mask], data[(base + 3) & _mask]);
+            }
+
+            // Chunks no longer than the delay never read what they write
+            void _process_block(const Sample* input, Sample* output, size_t num_samples)
+            {
+                std::array<Sample, _block_size> delayed;
+                while (num_samples > 0)
+                {
+                    const size_t n = idsp::min(idsp::min(num_samples, _block_size), length);
+                    this->read_block(length, delayed.data(), n);
+                    this->write(input, n);
+                    std::copy_n(delayed.data(), n, output);
+                    input += n;
+                    output += n;
+                    num_samples -= n;
+                }
+            }
+
+            Sample* data;
+            size_t write_index;
+            size_t length;
+    };
+
+    /** Lock-free single-producer/single-consumer queue.
+     * One thread, core or ISR may call the producer methods (`write`) while
+     * one other calls the consumer methods (`read`, `peek`); neither ever
+     * blocks. Positions are free-running counters published with
+     * acquire/release ordering, so a full queue can be told apart from an
+     * empty one and all @a S slots are usable. Writes to a full queue are
+     * rejected rather than overwriting unread data.
+     * Only atomic loads and stores are used, which are lock-free even on
+     * cores without atomic read-modify-write instructions (e.g. Cortex-M0+).
+     * @note @a S must be a power of two.
+     */
     template<class T, size_t S>
     class RingBuffer
     {
+        static_assert(S > 0 && (S & (S - 1)) == 0, "RingBuffer size must be a power of two.");
+
         static constexpr size_t _data_size = S;
+        static constexpr size_t _mask = S - 1;
 
         public:
             constexpr RingBuffer():
             _data{},
             _write_pos{0},
             _read_pos{0}
+            {}
+
+            RingBuffer(const RingBuffer&) = delete;
+            RingBuffer& operator=(const RingBuffer&) = delete;
+
+            // Producer
+
+            /** Pushes @a data onto the queue.
+             * @returns `false`, dropping @a data, if the queue is full.
+             */
+            bool write(const T& data)
+            {
+                const size_t w = this->_write_pos.load(std::memory_order_relaxed);
+                if (w - this->_read_pos.load(std::memory_order_acquire) == _data_size)
+                    return false;
+                this->_data[w & _mask] = data;
+                this->_write_pos.store(w + 1, std::memory_order_release);
+                return true;
+            }
+
+            /** Pushes up to @a count values from @a data onto the queue, in at
+             * most two contiguous copies.
+             * @returns The number of values written.
+             */
+            size_t write(const T* data, size_t count)
             {
-                this->_data.fill(T{});
+                const size_t w = this->_write_pos.load(std::memory_order_relaxed);
+                const size_t r = this->_read_pos.load(std::memory_order_acquire);
+                count = idsp::min(count, _data_size - (w - r));
+                const size_t start = w & _mask;
+                const size_t first = idsp::min(count, _data_size - start);
+                std::copy_n(data, first, this->_data.begin() + start);
+                std::copy_n(data + first, count - first, this->_data.begin());
+                this->_write_pos.store(w + count, std::memory_order_release);
+                return count;
             }
 
-            constexpr void write(T data)
+            /** @returns The number of values that can currently be written. */
+            size_t space_available() const
             {
-                this->_data[this->_write_pos] = data;
-                this->_write_pos++;
-                this->_write_pos %= this->_data_size;
+                return _data_size - this->data_available();
             }
 
-            constexpr T read()
+            // Consumer
+
+            /** Pops the oldest value from the queue.
+             * @returns A default-constructed `T` if the queue is empty.
+             */
+            T read()
             {
-                const T value = this->_data[this->_read_pos];
-                this->_read_pos++;
-                this->_read_pos %= this->_data_size;
+                T value {};
+                this->read(value);
                 return value;
             }
 
-            constexpr T peek() const
+            /** Pops the oldest value from the queue into @a value.
+             * @returns `false`, leaving @a value untouched, if the queue is empty.
+             */
+            bool read(T& value)
+            {
+                const size_t r = this->_read_pos.load(std::memory_order_relaxed);
+                if (this->_write_pos.load(std::memory_order_acquire) == r)
+                    return false;
+                value = this->_data[r & _mask];
+                this->_read_pos.store(r + 1, std::memory_order_release);
+                return true;
+            }
+
+            /** Pops up to @a count values from the queue into @a data, in at
+             * most two contiguous copies.
+             * @returns The number of values read.
+             */
+            size_t read(T* data, size_t count)
+            {
+                const size_t r = this->_read_pos.load(std::memory_order_relaxed);
+                const size_t w = this->_write_pos.load(std::memory_order_acquire);
+                count = idsp::min(count, w - r);
+                const size_t start = r & _mask;
+                const size_t first = idsp::min(count, _data_size - start);
+                std::copy_n(this->_data.begin() + start, first, data);
+                std::copy_n(this->_data.begin(), count - first, data + first);
+                this->_read_pos.store(r + count, std::memory_order_release);
+                return count;
+            }
+
+            /** @returns The oldest value without removing it. Only meaningful
+             * if @ref data_available is non-zero. */
+            T peek() const
             {
-                return this->_data[this->_read_pos];
+                return this->_data[this->_read_pos.load(std::memory_order_relaxed) & _mask];
             }
-            constexpr T peek(size_t offset) const
+            /** @returns The value @a offset places after the oldest, without
+             * removing anything. Only meaningful if @a offset is less than
+             * @ref data_available. */
+            T peek(size_t offset) const
             {
-                const size_t index = (this->_read_pos + offset) % this->_data_size;
-                return this->_data[index];
+                return this->_data[(this->_read_pos.load(std::memory_order_relaxed) + offset) & _mask];
             }
 
-            constexpr size_t data_available() const
+            // Either side
+
+            /** @returns The number of values that can currently be read. */
+            size_t data_available() const
             {
-                if (this->_write_pos == this->_read_pos)
-                    return 0;
-                else if (this->_write_pos > this->_read_pos)
-                    return this->_write_pos - this->_read_pos;
-                else // writepos < readpos; writepos wrapped around
-                    return this->_write_pos + (this->_data_size - this->_read_pos);
+                const size_t r = this->_read_pos.load(std::memory_order_acquire);
+                return this->_write_pos.load(std::memory_order_acquire) - r;
             }
 
+            bool is_empty() const
+                { return this->data_available() == 0; }
+            bool is_full() const
+                { return this->data_available() == _data_size; }
+
+            static constexpr size_t capacity()
+                { return _data_size; }
+
         private:
             std::array<T, _data_size> _data;
-            size_t _write_pos;
-            size_t _read_pos;
+            // Each position is written by one side only; keep them apart so
+            // the two sides don't contend for the same cache line on hosts
+            alignas(64) std::atomic<size_t> _write_pos;
+            alignas(64) std::atomic<size_t> _read_pos;
     };
 
 } // namespace idsp
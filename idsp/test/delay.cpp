@@ -0,0 +1,462 @@
+#ifdef SYSTEM_RPI3
+    #undef SYSTEM_RPI3
+#endif
+#ifdef SYSTEM_MP1
+    #undef SYSTEM_MP1
+#endif
+
+#include "idsp/delay.hpp"
+#include "idsp/mod_fx.hpp"
+#include "idsp/reverb.hpp"
+#include "idsp/reverb_toolkit.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+// Block processing moves whole chunks through the delay lines, and must give
+// the same output as feeding the same processor one sample at a time
+
+static constexpr size_t num_samples = 4800;
+static constexpr float sample_rate = 48000;
+
+static std::vector<Sample> noise()
+{
+    std::random_device rd;
+    std::mt19937 eng(rd());
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<Sample> x(num_samples);
+    for (auto& s : x)
+        s = Sample(dist(eng));
+    return x;
+}
+
+/** Runs @a process over @a input in blocks of @a block_size, in place. */
+template<class F>
+static std::vector<Sample> run_blocks(std::vector<Sample> input, size_t block_size, F&& process)
+{
+    for (size_t i = 0; i < input.size(); i += block_size)
+    {
+        idsp::BufferInterface block(input.data() + i, idsp::min(block_size, input.size() - i));
+        process(block);
+    }
+    return input;
+}
+
+static void test_same(const std::vector<Sample>& expected, const std::vector<Sample>& actual, const std::string& name)
+{
+    for (size_t i = 0; i < expected.size(); i++)
+        idsp::test_eq(static_cast<float>(actual[i]), static_cast<float>(expected[i]), name + " sample " + std::to_string(i));
+}
+
+void test_allpasses();
+void test_banks();
+void test_diffusers();
+void test_mod_fx();
+void test_varispeed();
+void test_rooms();
+void test_silence();
+
+int main(int argc, const char* argv[])
+{
+    test_allpasses();
+    test_banks();
+    test_diffusers();
+    test_mod_fx();
+    test_varispeed();
+    test_rooms();
+    test_silence();
+    return 0;
+}
+
+void test_allpasses()
+{
+    const auto input = noise();
+
+    // Delays shorter than the internal chunk are covered too
+    {
+        idsp::Allpass<idsp::SampleBufferStatic<441>> a, b;
+        idsp::Allpass<idsp::SampleBufferStatic<23>> c, d;
+        std::vector<Sample> expected(input.size()), expected_short(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            expected[i] = a->process(input[i]);
+            expected_short[i] = c->process(input[i]);
+        }
+        test_same(expected, run_blocks(input, 100, [&](idsp::BufferInterface& x) { b->process(x, x); }), "Allpass");
+        test_same(expected_short, run_blocks(input, 64, [&](idsp::BufferInterface& x) { d->process_for<64>(x, x); }), "Short allpass");
+    }
+
+    {
+        idsp::NestedAllpass<idsp::SampleBufferStatic<331>, idsp::SampleBufferStatic<47>> a, b;
+        a->set_gain(0.6f, 0.4f);
+        b->set_gain(0.6f, 0.4f);
+        std::vector<Sample> expected(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+            expected[i] = a->process(input[i]);
+        test_same(expected, run_blocks(input, 32, [&](idsp::BufferInterface& x) { b->process(x, x); }), "Nested allpass");
+    }
+
+    {
+        idsp::DoubleNestedAllpass<idsp::SampleBufferStatic<577>, idsp::SampleBufferStatic<61>, idsp::SampleBufferStatic<113>> a, b;
+        a->set_gain(0.5f, 0.3f, 0.7f);
+        b->set_gain(0.5f, 0.3f, 0.7f);
+        std::vector<Sample> expected(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+            expected[i] = a->process(input[i]);
+        test_same(expected, run_blocks(input, 256, [&](idsp::BufferInterface& x) { b->process(x, x); }), "Double nested allpass");
+    }
+}
+
+// Each lane of a bank matches the single filter with the same delay and
+// gains, frame by frame and in blocks
+template<class Bank, class Single, size_t N>
+static void test_bank(const std::string& name, Bank& frames, Bank& blocks,
+                      std::array<Single, N>& single_frames, std::array<Single, N>& single_blocks)
+{
+    std::array<std::vector<Sample>, N> input;
+    for (auto& x : input)
+        x = noise();
+    bool same_frames = true;
+    for (size_t i = 0; i < num_samples; i++)
+    {
+        std::array<Sample, N> frame;
+        for (size_t n = 0; n < N; n++)
+            frame[n] = input[n][i];
+        frames.process(frame.data(), frame.data());
+        for (size_t n = 0; n < N; n++)
+            same_frames = same_frames && frame[n] == single_frames[n].process(input[n][i]);
+    }
+    idsp::test(same_frames, name + " frames match single filters");
+
+    std::array<std::vector<Sample>, N> output = input;
+    std::array<idsp::BufferInterface, N> lanes;
+    for (size_t i = 0; i < num_samples; i += 100)
+    {
+        for (size_t n = 0; n < N; n++)
+            lanes[n] = idsp::BufferInterface(output[n].data() + i, idsp::min(size_t(100), num_samples - i));
+        idsp::PolyBufferInterface poly(lanes.data(), N);
+        blocks.process(poly, poly);
+    }
+    for (size_t n = 0; n < N; n++)
+    {
+        std::vector<Sample> expected(num_samples);
+        for (size_t i = 0; i < num_samples; i++)
+            expected[i] = single_blocks[n].process(input[n][i]);
+        test_same(expected, output[n], name + " lane " + std::to_string(n) + " blocks");
+    }
+}
+
+void test_banks()
+{
+    // Lanes of different lengths, including one shorter than the chunk
+    {
+        using Lines = idsp::SampleBufferArena<441, 23, 130>;
+        Lines a, b, c, d;
+        idsp::AllpassBank<3> frames(&a[0]), blocks(&b[0]);
+        std::array<idsp::AllpassProcessor, 3> single_frames {{{c[0]}, {c[1]}, {c[2]}}};
+        std::array<idsp::AllpassProcessor, 3> single_blocks {{{d[0]}, {d[1]}, {d[2]}}};
+        const std::array<float, 3> gains {0.5f, 0.3f, 0.7f};
+        for (size_t n = 0; n < 3; n++)
+        {
+            frames.set_gain(n, gains[n]);
+            blocks.set_gain(n, gains[n]);
+            single_frames[n].set_gain(gains[n]);
+            single_blocks[n].set_gain(gains[n]);
+        }
+        test_bank("AllpassBank", frames, blocks, single_frames, single_blocks);
+    }
+
+    {
+        using Lines = idsp::SampleBufferArena<331, 347, 47, 61>;
+        Lines a, b, c, d;
+        idsp::NestedAllpassBank<2> frames(&a[0], &a[2]), blocks(&b[0], &b[2]);
+        std::array<idsp::NestedAllpassProcessor, 2> single_frames {{{c[0], c[2]}, {c[1], c[3]}}};
+        std::array<idsp::NestedAllpassProcessor, 2> single_blocks {{{d[0], d[2]}, {d[1], d[3]}}};
+        frames.set_gain(0.6f, 0.4f);
+        blocks.set_gain(0.6f, 0.4f);
+        frames.set_gain(1, 0.25f, 0.5f);
+        blocks.set_gain(1, 0.25f, 0.5f);
+        single_frames[0].set_gain(0.6f, 0.4f);
+        single_blocks[0].set_gain(0.6f, 0.4f);
+        single_frames[1].set_gain(0.25f, 0.5f);
+        single_blocks[1].set_gain(0.25f, 0.5f);
+        test_bank("NestedAllpassBank", frames, blocks, single_frames, single_blocks);
+    }
+
+    {
+        using Lines = idsp::SampleBufferArena<577, 601, 61, 59, 113, 127>;
+        Lines a, b, c, d;
+        idsp::DoubleNestedAllpassBank<2> frames(&a[0], &a[2], &a[4]), blocks(&b[0], &b[2], &b[4]);
+        std::array<idsp::DoubleNestedAllpassProcessor, 2> single_frames {{{c[0], c[2], c[4]}, {c[1], c[3], c[5]}}};
+        std::array<idsp::DoubleNestedAllpassProcessor, 2> single_blocks {{{d[0], d[2], d[4]}, {d[1], d[3], d[5]}}};
+        frames.set_gain(0.5f, 0.3f, 0.7f);
+        blocks.set_gain(0.5f, 0.3f, 0.7f);
+        for (auto* singles : {&single_frames, &single_blocks})
+            for (auto& single : *singles)
+                single.set_gain(0.5f, 0.3f, 0.7f);
+        test_bank("DoubleNestedAllpassBank", frames, blocks, single_frames, single_blocks);
+    }
+}
+
+template<class DiffuserT>
+static void test_diffuser(const std::string& name)
+{
+    constexpr size_t block_size = 64;
+    const auto left = noise();
+    const auto right = noise();
+    DiffuserT a, b;
+
+    std::array<Sample, block_size> in_l, in_r, out_l, out_r;
+    std::array<idsp::BufferInterface, 2> in {idsp::BufferInterface(in_l.data(), block_size), idsp::BufferInterface(in_r.data(), block_size)};
+    std::array<idsp::BufferInterface, 2> out {idsp::BufferInterface(out_l.data(), block_size), idsp::BufferInterface(out_r.data(), block_size)};
+    idsp::PolyBufferInterface poly_in(in.data(), 2), poly_out(out.data(), 2);
+
+    for (size_t start = 0; start + block_size <= left.size(); start += block_size)
+    {
+        std::copy_n(left.begin() + start, block_size, in_l.begin());
+        std::copy_n(right.begin() + start, block_size, in_r.begin());
+        b.template process_for<block_size>(poly_in, poly_out);
+        for (size_t i = 0; i < block_size; i++)
+        {
+            Sample l, r;
+            a.process(in_l[i], in_r[i], l, r);
+            idsp::test_eq(static_cast<float>(out_l[i]), static_cast<float>(l), name + " left");
+            idsp::test_eq(static_cast<float>(out_r[i]), static_cast<float>(r), name + " right");
+        }
+    }
+}
+
+void test_diffusers()
+{
+    test_diffuser<idsp::DiffuserRev3<48000>>("DiffuserRev3");
+    test_diffuser<idsp::DiffuserRev3<32000>>("DiffuserRev3 32k");
+    test_diffuser<idsp::DiffuserRev2<48000>>("DiffuserRev2");
+}
+
+void test_mod_fx()
+{
+    const auto input = noise();
+
+    {
+        constexpr size_t block_size = 64;
+        idsp::Chorus a(sample_rate), b(sample_rate);
+        for (auto* chorus : {&a, &b})
+        {
+            chorus->set_modulation_amount(0.9f);
+            chorus->set_modulation_rate(3.f);
+        }
+        std::array<Sample, block_size> block, out_r;
+        std::array<idsp::BufferInterface, 2> out {idsp::BufferInterface(block.data(), block_size), idsp::BufferInterface(out_r.data(), block_size)};
+        idsp::PolyBufferInterface poly_out(out.data(), 2);
+        for (size_t start = 0; start + block_size <= input.size(); start += block_size)
+        {
+            std::copy_n(input.begin() + start, block_size, block.begin());
+            idsp::BufferInterface in(block.data(), block_size);
+            // Left output overwrites the input
+            b.process_for<block_size>(in, poly_out);
+            for (size_t i = 0; i < block_size; i++)
+            {
+                Sample l, r;
+                a._process(input[start + i], l, r);
+                idsp::test_eq(static_cast<float>(block[i]), static_cast<float>(l), "Chorus left");
+                idsp::test_eq(static_cast<float>(out_r[i]), static_cast<float>(r), "Chorus right");
+            }
+        }
+    }
+
+    // Full depth sweeps the tap right up to the write index, which exercises
+    // the per-sample fallback. A block size of 1 is the per-sample reference.
+    for (float amount : {0.3f, 1.f})
+    {
+        idsp::WowFlutter a(sample_rate), b(sample_rate);
+        for (auto* wf : {&a, &b})
+        {
+            wf->set_modulation_amount(amount);
+            wf->set_wow_rate(40.f);
+        }
+        const auto expected = run_blocks(input, 1, [&](idsp::BufferInterface& x) { a.process(x, x); });
+        test_same(expected, run_blocks(input, 64, [&](idsp::BufferInterface& x) { b.process(x, x); }), "WowFlutter");
+    }
+
+    // Amounts past full depth clamp to it, so the tap never passes the write
+    // index into a negative offset
+    {
+        idsp::WowFlutter a(sample_rate), b(sample_rate);
+        a.set_modulation_amount(1.f);
+        b.set_modulation_amount(3.f);
+        const auto expected = run_blocks(input, 64, [&](idsp::BufferInterface& x) { a.process(x, x); });
+        test_same(expected, run_blocks(input, 64, [&](idsp::BufferInterface& x) { b.process(x, x); }), "WowFlutter amount clamps");
+    }
+}
+
+void test_varispeed()
+{
+    const auto input = noise();
+    for (float time : {1000.f, 10.f})
+    {
+        idsp::VarispeedDelay<2048> a, b;
+        for (auto* d : {&a, &b})
+        {
+            d->set_time(time);
+            d->set_slew_amount(200.f);
+        }
+        std::vector<Sample> expected, actual;
+        for (bool freeze : {false, true, false})
+        {
+            a.set_freeze(freeze);
+            b.set_freeze(freeze);
+            const auto x = run_blocks(input, 1, [&](idsp::BufferInterface& x) { a.process(x, x); });
+            const auto y = run_blocks(input, 48, [&](idsp::BufferInterface& x) { b.process(x, x); });
+            expected.insert(expected.end(), x.begin(), x.end());
+            actual.insert(actual.end(), y.begin(), y.end());
+        }
+        test_same(expected, actual, "VarispeedDelay " + std::to_string(time));
+    }
+}
+
+template<class Room>
+static void test_room(const std::string& name)
+{
+    // Long enough for the output to pass through every feedback loop
+    std::vector<Sample> left, right;
+    for (size_t i = 0; i < 6; i++)
+    {
+        const auto l = noise(), r = noise();
+        left.insert(left.end(), l.begin(), l.end());
+        right.insert(right.end(), r.begin(), r.end());
+    }
+
+    for (size_t block_size : {32, 64, 100, 256})
+    {
+        auto a = std::make_unique<Room>();
+        auto b = std::make_unique<Room>();
+        for (auto* room : {a.get(), b.get()})
+        {
+            room->set_gain(Sample(0.7f));
+            room->set_dampening(0.6f);
+        }
+        std::vector<Sample> block_l(left), block_r(right);
+        for (size_t start = 0; start < left.size(); start += block_size)
+        {
+            const size_t n = idsp::min(block_size, left.size() - start);
+            // In place, as the firmware calls it
+            std::array<idsp::BufferInterface, 2> io {idsp::BufferInterface(block_l.data() + start, n), idsp::BufferInterface(block_r.data() + start, n)};
+            idsp::PolyBufferInterface poly(io.data(), 2);
+            b->process(poly, poly);
+            for (size_t i = start; i < start + n; i++)
+            {
+                Sample l, r;
+                a->process(left[i], right[i], l, r);
+                idsp::test_eq(static_cast<float>(block_l[i]), static_cast<float>(l), name + " left, block size " + std::to_string(block_size));
+                idsp::test_eq(static_cast<float>(block_r[i]), static_cast<float>(r), name + " right, block size " + std::to_string(block_size));
+            }
+        }
+    }
+}
+
+void test_rooms()
+{
+    test_room<idsp::SmallRoom<48000>>("SmallRoom");
+    test_room<idsp::MediumRoom<48000>>("MediumRoom");
+    test_room<idsp::LargeRoom<48000>>("LargeRoom");
+    test_room<idsp::LargeRoom<32000>>("LargeRoom 32k");
+    test_room<idsp::FDNReverb<48000, 8>>("FDNReverb<8>");
+    test_room<idsp::FDNReverb<44100, 16>>("FDNReverb<16>");
+
+    // The Hadamard feedback is orthogonal: with unity gain and no dampening
+    // an impulse circulates without losing energy, and below unity it decays
+    for (float gain : {1.f, 0.9f})
+    {
+        auto fdn = std::make_unique<idsp::FDNReverb<48000, 16>>();
+        fdn->set_gain(Sample(gain));
+        fdn->set_dampening(0.f);
+        std::array<double, 10> energy {};
+        for (size_t i = 0; i < 10 * 9600; i++)
+        {
+            Sample l, r;
+            const Sample x = Sample(i == 0 ? 1.f : 0.f);
+            fdn->process(x, x, l, r);
+            energy[i / 9600] += static_cast<double>(l) * l + static_cast<double>(r) * r;
+        }
+        for (size_t w = 1; w < energy.size(); w++)
+        {
+            if (gain == 1.f)
+                idsp::test_eq(energy[w] / energy[1], 1.0, "Lossless FDN keeps its energy", 0.2);
+            else
+                idsp::test(energy[w] < energy[w - 1], "FDN tail decays");
+        }
+    }
+}
+
+template<class Room>
+static void test_silence(const std::string& name)
+{
+    // Bursts of noise, each followed by long enough for the tail to die away
+    constexpr size_t block_size = 64;
+    const size_t silence = 8 * 48000;
+    std::vector<Sample> left, right;
+    for (size_t burst = 0; burst < 2; burst++)
+    {
+        const auto l = noise(), r = noise();
+        left.insert(left.end(), l.begin(), l.end());
+        right.insert(right.end(), r.begin(), r.end());
+        left.resize(left.size() + silence, Sample(0));
+        right.resize(right.size() + silence, Sample(0));
+    }
+
+    // The reference keeps its network running
+    auto gated = std::make_unique<Room>();
+    auto reference = std::make_unique<Room>();
+    gated->set_tail_floor(Sample(1e-4f));
+    reference->set_silence_threshold(Sample(-1.f));
+    for (auto* room : {gated.get(), reference.get()})
+    {
+        room->set_gain(Sample(0.5f));
+        room->set_dampening(0.6f);
+    }
+
+    bool bypassed = false, running = true, silent = true;
+    float difference = 0.f;
+    std::array<Sample, block_size> gated_l, gated_r, reference_l, reference_r;
+    for (size_t start = 0; start + block_size <= left.size(); start += block_size)
+    {
+        std::array<idsp::BufferInterface, 2> in {idsp::BufferInterface(left.data() + start, block_size), idsp::BufferInterface(right.data() + start, block_size)};
+        std::array<idsp::BufferInterface, 2> gated_out {idsp::BufferInterface(gated_l.data(), block_size), idsp::BufferInterface(gated_r.data(), block_size)};
+        std::array<idsp::BufferInterface, 2> reference_out {idsp::BufferInterface(reference_l.data(), block_size), idsp::BufferInterface(reference_r.data(), block_size)};
+        idsp::PolyBufferInterface poly_in(in.data(), 2), poly_gated(gated_out.data(), 2), poly_reference(reference_out.data(), 2);
+        const bool was_bypassed = gated->is_bypassed();
+        gated->template process_for<block_size>(poly_in, poly_gated);
+        reference->template process_for<block_size>(poly_in, poly_reference);
+
+        // Any input reopens the gate straight away
+        if (start % (num_samples + silence) < num_samples)
+            running = running && !gated->is_bypassed();
+        bypassed = bypassed || gated->is_bypassed();
+        for (size_t i = 0; i < block_size; i++)
+        {
+            if (was_bypassed && gated->is_bypassed())
+                silent = silent && gated_l[i] == Sample(0) && gated_r[i] == Sample(0);
+            // What the bypass skips is below the floor, before and after
+            difference = idsp::max(difference, std::abs(static_cast<float>(gated_l[i]) - static_cast<float>(reference_l[i])));
+            difference = idsp::max(difference, std::abs(static_cast<float>(gated_r[i]) - static_cast<float>(reference_r[i])));
+        }
+    }
+    idsp::test(running, name + " runs while there is input");
+    idsp::test(silent, name + " bypass is silent");
+    idsp::test(!reference->is_bypassed(), name + " negative threshold never bypasses");
+    idsp::test_eq(difference, 0.f, name + " matches the running network", 1e-3f);
+    idsp::test(bypassed, name + " bypasses once the tail has decayed");
+    idsp::test(gated->is_bypassed(), name + " ends bypassed");
+}
+
+void test_silence()
+{
+    test_silence<idsp::SmallRoom<48000>>("SmallRoom");
+    test_silence<idsp::MediumRoom<48000>>("MediumRoom");
+    test_silence<idsp::LargeRoom<48000>>("LargeRoom");
+    test_silence<idsp::FDNReverb<48000, 8>>("FDNReverb<8>");
+}
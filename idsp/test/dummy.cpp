@@ -12,16 +12,21 @@
 #include "idsp/delay.hpp"
 #include "idsp/envelope.hpp"
 #include "idsp/filter.hpp"
+#include "idsp/fixed_point.hpp"
 #include "idsp/functions.hpp"
 #include "idsp/grain_player.hpp"
+#include "idsp/grain_player_parallel.hpp"
+#include "idsp/interleave.hpp"
 #include "idsp/lookup.hpp"
 #include "idsp/looper.hpp"
+#include "idsp/looper_stream.hpp"
 #include "idsp/matrix.hpp"
 #include "idsp/midi.hpp"
 #include "idsp/mod_fx.hpp"
 #include "idsp/modulation.hpp"
 #include "idsp/oscillator.hpp"
 #include "idsp/random.hpp"
+#include "idsp/resampler.hpp"
 #include "idsp/reverb.hpp"
 #include "idsp/reverb_toolkit.hpp"
 #include "idsp/ringbuffer.hpp"
@@ -11,6 +11,7 @@
 #include "idsp/buffer_types.hpp"
 
 #include <random>
+#include <vector>
 
 static constexpr size_t dsp_block_size = 64;
 static constexpr float sample_rate = 48000;
@@ -62,5 +63,157 @@ int main(int argc, const char* argv[])
             x = notch.process(x);
     }
 
+    // The multiply-add onepole matches the original divide-per-sample form
+    {
+        using FilterType = idsp::OnepoleFilter::Type;
+        const float f = 700 / sample_rate;
+        const double coef = 1 / (M_PI * f);
+        double xs = 0, ys = 0;
+        idsp::OnepoleFilter lop(FilterType::Lowpass, f);
+        fill_buffer(buffer);
+        for (auto x : buffer)
+        {
+            ys = (x + xs - ys * (1 - coef)) / (1 + coef);
+            xs = x;
+            idsp::test_eq(lop.process(x), static_cast<Sample>(ys), "Onepole recurrence");
+        }
+    }
+
+    // Every filter in a onepole bank matches a standalone OnepoleFilter
+    {
+        using FilterType = idsp::OnepoleFilter::Type;
+        constexpr size_t num_filters = 5;
+        const std::array<FilterType, num_filters> types {FilterType::Lowpass, FilterType::Highpass,
+            FilterType::Allpass, FilterType::Lowpass, FilterType::Highpass};
+        idsp::OnepoleBank<num_filters> bank(FilterType::Lowpass);
+        std::vector<idsp::OnepoleFilter> filters;
+        for (size_t n = 0; n < num_filters; n++)
+        {
+            const float f = (50.f + 2000.f * n) / sample_rate;
+            bank.set_type(n, types[n]);
+            bank.set_cutoff(n, f);
+            filters.emplace_back(types[n], f);
+        }
+
+        idsp::PolySampleBufferStatic<dsp_block_size, num_filters> poly;
+        std::array<Sample, num_filters> frame;
+        for (size_t block = 0; block < 10; block++)
+        {
+            for (size_t n = 0; n < num_filters; n++)
+                fill_buffer(poly.channel(n));
+            std::vector<std::vector<Sample>> expected(num_filters);
+            for (size_t n = 0; n < num_filters; n++)
+                for (auto x : poly[n])
+                    expected[n].push_back(filters[n].process(x));
+
+            for (size_t i = 0; i < 8; i++)
+            {
+                for (size_t n = 0; n < num_filters; n++)
+                    frame[n] = poly[n][i];
+                bank.process(frame.data(), frame.data());
+                for (size_t n = 0; n < num_filters; n++)
+                    poly[n][i] = frame[n];
+            }
+            std::array<idsp::BufferInterface, num_filters> tail_channels;
+            for (size_t n = 0; n < num_filters; n++)
+                tail_channels[n] = idsp::BufferInterface(poly[n].data() + 8, dsp_block_size - 8);
+            idsp::PolyBufferInterface tail(tail_channels.data(), num_filters);
+            bank.process(tail, tail);
+
+            for (size_t n = 0; n < num_filters; n++)
+                for (size_t i = 0; i < dsp_block_size; i++)
+                    idsp::test_eq(poly[n][i], expected[n][i], "OnepoleBank filter " + std::to_string(n) + " sample " + std::to_string(i));
+        }
+    }
+
+    // A smoothed parameter change reaches the new coefficients by the end of
+    // the next block, and the sweep stays bounded
+    {
+        using FilterType = idsp::BiquadFilter::Type;
+        idsp::BiquadFilter smooth(FilterType::Lowpass, 200 / sample_rate, 4.f);
+        idsp::BiquadFilter immediate(FilterType::Lowpass, 200 / sample_rate, 4.f);
+        Buffer silence;
+        silence.fill(Sample(0));
+        smooth.set_parameters_smooth(8000 / sample_rate, 0.7f);
+        immediate.set_parameters(8000 / sample_rate, 0.7f);
+        smooth.process(silence.interface(), silence.interface());
+
+        fill_buffer(buffer);
+        Buffer buffer1 = buffer.copy();
+        smooth.process(buffer.interface(), buffer.interface());
+        immediate.process(buffer1.interface(), buffer1.interface());
+        for (size_t i = 0; i < dsp_block_size; i++)
+            idsp::test_eq(buffer[i], buffer1[i], "Smoothed parameters settle after one block");
+
+        for (size_t block = 0; block < 200; block++)
+        {
+            const float f = (block % 2 ? 50.f : 15000.f) / sample_rate;
+            smooth.set_parameters_smooth(f, 8.f);
+            fill_buffer(buffer);
+            smooth.process(buffer.interface(), buffer.interface());
+            for (auto x : buffer)
+                idsp::test(std::abs(x) < Sample(100), "Smoothed sweep stays bounded");
+        }
+    }
+
+    // Every filter in a bank matches a standalone BiquadFilter with the same
+    // type and parameters, through all three process calls
+    {
+        using FilterType = idsp::BiquadFilter::Type;
+        constexpr size_t num_filters = 6;
+        const std::array<FilterType, num_filters> types {FilterType::Lowpass, FilterType::Highpass,
+            FilterType::Peak, FilterType::Notch, FilterType::Lowshelf, FilterType::Lowpass1Pole};
+        idsp::BiquadBank<num_filters> bank(FilterType::Lowpass);
+        std::vector<idsp::BiquadFilter> filters;
+        for (size_t n = 0; n < num_filters; n++)
+        {
+            const float f = (200.f + 700.f * n) / sample_rate;
+            const float Q = 0.5f + 0.3f * n;
+            const float V = n % 2 ? 2.f : 0.5f;
+            bank.set_parameters(n, types[n], f, Q, V);
+            filters.emplace_back(types[n], f, Q, V);
+        }
+
+        idsp::PolySampleBufferStatic<dsp_block_size, num_filters> poly;
+        std::array<Sample, num_filters> frame;
+        std::array<Sample, num_filters * 8> interleaved;
+        for (size_t block = 0; block < 10; block++)
+        {
+            for (size_t n = 0; n < num_filters; n++)
+                fill_buffer(poly.channel(n));
+            std::vector<std::vector<Sample>> expected(num_filters);
+            for (size_t n = 0; n < num_filters; n++)
+                for (auto x : poly[n])
+                    expected[n].push_back(filters[n].process(x));
+
+            // Split the block between the three entry points
+            bank.process_for<40>(poly, poly);
+            for (size_t i = 40; i < 48; i++)
+            {
+                for (size_t n = 0; n < num_filters; n++)
+                    frame[n] = poly[n][i];
+                bank.process(frame.data(), frame.data());
+                for (size_t n = 0; n < num_filters; n++)
+                    poly[n][i] = frame[n];
+            }
+            for (size_t i = 0; i < 8; i++)
+                for (size_t n = 0; n < num_filters; n++)
+                    interleaved[i * num_filters + n] = poly[n][48 + i];
+            bank.process_interleaved(interleaved.data(), interleaved.data(), 8);
+            for (size_t i = 0; i < 8; i++)
+                for (size_t n = 0; n < num_filters; n++)
+                    poly[n][48 + i] = interleaved[i * num_filters + n];
+            std::array<idsp::BufferInterface, num_filters> tail_channels;
+            for (size_t n = 0; n < num_filters; n++)
+                tail_channels[n] = idsp::BufferInterface(poly[n].data() + 56, dsp_block_size - 56);
+            idsp::PolyBufferInterface tail(tail_channels.data(), num_filters);
+            bank.process(tail, tail);
+
+            for (size_t n = 0; n < num_filters; n++)
+                for (size_t i = 0; i < dsp_block_size; i++)
+                    idsp::test_eq(poly[n][i], expected[n][i], "BiquadBank filter " + std::to_string(n) + " sample " + std::to_string(i));
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,201 @@
+#ifdef SYSTEM_RPI3
+    #undef SYSTEM_RPI3
+#endif
+#ifdef SYSTEM_MP1
+    #undef SYSTEM_MP1
+#endif
+
+// This test always runs in Q15, whatever the build's `Sample` type
+#include "idsp/fixed_point.hpp"
+#undef Sample
+#define Sample idsp::Q15
+
+#include "idsp/filter.hpp"
+#include "idsp/reverb_toolkit.hpp"
+#include "idsp/ringbuffer.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <random>
+
+static constexpr float sample_rate = 48000;
+
+void test_conversion();
+void test_saturation();
+void test_arithmetic();
+void test_wide_arithmetic();
+void test_filters();
+void test_interpolation();
+void test_allpass();
+
+int main(int argc, const char* argv[])
+{
+    test_conversion();
+    test_saturation();
+    test_arithmetic();
+    test_wide_arithmetic();
+    test_filters();
+    test_interpolation();
+    test_allpass();
+
+    return 0;
+}
+
+void test_conversion()
+{
+    idsp::test_eq(idsp::Q15(0.5).raw(), int16_t(16384), "Q15 from float");
+    idsp::test_eq(idsp::Q15(-1).raw(), int16_t(-32768), "Q15 from int");
+    idsp::test_eq(idsp::Q31(0.25).raw(), int32_t(536870912), "Q31 from float");
+    idsp::test_eq(static_cast<float>(idsp::Q15::from_raw(-8192)), -0.25f, "Q15 to float");
+    idsp::test_eq(static_cast<double>(idsp::Q31::from_raw(1)), 1.0 / 2147483648.0, "Q31 to double", 1e-15);
+
+    // Round trip through the wider compute formats is lossless
+    for (int raw = -32768; raw < 32768; raw += 7)
+    {
+        const auto x = idsp::Q15::from_raw(static_cast<int16_t>(raw));
+        idsp::test(idsp::Q15(idsp::SampleCompute(x)) == x, "Q15 compute round trip " + std::to_string(raw));
+    }
+    const auto q31 = idsp::Q31::from_raw(-123456789);
+    idsp::test(idsp::Q31(idsp::SampleTraits<idsp::Q31>::compute_type(q31)) == q31, "Q31 compute round trip");
+}
+
+void test_saturation()
+{
+    idsp::test(idsp::Q15(1) == idsp::Q15::max(), "Q15 saturates 1");
+    idsp::test(idsp::Q15(7.5f) == idsp::Q15::max(), "Q15 saturates large float");
+    idsp::test(idsp::Q15(-3) == idsp::Q15::min(), "Q15 saturates negative int");
+    idsp::test(idsp::Q15(0.75) + idsp::Q15(0.75) == idsp::Q15::max(), "Q15 saturating add");
+    idsp::test(idsp::Q15(-0.75) - idsp::Q15(0.75) == idsp::Q15::min(), "Q15 saturating subtract");
+    idsp::test(-idsp::Q15::min() == idsp::Q15::max(), "Q15 saturating negate");
+    idsp::test(idsp::Q15::min() * idsp::Q15::min() == idsp::Q15::max(), "Q15 saturating multiply");
+    idsp::test(idsp::Q15(0.5) / idsp::Q15(0.25) == idsp::Q15::max(), "Q15 saturating divide");
+    idsp::test(idsp::Q15(-0.5) / idsp::Q15(0) == idsp::Q15::min(), "Q15 divide by zero");
+    idsp::test(idsp::Q31(0.75) + idsp::Q31(0.75) == idsp::Q31::max(), "Q31 saturating add");
+    idsp::test(idsp::Q31::min() * idsp::Q31::min() == idsp::Q31::max(), "Q31 saturating multiply");
+}
+
+void test_arithmetic()
+{
+    std::random_device rd;
+    std::mt19937 eng(rd());
+    std::uniform_real_distribution<double> dist(-0.45, 0.45);
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const double a = dist(eng), b = dist(eng);
+        const idsp::Q15 qa(a), qb(b);
+        const double ra = static_cast<double>(qa), rb = static_cast<double>(qb);
+        idsp::test_eq(static_cast<double>(qa + qb), ra + rb, "Q15 add", 1e-9);
+        idsp::test_eq(static_cast<double>(qa - qb), ra - rb, "Q15 subtract", 1e-9);
+        idsp::test_eq(static_cast<double>(qa * qb), ra * rb, "Q15 multiply", 1.0 / 32768);
+        if (std::abs(ra) < std::abs(rb))
+            idsp::test_eq(static_cast<double>(qa / qb), ra / rb, "Q15 divide", 1.0 / 32768);
+
+        const idsp::Q31 la(a), lb(b);
+        const double rla = static_cast<double>(la), rlb = static_cast<double>(lb);
+        idsp::test_eq(static_cast<double>(la * lb), rla * rlb, "Q31 multiply", 1e-9);
+        if (std::abs(rla) < std::abs(rlb))
+            idsp::test_eq(static_cast<double>(la / lb), rla / rlb, "Q31 divide", 1e-9);
+    }
+}
+
+void test_wide_arithmetic()
+{
+    using Wide = idsp::SampleTraits<idsp::Q31>::compute_type;
+
+    idsp::test_eq(static_cast<double>(Wide(300.25) * Wide(-2)), -600.5, "Q31.32 multiply");
+    idsp::test_eq(static_cast<double>(Wide(1) / Wide(3)), 1.0 / 3, "Q31.32 divide", 1e-9);
+    idsp::test(Wide(2e9) * Wide(2e9) == Wide::max(), "Q31.32 saturating multiply");
+
+    // The portable 64-bit routines must match the native results
+    std::random_device rd;
+    std::mt19937_64 eng(rd());
+    for (size_t i = 0; i < 10000; i++)
+    {
+        const int64_t a = static_cast<int64_t>(eng()) >> (eng() % 40);
+        const int64_t b = static_cast<int64_t>(eng()) >> (eng() % 40);
+        const unsigned shift = 1 + eng() % 48;
+        idsp::test_eq(idsp::_fixed::mul_shift_64(a, b, shift), idsp::_fixed::mul(a, b, shift), "Portable 64-bit multiply");
+        if (b != 0)
+            idsp::test_eq(idsp::_fixed::div_shift_64(a, b, shift), idsp::_fixed::div(a, b, shift), "Portable 64-bit divide");
+    }
+}
+
+void test_filters()
+{
+    // DC response settles to the expected gain
+    {
+        using FilterType = idsp::OnepoleFilter::Type;
+        idsp::OnepoleFilter lop(FilterType::Lowpass, 200 / sample_rate);
+        idsp::OnepoleFilter hip(FilterType::Highpass, 200 / sample_rate);
+        Sample lo, hi;
+        for (size_t i = 0; i < 4800; i++)
+        {
+            lo = lop.process(Sample(0.5));
+            hi = hip.process(Sample(0.5));
+        }
+        idsp::test_eq(static_cast<float>(lo), 0.5f, "Q15 onepole lowpass DC", 2e-3f);
+        idsp::test_eq(static_cast<float>(hi), 0.f, "Q15 onepole highpass DC", 2e-3f);
+    }
+
+    {
+        using FilterType = idsp::BiquadFilter::Type;
+        idsp::BiquadFilter lpf(FilterType::Lowpass, 1000 / sample_rate, 0.707f);
+        idsp::BiquadFilter hpf(FilterType::Highpass, 1000 / sample_rate, 0.707f);
+        Sample lo, hi;
+        for (size_t i = 0; i < 4800; i++)
+        {
+            lo = lpf.process(Sample(0.5));
+            hi = hpf.process(Sample(0.5));
+        }
+        idsp::test_eq(static_cast<float>(lo), 0.5f, "Q15 biquad lowpass DC", 2e-3f);
+        idsp::test_eq(static_cast<float>(hi), 0.f, "Q15 biquad highpass DC", 2e-3f);
+    }
+
+    // A notch removes its centre frequency
+    {
+        using FilterType = idsp::BiquadFilter::Type;
+        const float f = 1000 / sample_rate;
+        idsp::BiquadFilter notch(FilterType::Notch, f, 0.9f);
+        float peak = 0;
+        for (size_t i = 0; i < 9600; i++)
+        {
+            const float y = static_cast<float>(notch.process(Sample(0.5f * std::sin(idsp::twopi * f * i))));
+            if (i > 4800)
+                peak = idsp::max(peak, std::abs(y));
+        }
+        idsp::test(peak < 0.01f, "Q15 biquad notch rejection " + std::to_string(peak));
+    }
+}
+
+void test_interpolation()
+{
+    // Spans wider than the Q15 range must not saturate
+    idsp::test_eq(static_cast<float>(idsp::interpolate_2(0.25f, Sample(-0.9), Sample(0.9))), -0.45f, "Q15 interpolate_2", 1e-4f);
+    idsp::test_eq(static_cast<float>(idsp::interpolate_4(0.5f, Sample(-0.9), Sample(-0.3), Sample(0.3), Sample(0.9))), 0.f, "Q15 interpolate_4", 1e-4f);
+
+    idsp::SampleBufferStatic<16> buffer;
+    idsp::AudioRingBuffer ring(buffer);
+    for (size_t i = 0; i < 16; i++)
+        ring.write(Sample(static_cast<float>(i) / 32.f));
+    idsp::test_eq(static_cast<float>(ring.read_at_smooth_safe(4.5f)), 4.5f / 32.f, "Q15 ring buffer smooth read", 1e-4f);
+}
+
+void test_allpass()
+{
+    constexpr size_t length = 32;
+    idsp::Allpass<idsp::SampleBufferStatic<length>> allpass;
+    allpass->set_gain(0.5f);
+
+    // Impulse response of a Schroeder allpass: -g, then (1 - g^2) g^k every
+    // `length` samples
+    std::array<float, length * 3 + 1> response;
+    for (size_t i = 0; i < response.size(); i++)
+        response[i] = static_cast<float>(allpass->process(i == 0 ? Sample(0.5) : Sample(0)));
+
+    idsp::test_eq(response[0], -0.25f, "Q15 allpass direct path", 1e-4f);
+    idsp::test_eq(response[length], 0.375f, "Q15 allpass first echo", 1e-4f);
+    idsp::test_eq(response[length * 2], 0.1875f, "Q15 allpass second echo", 1e-4f);
+    idsp::test_eq(response[length * 3], 0.09375f, "Q15 allpass third echo", 1e-4f);
+}
@@ -14,6 +14,7 @@ void test_interpolate();
 void test_power();
 void test_factorial();
 void test_sin();
+void test_tan_exp();
 void test_scale();
 
 int main(int argc, const char* argv[])
@@ -29,6 +30,7 @@ int main(int argc, const char* argv[])
     test_power();
     test_factorial();
     test_sin();
+    test_tan_exp();
     test_scale();
 
     return 0;
@@ -118,8 +120,10 @@ void test_wrap()
 {
     constexpr int min {-6};
     constexpr int max {9};
-    int expected = -5;
-    for (int i = -50; i < 50; i++)
+    constexpr int range {max - min};
+    // idsp::wrap only wraps once, so stay within one range either side
+    int expected = min;
+    for (int i = min - range; i < max + range; i++)
     {
         const auto x = idsp::wrap(i, min, max);
         idsp::test_eq(x, expected, "Wrap int " + std::to_string(i));
@@ -127,6 +131,16 @@ void test_wrap()
         if (expected >= max)
             expected = min;
     }
+    // idsp::wrap_safe wraps any number of times
+    expected = -5;
+    for (int i = -50; i < 50; i++)
+    {
+        const auto x = idsp::wrap_safe(i, min, max);
+        idsp::test_eq(x, expected, "Wrap safe int " + std::to_string(i));
+        expected++;
+        if (expected >= max)
+            expected = min;
+    }
 
     idsp::test_eq(idsp::wrap(0.5), 0.5, "Wrap IB double");
     idsp::test_eq(idsp::wrap(1.5), 0.5, "Wrap positive OOB double");
@@ -153,7 +167,25 @@ void test_factorial()
 
 void test_sin()
 {
+    // sin_accurate is usable at compile time and matches std::sin anywhere
+    static_assert(idsp::sin_accurate(0.0) == 0.0, "sin_accurate is constexpr");
+    for (double x = -20.0; x <= 20.0; x += 0.001)
+    {
+        idsp::test_eq(idsp::sin_accurate(x), std::sin(x), "sin_accurate at " + std::to_string(x), 1e-9);
+        idsp::test_eq(idsp::cos_accurate(x), std::cos(x), "cos_accurate at " + std::to_string(x), 1e-9);
+    }
+}
 
+void test_tan_exp()
+{
+    // Relative errors stay within the documented bounds across the range
+    for (double f = 0.0001; f < 0.4999; f += 0.0001)
+    {
+        const double expected = std::tan(M_PI * f);
+        idsp::test_eq(idsp::tan_pi_fast(f) / expected, 1.0, "tan_pi_fast at " + std::to_string(f), 1.4e-8);
+    }
+    for (double x = -M_PI; x <= 0; x += 0.001)
+        idsp::test_eq(idsp::exp_fast(x) / std::exp(x), 1.0, "exp_fast at " + std::to_string(x), 5e-8);
 }
 
 void test_scale()
@@ -0,0 +1,381 @@
+#ifdef SYSTEM_RPI3
+    #undef SYSTEM_RPI3
+#endif
+#ifdef SYSTEM_MP1
+    #undef SYSTEM_MP1
+#endif
+
+#include "idsp/grain_player.hpp"
+#include "idsp/grain_player_parallel.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+static constexpr float sample_rate = 48000;
+static constexpr size_t buffer_size = 24000;
+
+using AudioBuffer = idsp::SampleBufferStatic<buffer_size>;
+
+static void fill_buffer(idsp::AudioRingBuffer& ring)
+{
+    std::random_device rd;
+    std::mt19937 eng(rd());
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (size_t i = 0; i < buffer_size + 123; i++)
+        ring.write(Sample(dist(eng)));
+}
+
+/** The sample-major player the scheduler replaced: every grain slot visited
+ * every sample, each with its own DC blocker. */
+template<size_t MaxGrains>
+class ReferencePlayer
+{
+    public:
+        ReferencePlayer(idsp::AudioRingBuffer& buff) :
+        audio_buffer{buff}
+        {
+            for (auto& grain : grains)
+                grain = idsp::Grain(sample_rate);
+        }
+
+        void trigger(idsp::Grain::Parameters parameters)
+        {
+            for (auto& grain : grains)
+            {
+                if (grain.get_state() == idsp::Grain::idle)
+                {
+                    parameters.volume = 1.f;
+                    grain.init(parameters, audio_buffer);
+                    return;
+                }
+            }
+        }
+
+        void process(idsp::BufferInterface& output)
+        {
+            for (size_t i = 0; i < output.size(); i++)
+            {
+                std::array<Sample, MaxGrains> grain_out;
+                for (size_t g = 0; g < MaxGrains; g++)
+                    grain_out[g] = grains[g].get_state() == idsp::Grain::active ? grains[g].process(audio_buffer, windows) : Sample(0);
+                dc_blockers.process(grain_out.data(), grain_out.data());
+                Sample out{0};
+                for (auto x : grain_out)
+                    out += x;
+                output[i] = idsp::tanh_fast(out);
+            }
+            for (auto& grain : grains)
+                if (grain.get_state() == idsp::Grain::dying)
+                    grain.kill();
+        }
+
+    private:
+        idsp::AudioRingBuffer& audio_buffer;
+        std::array<idsp::Grain, MaxGrains> grains;
+        idsp::OnepoleBank<MaxGrains> dc_blockers{idsp::OnepoleFilter::Type::Highpass};
+        idsp::WindowBank<128> windows;
+};
+
+/** Sample-major rendering of the same active list: each sample visits every
+ * playing grain, in trigger order, and the sum is DC blocked. Windows are
+ * resolved at trigger as GrainPlayer resolves them. */
+template<size_t MaxGrains>
+class SampleMajorPlayer
+{
+    public:
+        SampleMajorPlayer(idsp::AudioRingBuffer& buff) :
+        audio_buffer{buff}
+        {}
+
+        void trigger(idsp::Grain::Parameters parameters)
+        {
+            if (grains.size() == MaxGrains)
+                return;
+            parameters.volume = 1.f;
+            grains.emplace_back(sample_rate);
+            grains.back().init(parameters, audio_buffer, windows);
+        }
+
+        void process(idsp::BufferInterface& output)
+        {
+            for (size_t i = 0; i < output.size(); i++)
+            {
+                Sample out{0};
+                for (auto& grain : grains)
+                    if (grain.get_state() == idsp::Grain::active)
+                        out += grain.process(audio_buffer, windows);
+                output[i] = idsp::tanh_fast(dc_blocker.process(out));
+            }
+            std::vector<idsp::Grain> kept;
+            for (auto& grain : grains)
+            {
+                if (grain.get_state() == idsp::Grain::dying)
+                    grain.kill(windows);
+                else
+                    kept.push_back(grain);
+            }
+            grains = kept;
+        }
+
+    private:
+        idsp::AudioRingBuffer& audio_buffer;
+        std::vector<idsp::Grain> grains;
+        idsp::OnepoleFilter dc_blocker{idsp::OnepoleFilter::Type::Highpass};
+        idsp::WindowBank<128> windows;
+};
+
+void test_windows();
+void test_scheduler();
+void test_output();
+void test_parallel();
+void test_sinc();
+
+int main(int argc, const char* argv[])
+{
+    test_windows();
+    test_scheduler();
+    test_output();
+    test_parallel();
+    test_sinc();
+    return 0;
+}
+
+void test_windows()
+{
+    idsp::WindowBank<128, 2> windows;
+
+    // A resolved window reads as the blend of its two tables
+    float max_difference = 0.f;
+    for (float shape : {0.f, 0.1f, 0.3f, 0.45f, 0.6f, 0.8f, 1.f})
+    {
+        const Sample* table = windows.acquire_window(shape);
+        for (float phase = 0.f; phase <= 1.f; phase += 1.f / 1000.f)
+            max_difference = idsp::max(max_difference, std::abs(windows.read_window(table, phase) - windows.get_window(phase, shape)));
+        idsp::test_eq(windows.read_window(table, 1.f), windows.get_window(1.f, shape), "Resolved window wraps at 1");
+        windows.release_window(table);
+    }
+    idsp::test_eq(max_difference, 0.f, "Resolved window matches the blend", 1e-6f);
+
+    // Grains of one shape share a table, and a full cache falls back
+    const Sample* a = windows.acquire_window(0.2f);
+    idsp::test(a == windows.acquire_window(0.2f), "Same shape shares a table");
+    const Sample* b = windows.acquire_window(0.7f);
+    idsp::test(b != nullptr && b != a, "New shape takes a free slot");
+    idsp::test(windows.acquire_window(0.9f) == nullptr, "Full cache falls back to blending");
+    windows.release_window(b);
+    idsp::test(windows.acquire_window(0.9f) == b, "Released slot is reused");
+    windows.release_window(a);
+    idsp::test(windows.acquire_window(0.5f) == nullptr, "Held slots are not reused");
+    windows.release_window(a);
+    idsp::test(windows.acquire_window(0.5f) == a, "Slot is free once every holder releases it");
+}
+
+void test_scheduler()
+{
+    auto audio = std::make_unique<AudioBuffer>();
+    idsp::AudioRingBuffer ring(*audio);
+    fill_buffer(ring);
+    idsp::GrainPlayer<4> player(ring, sample_rate);
+    player.set_position(0.5f);
+    player.set_pitch(1.f);
+    player.set_length(0.01f);
+    player.set_window_shape(0.5f);
+
+    idsp::SampleBufferStatic<dsp_block_size> left, right;
+    auto l = left.interface();
+    auto r = right.interface();
+
+    // Triggers beyond the grain count are dropped
+    for (size_t i = 0; i < 6; i++)
+        player.trigger_grain();
+    idsp::test_eq(player.get_active_grains(), size_t(4), "Triggers stop at max_grains");
+
+    // Finished grains are reclaimed at the end of the block they finish in
+    size_t blocks = 0;
+    while (player.get_active_grains() > 0 && blocks < 1000)
+    {
+        player.process(l, r);
+        blocks++;
+    }
+    idsp::test_eq(player.get_active_grains(), size_t(0), "Finished grains are reclaimed");
+
+    // and can be triggered again
+    for (size_t i = 0; i < 4; i++)
+        player.trigger_grain();
+    idsp::test_eq(player.get_active_grains(), size_t(4), "Reclaimed grains retrigger");
+}
+
+void test_output()
+{
+    auto audio = std::make_unique<AudioBuffer>();
+    idsp::AudioRingBuffer ring(*audio);
+    fill_buffer(ring);
+
+    constexpr size_t max_grains = 16;
+    auto player = std::make_unique<idsp::GrainPlayer<max_grains>>(ring, sample_rate);
+    auto reference = std::make_unique<ReferencePlayer<max_grains>>(ring);
+    auto sample_major = std::make_unique<SampleMajorPlayer<max_grains>>(ring);
+
+    // Blocks longer than the internal chunk are covered too
+    idsp::SampleBufferStatic<100> left, right, expected, expected_sample_major;
+    auto l = left.interface();
+    auto r = right.interface();
+    auto e = expected.interface();
+    auto s = expected_sample_major.interface();
+
+    // Overlapping grains of varied pitch, length and shape, sometimes more
+    // than there are slots
+    float max_difference = 0.f;
+    bool same_as_sample_major = true;
+    bool right_silent = true;
+    for (size_t block = 0; block < 2000; block++)
+    {
+        if (block % 3 == 0)
+        {
+            const float x = static_cast<float>((block * 7) % 23) / 23.f;
+            idsp::Grain::Parameters parameters;
+            // as GrainPlayer::set_position maps it
+            parameters.position = static_cast<int>(idsp::rescale(x, 0.f, 1.f, 1.f, static_cast<float>(buffer_size - (buffer_size - 3) / 4)));
+            parameters.pitch = idsp::clamp(0.25f + 3.75f * x, idsp::Grain::min_pitch, idsp::Grain::max_pitch);
+            parameters.length_pot = 0.05f + 0.5f * x;
+            parameters.window_shape = x;
+            parameters.channel = 0;
+            parameters.volume = 1.f;
+            player->set_position(x);
+            player->set_pitch(parameters.pitch);
+            player->set_length(parameters.length_pot);
+            player->set_window_shape(parameters.window_shape);
+            player->trigger_grain();
+            reference->trigger(parameters);
+            sample_major->trigger(parameters);
+        }
+        player->process(l, r);
+        reference->process(e);
+        sample_major->process(s);
+        for (size_t i = 0; i < l.size(); i++)
+        {
+            max_difference = idsp::max(max_difference, std::abs(static_cast<float>(l[i] - e[i])));
+            same_as_sample_major = same_as_sample_major && l[i] == s[i];
+            right_silent = right_silent && r[i] == Sample(0);
+        }
+    }
+    idsp::test_eq(max_difference, 0.f, "Scheduled output matches every-slot output", 1e-4f);
+    idsp::test(same_as_sample_major, "Grain-major output matches sample-major output");
+    idsp::test(right_silent, "Right channel stays silent");
+}
+
+void test_parallel()
+{
+    auto audio = std::make_unique<AudioBuffer>();
+    idsp::AudioRingBuffer ring(*audio);
+    fill_buffer(ring);
+
+    constexpr size_t max_grains = 64;
+    using Player = idsp::GrainPlayer<max_grains>;
+    std::array<size_t, 3> num_threads {1, 2, 4};
+    std::vector<std::unique_ptr<Player>> players;
+    std::vector<std::unique_ptr<idsp::ParallelGrainRenderer<Player>>> renderers;
+    for (size_t t : num_threads)
+    {
+        players.push_back(std::make_unique<Player>(ring, sample_rate));
+        renderers.push_back(std::make_unique<idsp::ParallelGrainRenderer<Player>>(*players.back(), t));
+    }
+    auto serial = std::make_unique<Player>(ring, sample_rate);
+
+    // Blocks longer than the renderer's accumulators are covered too
+    constexpr size_t block_size = 300;
+    std::vector<idsp::SampleBufferStatic<block_size>> left(num_threads.size()), right(num_threads.size());
+    idsp::SampleBufferStatic<block_size> serial_left, serial_right;
+    auto sl = serial_left.interface();
+    auto sr = serial_right.interface();
+
+    float max_difference = 0.f;
+    bool same_for_any_thread_count = true;
+    for (size_t block = 0; block < 400; block++)
+    {
+        const float x = static_cast<float>((block * 7) % 23) / 23.f;
+        for (size_t p = 0; p <= players.size(); p++)
+        {
+            Player& player = p < players.size() ? *players[p] : *serial;
+            player.set_position(x);
+            player.set_pitch(0.25f + 3.75f * x);
+            player.set_length(0.05f + 0.2f * x);
+            player.set_window_shape(x);
+            player.trigger_grain();
+            player.trigger_grain();
+        }
+        for (size_t p = 0; p < players.size(); p++)
+        {
+            auto l = left[p].interface();
+            auto r = right[p].interface();
+            players[p]->process(l, r, *renderers[p]);
+        }
+        serial->process(sl, sr);
+        for (size_t i = 0; i < block_size; i++)
+        {
+            for (size_t p = 1; p < players.size(); p++)
+                same_for_any_thread_count = same_for_any_thread_count && left[p].interface()[i] == left[0].interface()[i];
+            max_difference = idsp::max(max_difference, std::abs(static_cast<float>(left[0].interface()[i] - sl[i])));
+        }
+    }
+    idsp::test(same_for_any_thread_count, "Parallel output is the same for any thread count");
+    idsp::test_eq(max_difference, 0.f, "Parallel output matches the serial player", 1e-4f);
+    idsp::test_eq(serial->get_active_grains(), players[0]->get_active_grains(), "Parallel player reclaims as the serial one");
+}
+
+/** RMS of one long grain at @a pitch, over the blocks it plays. */
+template<class Player>
+static float grain_rms(Player& player, float pitch)
+{
+    player.set_position(0.5f);
+    player.set_pitch(pitch);
+    player.set_length(0.5f);
+    player.set_window_shape(0.5f);
+    player.trigger_grain();
+    idsp::SampleBufferStatic<dsp_block_size> left, right;
+    auto l = left.interface();
+    auto r = right.interface();
+    double sum = 0.0;
+    size_t count = 0;
+    while (player.get_active_grains() > 0)
+    {
+        player.process(l, r);
+        for (auto x : l)
+            sum += static_cast<double>(x) * static_cast<double>(x);
+        count += l.size();
+    }
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(count)));
+}
+
+void test_sinc()
+{
+    auto sinc = std::make_unique<idsp::SincInterpolator<16>>();
+    auto audio = std::make_unique<AudioBuffer>();
+    idsp::AudioRingBuffer ring(*audio);
+
+    // A low tone plays the same through either read
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(0.25f * std::sin(idsp::twopi * 0.01f * static_cast<float>(i))));
+    auto four_point = std::make_unique<idsp::GrainPlayer<4>>(ring, sample_rate);
+    auto sinc_player = std::make_unique<idsp::GrainPlayer<4, 16>>(ring, *sinc, sample_rate);
+    for (float pitch : {1.f, 2.f})
+    {
+        const float expected = grain_rms(*four_point, pitch);
+        idsp::test_eq(grain_rms(*sinc_player, pitch), expected, "Sinc grain passes a low tone at pitch " + std::to_string(pitch), 0.02f * expected);
+    }
+
+    // A tone above the grain's Nyquist at pitch 2 aliases through 4-point
+    // reads, and is filtered by the sinc reads
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(0.25f * std::sin(idsp::twopi * 0.4f * static_cast<float>(i))));
+    const float aliased = grain_rms(*four_point, 2.f);
+    const float filtered = grain_rms(*sinc_player, 2.f);
+    idsp::test(aliased > 0.05f, "4-point grain aliases a tone above its Nyquist");
+    idsp::test(filtered < 0.01f * aliased, "Sinc grain rejects a tone above its Nyquist");
+}
@@ -0,0 +1,154 @@
+#include "idsp/interleave.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+static constexpr size_t dsp_block_size = 64;
+
+template<class T>
+static std::vector<T> random_frames(size_t num_values);
+
+template<size_t Nc>
+void test_round_trip_int16();
+
+template<size_t Nc>
+void test_round_trip_int24();
+
+template<size_t Nc>
+void test_round_trip_int32();
+
+void test_conversion_limits();
+
+int main(int argc, const char* argv[])
+{
+    test_round_trip_int16<2>();
+    test_round_trip_int16<4>();
+    test_round_trip_int16<8>();
+
+    test_round_trip_int24<2>();
+    test_round_trip_int24<4>();
+    test_round_trip_int24<8>();
+
+    test_round_trip_int32<2>();
+    test_round_trip_int32<4>();
+    test_round_trip_int32<8>();
+
+    test_conversion_limits();
+
+    return 0;
+}
+
+template<>
+std::vector<int16_t> random_frames<int16_t>(size_t num_values)
+{
+    std::random_device rd;
+    std::mt19937 eng(rd());
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<int16_t> values(num_values);
+    for (auto& x : values)
+        x = static_cast<int16_t>(dist(eng));
+    return values;
+}
+
+template<>
+std::vector<int32_t> random_frames<int32_t>(size_t num_values)
+{
+    std::random_device rd;
+    std::mt19937 eng(rd());
+    std::uniform_int_distribution<int32_t> dist(-2147483647 - 1, 2147483647);
+    std::vector<int32_t> values(num_values);
+    for (auto& x : values)
+        x = dist(eng);
+    return values;
+}
+
+template<size_t Nc>
+void test_round_trip_int16()
+{
+    const auto input = random_frames<int16_t>(dsp_block_size * Nc);
+    idsp::PolySampleBufferStatic<dsp_block_size, Nc> planar;
+    idsp::deinterleave_for<Nc, dsp_block_size>(input.data(), planar.interface());
+
+    for (size_t i = 0; i < dsp_block_size; i++)
+        for (size_t c = 0; c < Nc; c++)
+            idsp::test_eq(planar[c][i], static_cast<Sample>(input[i * Nc + c]) / Sample(32768),
+                "Deinterleave int16 " + std::to_string(Nc) + "ch frame " + std::to_string(i));
+
+    std::vector<int16_t> output(input.size());
+    idsp::interleave_for<Nc, dsp_block_size>(planar.interface(), output.data());
+    for (size_t i = 0; i < input.size(); i++)
+        idsp::test_eq(output[i], input[i], "Interleave int16 " + std::to_string(Nc) + "ch value " + std::to_string(i));
+}
+
+template<size_t Nc>
+void test_round_trip_int24()
+{
+    const auto raw = random_frames<int32_t>(dsp_block_size * Nc);
+    std::vector<idsp::PackedInt24> input(raw.size());
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        const int32_t v = raw[i] >> 8;
+        input[i] = idsp::PackedInt24{{
+            static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v >> 16)
+        }};
+    }
+
+    idsp::PolySampleBufferStatic<dsp_block_size, Nc> planar;
+    idsp::deinterleave_for<Nc, dsp_block_size>(input.data(), planar.interface());
+
+    for (size_t i = 0; i < dsp_block_size; i++)
+        for (size_t c = 0; c < Nc; c++)
+            idsp::test_eq(planar[c][i], static_cast<Sample>(raw[i * Nc + c] >> 8) / Sample(8388608),
+                "Deinterleave int24 " + std::to_string(Nc) + "ch frame " + std::to_string(i));
+
+    std::vector<idsp::PackedInt24> output(input.size());
+    idsp::interleave_for<Nc, dsp_block_size>(planar.interface(), output.data());
+    for (size_t i = 0; i < input.size(); i++)
+        for (size_t b = 0; b < 3; b++)
+            idsp::test_eq(output[i].bytes[b], input[i].bytes[b],
+                "Interleave int24 " + std::to_string(Nc) + "ch value " + std::to_string(i));
+}
+
+template<size_t Nc>
+void test_round_trip_int32()
+{
+    const auto input = random_frames<int32_t>(dsp_block_size * Nc);
+    idsp::PolySampleBufferStatic<dsp_block_size, Nc> planar;
+    idsp::deinterleave_for<Nc, dsp_block_size>(input.data(), planar.interface());
+
+    std::vector<int32_t> output(input.size());
+    idsp::interleave_for<Nc, dsp_block_size>(planar.interface(), output.data());
+    // Sample only holds 24 bits of mantissa, so allow for rounding of the
+    // lowest 8 bits
+    for (size_t i = 0; i < input.size(); i++)
+        idsp::test(std::abs(static_cast<int64_t>(output[i]) - input[i]) <= 256,
+            "Interleave int32 " + std::to_string(Nc) + "ch value " + std::to_string(i));
+}
+
+void test_conversion_limits()
+{
+    idsp::test_eq(idsp::SampleFormat<int16_t>::from_sample(Sample(1)), int16_t(32767), "int16 positive clip");
+    idsp::test_eq(idsp::SampleFormat<int16_t>::from_sample(Sample(-2)), int16_t(-32768), "int16 negative clip");
+    idsp::test_eq(idsp::SampleFormat<int32_t>::from_sample(Sample(4)), int32_t(2147483520), "int32 positive clip");
+    idsp::test_eq(idsp::SampleFormat<int32_t>::from_sample(Sample(-4)), int32_t(-2147483647 - 1), "int32 negative clip");
+
+    const auto max24 = idsp::SampleFormat<idsp::PackedInt24>::from_sample(Sample(1));
+    idsp::test(max24.bytes[0] == 0xFF && max24.bytes[1] == 0xFF && max24.bytes[2] == 0x7F, "int24 positive clip");
+    idsp::test_eq(idsp::SampleFormat<idsp::PackedInt24>::to_sample(max24), Sample(8388607) / Sample(8388608), "int24 max value");
+    const auto min24 = idsp::SampleFormat<idsp::PackedInt24>::from_sample(Sample(-1));
+    idsp::test_eq(idsp::SampleFormat<idsp::PackedInt24>::to_sample(min24), Sample(-1), "int24 min value");
+
+    // Far out of range and NaN inputs clamp before they're converted
+    idsp::test_eq(idsp::SampleFormat<int16_t>::from_sample(Sample(1e6f)), int16_t(32767), "int16 large input clips");
+    idsp::test_eq(idsp::SampleFormat<int16_t>::from_sample(Sample(-1e6f)), int16_t(-32768), "int16 large negative input clips");
+    const auto large24 = idsp::SampleFormat<idsp::PackedInt24>::from_sample(Sample(1e6f));
+    idsp::test_eq(idsp::SampleFormat<idsp::PackedInt24>::to_sample(large24), Sample(8388607) / Sample(8388608), "int24 large input clips");
+    const Sample nan = std::numeric_limits<Sample>::quiet_NaN();
+    idsp::test_eq(idsp::SampleFormat<int16_t>::from_sample(nan), int16_t(32767), "int16 NaN clamps");
+    const auto nan24 = idsp::SampleFormat<idsp::PackedInt24>::from_sample(nan);
+    idsp::test_eq(idsp::SampleFormat<idsp::PackedInt24>::to_sample(nan24), Sample(8388607) / Sample(8388608), "int24 NaN clamps");
+}
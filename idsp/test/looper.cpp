@@ -0,0 +1,264 @@
+#include "idsp/looper.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace idsp::looper;
+
+static constexpr size_t data_size = 8192;
+static constexpr float sine_period = 100.f;
+
+using DataBuffer = idsp::SampleBufferStatic<data_size>;
+
+/** A sine whose period divides the loops below, so a seamless loop plays it
+ * without a break. */
+static std::unique_ptr<DataBuffer> make_data()
+{
+    auto data = std::make_unique<DataBuffer>();
+    for (size_t i = 0; i < data_size; i++)
+        (*data)[i] = Sample(std::sin(idsp::twopi * static_cast<float>(i) / sine_period));
+    return data;
+}
+
+static LoopingParamaters loop_parameters(float speed, IndexT loop_start, IndexT loop_end, IndexT fade_length)
+{
+    LoopingParamaters params{};
+    params.speed = speed;
+    params.looping_enabled = true;
+    params.loop_start = loop_start;
+    params.loop_end = loop_end;
+    params.loop_fade_length = fade_length;
+    params.data_start = 0;
+    params.data_end = static_cast<IndexT>(data_size);
+    params.data_fade_length = fade_length;
+    return params;
+}
+
+/** Runs @a tap for @a num_samples samples in blocks of @a block_size. */
+static std::vector<Sample> run(Tap& tap, const DataBuffer& data, size_t num_samples, size_t block_size)
+{
+    std::vector<Sample> output(num_samples, Sample(0));
+    for (size_t start = 0; start + block_size <= num_samples; start += block_size)
+    {
+        idsp::BufferInterface block(output.data() + start, block_size);
+        tap.process(block_size);
+        tap.render(data.interface(), block);
+        tap.update();
+    }
+    return output;
+}
+
+void test_table();
+void test_fades();
+void test_loop_crossfade();
+void test_blocks();
+void test_events();
+
+int main(int argc, const char* argv[])
+{
+    test_table();
+    test_fades();
+    test_loop_crossfade();
+    test_blocks();
+    test_events();
+    return 0;
+}
+
+void test_table()
+{
+    idsp::test_eq(xfade_table()[0], Sample(0), "Crossfade starts silent");
+    idsp::test_eq(xfade_table()[xfade_table_size - 1], Sample(1), "Crossfade ends at full gain");
+    for (size_t i = 0; i < xfade_table_size; i++)
+        idsp::test_eq(xfade_table()[i] + xfade_table()[xfade_table_size - 1 - i], Sample(1), "Fades in and out sum to 1", 1e-6f);
+}
+
+void test_fades()
+{
+    // A fade in follows the table over its length, then ends. Short fades
+    // read each gain, long ones ramp between table entries
+    constexpr size_t block_size = 16;
+    FadingPosition fp;
+    for (size_t length : {size_t(100), size_t(3000)})
+    {
+        fp.activate(1000);
+        fp.trigger_fade(FadeType::Reset, 1000, length, true, true);
+        idsp::test(fp.is_fading(FadeType::Reset) && fp.is_fading(), "Fade starts");
+        float max_difference = 0.f;
+        size_t elapsed = 0;
+        const size_t num_blocks = length / block_size + 2;
+        for (size_t block = 0; block < num_blocks; block++)
+        {
+            idsp::SampleBufferStatic<block_size> ones;
+            auto gains = ones.interface();
+            gains.fill(Sample(1));
+            fp.process(0.5f * block_size, block_size);
+            fp.apply_xfade(gains);
+            fp.update();
+            for (size_t i = 0; i < block_size; i++, elapsed++)
+            {
+                const float progress = idsp::min(static_cast<float>(elapsed) / static_cast<float>(length), 1.f);
+                max_difference = idsp::max(max_difference, std::abs(gains[i] - xfade_table().read(progress)));
+            }
+        }
+        idsp::test_eq(max_difference, 0.f, "Fade in follows the table, length " + std::to_string(length), 1e-5f);
+        idsp::test(!fp.is_fading() && fp.is_active(), "Fade in ends at full gain");
+        idsp::test_eq(fp.total(), 1000.f + 0.5f * static_cast<float>(num_blocks * block_size), "Position moves by blocks");
+    }
+    constexpr size_t length = 100;
+
+    // A fade out ends silent and deactivates the position
+    fp.trigger_fade(FadeType::Kill, fp.index(), length, false, true);
+    for (size_t block = 0; block < 7; block++)
+    {
+        fp.process(0.5f * block_size, block_size);
+        fp.update();
+    }
+    idsp::test(!fp.is_active(), "Fade out deactivates");
+
+    // A position-following fade waits for the position to reach its start,
+    // even partway through a block
+    fp.activate(0);
+    fp.trigger_fade(FadeType::Loop, 10, length, false, true);
+    idsp::SampleBufferStatic<block_size> ones;
+    auto gains = ones.interface();
+    gains.fill(Sample(1));
+    fp.process(static_cast<float>(block_size), block_size);
+    fp.apply_xfade(gains);
+    bool waits = true;
+    for (size_t i = 0; i <= 10; i++)
+        waits = waits && gains[i] == Sample(1);
+    idsp::test(waits && gains[15] < Sample(1), "Loop fade starts at its position");
+}
+
+void test_loop_crossfade()
+{
+    auto data = make_data();
+
+    // Forward, backward and fractional speeds play the sine without a break
+    // at either loop point, the fade length a multiple of its period or not
+    for (float speed : {1.f, -1.f, 0.5f, -1.5f, 2.f})
+    {
+        for (IndexT fade_length : {IndexT(200), IndexT(173)})
+        {
+            const IndexT loop_start = 1000;
+            const IndexT loop_end = loop_start + 2000 + fade_length;
+            Tap tap;
+            tap.set_loop_parameters(loop_parameters(speed, loop_start, loop_end, fade_length));
+            tap.activate();
+            const std::string name = "speed " + std::to_string(speed) + ", fade " + std::to_string(fade_length);
+
+            constexpr size_t num_samples = 32000;
+            const auto output = run(tap, *data, num_samples, 64);
+            const float phase = speed > 0.f ? static_cast<float>(loop_start) : static_cast<float>(loop_end - 1);
+            float max_difference = 0.f;
+            for (size_t i = static_cast<size_t>(fade_length); i < num_samples; i++)
+            {
+                const float expected = std::sin(idsp::twopi * (phase + speed * static_cast<float>(i)) / sine_period);
+                max_difference = idsp::max(max_difference, std::abs(output[i] - expected));
+            }
+            idsp::test_eq(max_difference, 0.f, "Seamless loop, " + name, 1e-3f);
+
+            size_t active = 0;
+            for (const auto* fp : tap.active_list())
+                active += fp != nullptr ? 1 : 0;
+            idsp::test(active <= 2, "At most two positions playing, " + name);
+            const float position = tap.position().total();
+            idsp::test(position >= static_cast<float>(loop_start) && position <= static_cast<float>(loop_end), "Position stays in the loop, " + name);
+        }
+    }
+
+    // Without looping the data region wraps the same way
+    Tap tap;
+    auto params = loop_parameters(1.f, 0, 0, 100);
+    params.looping_enabled = false;
+    params.data_end = 8100;
+    tap.set_loop_parameters(params);
+    tap.activate();
+    const auto output = run(tap, *data, 3 * data_size, 64);
+    float max_difference = 0.f;
+    for (size_t i = 100; i < output.size(); i++)
+        max_difference = idsp::max(max_difference, std::abs(output[i] - std::sin(idsp::twopi * static_cast<float>(i) / sine_period)));
+    idsp::test_eq(max_difference, 0.f, "Seamless data wrap", 1e-3f);
+}
+
+void test_blocks()
+{
+    // Moving by blocks matches moving a sample at a time, crossings
+    // included, for short fades and for long ones that ramp between table
+    // entries
+    auto data = make_data();
+    for (float speed : {1.f, -0.75f, 1.3f})
+    {
+        for (IndexT fade_length : {IndexT(150), IndexT(1200)})
+        {
+            Tap by_block, by_sample;
+            const auto params = loop_parameters(speed, 500, 500 + 6 * fade_length, fade_length);
+            by_block.set_loop_parameters(params);
+            by_sample.set_loop_parameters(params);
+            by_block.activate();
+            by_sample.activate();
+            const auto blocks = run(by_block, *data, 25600, 128);
+            const auto samples = run(by_sample, *data, 25600, 1);
+            float max_difference = 0.f;
+            for (size_t i = 0; i < blocks.size(); i++)
+                max_difference = idsp::max(max_difference, std::abs(blocks[i] - samples[i]));
+            idsp::test_eq(max_difference, 0.f, "Blocks match samples, speed " + std::to_string(speed) + ", fade " + std::to_string(fade_length), 1e-3f);
+        }
+    }
+}
+
+void test_events()
+{
+    auto data = make_data();
+    Tap tap;
+    tap.set_loop_parameters(loop_parameters(1.f, 1000, 5000, 200));
+    idsp::test(!tap.is_active(), "Tap starts inactive");
+    tap.activate();
+    idsp::test(tap.is_active(), "Tap activates");
+    idsp::test_eq(tap.position().index(), IndexT(1000), "Tap starts at the loop start");
+    run(tap, *data, 640, 64);
+
+    // Kill fades out within the short fade
+    tap.kill();
+    const auto killed = run(tap, *data, 128, 64);
+    idsp::test(!tap.is_active(), "Killed tap deactivates");
+    idsp::test_eq(killed[127], Sample(0), "Killed tap is silent");
+
+    // Pause returns the position, and unpausing resumes from it
+    tap.activate();
+    run(tap, *data, 640, 64);
+    const Position paused = tap.pause();
+    idsp::test_eq(paused.index(), IndexT(1640), "Pause returns the position");
+    run(tap, *data, 256, 64);
+    idsp::test(!tap.is_active(), "Paused tap goes quiet");
+    tap.unpause(paused);
+    idsp::test_eq(tap.position().index(), IndexT(1640), "Unpause resumes from the paused position");
+
+    // Restart crossfades back to the start
+    run(tap, *data, 640, 64);
+    tap.restart();
+    idsp::test_eq(tap.position().index(), IndexT(1000), "Restart returns to the start");
+    idsp::test_eq(tap.coposition().index(), IndexT(2280), "The old position fades out");
+    run(tap, *data, 256, 64);
+    idsp::test(tap.active_list()[1] == nullptr, "The old position ends");
+
+    // Syncronising takes another tap's loop and position
+    Tap other;
+    other.set_loop_parameters(loop_parameters(1.f, 2000, 3000, 100));
+    other.activate();
+    run(other, *data, 320, 64);
+    tap.syncronise(other);
+    idsp::test_eq(tap.position().index(), other.position().index(), "Syncronised position");
+    idsp::test_eq(tap.loop_parameters().loop_end_fade, IndexT(2900), "Syncronised loop");
+
+    // Deactivating fades out over the loop fade
+    tap.deactivate();
+    run(tap, *data, 320, 64);
+    idsp::test(!tap.is_active(), "Deactivated tap ends");
+    tap.reset();
+    idsp::test(!tap.is_active(), "Reset tap is inactive");
+}
@@ -0,0 +1,256 @@
+#include "idsp/looper_stream.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace idsp::looper;
+
+static constexpr size_t data_size = 40000;
+static constexpr float sine_period = 100.f;
+
+// a small cache, so that the loops below stream through it
+using Stream = StreamingBuffer<256, 16, 4, 4096>;
+static constexpr IndexT max_length = 1 << 20;
+using DataBuffer = idsp::SampleBufferStatic<data_size>;
+
+static const std::string path = "/tmp/idsp_test_looper_stream_" + std::to_string(getpid()) + ".raw";
+
+static std::unique_ptr<DataBuffer> make_data()
+{
+    auto data = std::make_unique<DataBuffer>();
+    for (size_t i = 0; i < data_size; i++)
+        (*data)[i] = Sample(std::sin(idsp::twopi * static_cast<float>(i) / sine_period));
+    return data;
+}
+
+/** Records @a data to @a stream in blocks, letting the queue drain. */
+static void record(Stream& stream, const DataBuffer& data)
+{
+    for (size_t start = 0; start < data_size; start += 64)
+    {
+        stream.write(static_cast<IndexT>(start), data.data() + start, idsp::min<size_t>(64, data_size - start));
+        if (start % 2048 == 0)
+            idsp::test(stream.wait_until_idle(), "I/O thread drains the recording");
+    }
+    idsp::test(stream.wait_until_idle(), "I/O thread drains the recording");
+}
+
+static LoopingParamaters loop_parameters(float speed)
+{
+    LoopingParamaters params{};
+    params.speed = speed;
+    params.looping_enabled = true;
+    params.loop_start = 1000;
+    params.loop_end = 31000;
+    params.loop_fade_length = 200;
+    params.data_start = 0;
+    params.data_end = static_cast<IndexT>(data_size);
+    params.data_fade_length = 200;
+    return params;
+}
+
+void test_record();
+void test_playback();
+void test_misses();
+void test_record_head();
+
+int main(int argc, const char* argv[])
+{
+    std::remove(path.c_str());
+    test_record();
+    test_playback();
+    test_misses();
+    test_record_head();
+    std::remove(path.c_str());
+    return 0;
+}
+
+void test_record()
+{
+    auto data = make_data();
+    {
+        auto stream = std::make_unique<Stream>(path, max_length);
+        idsp::test(stream->is_open(), "File opens");
+        idsp::test_eq(stream->length(), IndexT(0), "New file is empty");
+        record(*stream, *data);
+        idsp::test_eq(stream->length(), static_cast<IndexT>(data_size), "Recording extends the file");
+        idsp::test_eq(stream->get_stats().overruns, uint64_t(0), "No overruns");
+    }
+
+    // Reopening keeps the recording, and a missed block is loaded for the
+    // next read
+    auto stream = std::make_unique<Stream>(path, max_length);
+    idsp::test_eq(stream->length(), static_cast<IndexT>(data_size), "Reopened file keeps its length");
+    std::array<Sample, 300> output;
+    stream->read(5000, output.data(), output.size());
+    idsp::test(stream->get_stats().misses > 0, "Cold read misses");
+    idsp::test(stream->wait_until_idle(), "I/O thread loads the missed block");
+    stream->read(5000, output.data(), output.size());
+    idsp::test(stream->wait_until_idle(), "I/O thread loads the missed block");
+    stream->read(5000, output.data(), output.size());
+    bool same = true;
+    for (size_t i = 0; i < output.size(); i++)
+        same = same && output[i] == (*data)[5000 + i];
+    idsp::test(same, "Read after loading returns the recording");
+    idsp::test(!Stream("/nonexistent/directory/file.raw", max_length).is_open(), "Bad path doesn't open");
+}
+
+void test_playback()
+{
+    // A Tap streaming a loop longer than the cache plays what it plays from
+    // memory, if the prefetcher keeps up
+    auto data = make_data();
+    auto stream = std::make_unique<Stream>(path, max_length);
+    for (float speed : {1.f, -1.5f, 7.f})
+    {
+        Tap from_memory, from_stream;
+        from_memory.set_loop_parameters(loop_parameters(speed));
+        from_stream.set_loop_parameters(loop_parameters(speed));
+        from_memory.activate();
+        from_stream.activate();
+        stream->reset_stats();
+        float max_difference = 0.f;
+        std::array<Sample, 64> expected, played;
+        for (size_t block = 0; block < 600; block++)
+        {
+            expected.fill(Sample(0));
+            played.fill(Sample(0));
+            idsp::BufferInterface expected_block(expected.data(), expected.size());
+            idsp::BufferInterface played_block(played.data(), played.size());
+            from_memory.process(64);
+            from_memory.render(data->interface(), expected_block);
+            from_memory.update();
+            from_stream.process(64);
+            stream->follow(0, from_stream);
+            idsp::test(stream->wait_until_idle(), "I/O thread keeps up with playback");
+            from_stream.render_from(*stream, played_block);
+            from_stream.update();
+            for (size_t i = 0; i < expected.size(); i++)
+                max_difference = idsp::max(max_difference, std::abs(expected[i] - played[i]));
+        }
+        const std::string name = "speed " + std::to_string(speed);
+        idsp::test_eq(max_difference, 0.f, "Streamed playback matches memory, " + name, 1e-6f);
+        const auto stats = stream->get_stats();
+        idsp::test_eq(stats.underruns, uint64_t(0), "No underruns, " + name);
+        idsp::test(stats.hits > 0 && stats.hit_rate() == 1.0, "Every read hits, " + name);
+        idsp::test(stats.loads > Stream::num_slots, "Playback streams through the cache, " + name);
+    }
+}
+
+void test_misses()
+{
+    auto data = make_data();
+    auto stream = std::make_unique<Stream>(path, max_length);
+    stream->reset_stats();
+
+    // Reads of uncached blocks are silent and counted, reads outside the data
+    // are silent and not
+    std::array<Sample, 64> output;
+    output.fill(Sample(1));
+    stream->read(20000, output.data(), output.size());
+    bool silent = true;
+    for (auto x : output)
+        silent = silent && x == Sample(0);
+    idsp::test(silent, "Miss is silent");
+    auto stats = stream->get_stats();
+    idsp::test_eq(stats.misses, uint64_t(1), "Miss counted");
+    idsp::test_eq(stats.underruns, uint64_t(64), "Underrun counted");
+    stream->read(-100, output.data(), output.size());
+    stream->read(static_cast<IndexT>(data_size) + 100, output.data(), output.size());
+    idsp::test_eq(stream->get_stats().misses, uint64_t(1), "Reads outside the data aren't misses");
+
+    // Overdubbing a cached block updates it
+    idsp::test(stream->wait_until_idle(), "I/O thread loads the missed block");
+    std::array<Sample, 64> dub;
+    dub.fill(Sample(0.25f));
+    stream->write(20010, dub.data(), dub.size());
+    idsp::test(stream->wait_until_idle(), "I/O thread writes the overdub");
+    stream->read(20000, output.data(), output.size());
+    idsp::test_eq(output[9], (*data)[20009], "Overdub leaves the samples before it");
+    idsp::test_eq(output[10], Sample(0.25f), "Overdub updates the cache");
+
+    // A full queue drops writes as overruns
+    std::vector<Sample> burst(8192, Sample(0));
+    idsp::test(!stream->write(0, burst.data(), burst.size()), "Write larger than the queue is dropped");
+    idsp::test_eq(stream->get_stats().overruns, uint64_t(8192), "Overrun counted");
+    idsp::test(!stream->write(max_length - 10, dub.data(), dub.size()), "Write past the maximum length is dropped");
+}
+
+void test_record_head()
+{
+    // A tap right behind the record head extending the file, from a cached
+    // block that's silent past the old end, never hits a block that doesn't
+    // hold the recording yet. Overdubs land behind the audio thread, so only
+    // samples past the old end are guaranteed to miss until then
+    auto stream = std::make_unique<Stream>(path, max_length);
+    constexpr IndexT record_start = static_cast<IndexT>(data_size);
+    idsp::test_eq(stream->length(), record_start, "Recording starts at the end of the file");
+    constexpr size_t num_blocks = 160;
+    std::vector<Sample> recording(num_blocks * 64);
+    for (size_t i = 0; i < recording.size(); i++)
+        recording[i] = Sample(0.5f) + Sample(0.25f * std::sin(0.01f * static_cast<float>(i)));
+
+    Tap tap;
+    auto params = loop_parameters(1.f);
+    params.loop_start = record_start - 1000;
+    params.loop_end = record_start + static_cast<IndexT>(recording.size());
+    params.data_end = params.loop_end;
+    tap.set_loop_parameters(params);
+    tap.activate();
+    tap.process(64);
+    stream->follow(0, tap);
+    idsp::test(stream->wait_until_idle(), "I/O thread caches the blocks behind the record head");
+
+    bool stale = false;
+    size_t num_landed = 0;
+    std::array<Sample, 64> output;
+    for (size_t block = 0; block < num_blocks; block++)
+    {
+        const IndexT head = record_start + static_cast<IndexT>(block * 64);
+        idsp::test(stream->write(head, recording.data() + block * 64, 64), "Recording is queued");
+        tap.update();
+        tap.process(64);
+        stream->follow(0, tap);
+        // read the block just written until it lands, checking every hit
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        bool landed = false;
+        while (!landed && std::chrono::steady_clock::now() < deadline)
+        {
+            const uint64_t hits = stream->get_stats().hits;
+            stream->read(head, output.data(), output.size());
+            landed = stream->get_stats().hits != hits;
+            for (size_t i = 0; landed && i < output.size(); i++)
+                stale = stale || output[i] != recording[block * 64 + i];
+        }
+        num_landed += landed ? 1 : 0;
+    }
+    idsp::test(!stale, "Reads behind the record head hit only the recording");
+    idsp::test(num_landed > num_blocks / 2, "Reads behind the record head hit once it's written");
+    idsp::test(stream->wait_until_idle(), "I/O thread drains the recording");
+    stream->unfollow(0);
+
+    // With more followed blocks than slots, the stream never reports idle
+    std::array<Tap, 4> taps;
+    for (size_t t = 0; t < taps.size(); t++)
+    {
+        auto spread = loop_parameters(1.f);
+        spread.loop_start = static_cast<IndexT>(t * 8000);
+        spread.loop_end = spread.loop_start + 4000;
+        taps[t].set_loop_parameters(spread);
+        taps[t].activate();
+        taps[t].process(64);
+        stream->follow(t, taps[t]);
+    }
+    idsp::test(!stream->wait_until_idle(std::chrono::milliseconds(100)), "Cache too small for the followed blocks isn't idle");
+    for (size_t t = 0; t < taps.size(); t++)
+        stream->unfollow(t);
+    idsp::test(stream->wait_until_idle(), "Idle again once the cursors stop");
+}
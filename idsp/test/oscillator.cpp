@@ -0,0 +1,281 @@
+#include "idsp/oscillator.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <cmath>
+#include <vector>
+
+static constexpr size_t table_size = 2049;
+static constexpr size_t num_levels = 9;
+
+void test_single_level();
+void test_levels();
+void test_aliasing();
+void test_shared();
+void test_bank();
+void test_fixed_phase();
+
+int main(int argc, const char* argv[])
+{
+    test_single_level();
+    test_levels();
+    test_aliasing();
+    test_shared();
+    test_bank();
+    test_fixed_phase();
+    return 0;
+}
+
+/** @returns The magnitude of harmonic @a h of the first @a period samples of @a x. */
+template<class C>
+static double harmonic_magnitude(const C& x, size_t period, size_t h)
+{
+    double re = 0, im = 0;
+    for (size_t n = 0; n < period; n++)
+    {
+        const double phase = 2 * M_PI * static_cast<double>((h * n) % period) / static_cast<double>(period);
+        re += static_cast<double>(x[n]) * std::cos(phase);
+        im -= static_cast<double>(x[n]) * std::sin(phase);
+    }
+    return std::sqrt(re * re + im * im) / static_cast<double>(period);
+}
+
+static Sample saw(idsp::SampleParameter p)
+{
+    return Sample(1.f - 2.f * p);
+}
+
+void test_single_level()
+{
+    // A single level reads the table as given
+    const idsp::LookupTable<Sample, 128> table(saw);
+    const idsp::WavetableOscillator<128>::Table shared(table);
+    idsp::WavetableOscillator<128> osc(shared);
+    osc.set_rate(0.0123f);
+    float phase = 0;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        phase = idsp::wrap(phase + 0.0123f);
+        idsp::test_eq(osc.process(), static_cast<float>(table.read(phase)), "Single level oscillator");
+    }
+}
+
+void test_levels()
+{
+    using Mipmap = idsp::MipmappedWavetable<table_size, num_levels>;
+    const Mipmap mipmap {Mipmap::Wavetable(saw)};
+    const idsp::LookupTable<Sample, table_size> table(saw);
+
+    for (size_t i = 0; i < table_size; i++)
+        idsp::test_eq(mipmap.table(0)[i], table[i], "Level 0 is the source table");
+
+    // Each level keeps its harmonics and drops everything above them
+    for (size_t level = 1; level < num_levels; level++)
+    {
+        const auto& samples = mipmap.table(level);
+        const size_t kept = Mipmap::harmonics(level);
+        idsp::test_eq(samples[Mipmap::period], samples[0], "Level " + std::to_string(level) + " wraps");
+        for (size_t h : {size_t(1), kept})
+            idsp::test_eq(harmonic_magnitude(samples, Mipmap::period, h), harmonic_magnitude(table.table(), Mipmap::period, h),
+                "Level " + std::to_string(level) + " keeps harmonic " + std::to_string(h), 1e-4);
+        for (size_t h : {kept + 1, kept * 2, Mipmap::period / 2})
+            idsp::test(harmonic_magnitude(samples, Mipmap::period, h) < 1e-5,
+                "Level " + std::to_string(level) + " drops harmonic " + std::to_string(h));
+    }
+
+    idsp::test_eq(Mipmap::select_level(0.f), size_t(0), "Level for rate 0");
+    idsp::test_eq(Mipmap::select_level(0.5f / 1024.f), size_t(0), "Level for the top of level 0");
+    idsp::test_eq(Mipmap::select_level(0.5f / 1023.f), size_t(1), "Level just above level 0");
+    idsp::test_eq(Mipmap::select_level(-0.01f), size_t(5), "Level for a negative rate");
+    idsp::test_eq(Mipmap::select_level(0.49f), num_levels - 1, "Level for rates past the last level");
+}
+
+/** @returns The ratio in dB of the power at harmonics of @a cycles to the power
+ * everywhere else, over @a x which holds exactly @a cycles periods. */
+static double alias_rejection(const std::vector<float>& x, size_t cycles)
+{
+    const size_t length = x.size();
+    double harmonic = 0, other = 0;
+    for (size_t bin = 1; bin < length / 2; bin++)
+    {
+        const double power = std::pow(harmonic_magnitude(x, length, bin), 2);
+        if (bin % cycles == 0)
+            harmonic += power;
+        else
+            other += power;
+    }
+    return 10 * std::log10(harmonic / other);
+}
+
+template<size_t Levels>
+static double render_rejection(size_t cycles, size_t length)
+{
+    static const idsp::MipmappedWavetable<table_size, Levels> table {idsp::LookupTable<Sample, table_size>(saw)};
+    idsp::WavetableOscillator<table_size, Levels> osc(table);
+    osc.set_rate(static_cast<float>(cycles) / static_cast<float>(length));
+    std::vector<float> x(length);
+    for (auto& y : x)
+        y = osc.process();
+    return alias_rejection(x, cycles);
+}
+
+void test_aliasing()
+{
+    // Rates from 740 Hz to 5.8 kHz at 48 kHz, each an exact number of cycles
+    // in the analysis window
+    constexpr size_t length = 1999;
+    for (size_t cycles : {31, 63, 127, 241})
+    {
+        const double naive = render_rejection<1>(cycles, length);
+        const double mipmapped = render_rejection<num_levels>(cycles, length);
+        idsp::test(naive < 20, "Single level saw aliases at " + std::to_string(cycles) + " cycles: " + std::to_string(naive) + " dB");
+        idsp::test(mipmapped > 70, "Mipmapped saw rejects aliasing at " + std::to_string(cycles) + " cycles: " + std::to_string(mipmapped) + " dB");
+    }
+}
+
+void test_shared()
+{
+    // The standard waveforms are built at compile time and match the tables
+    // the runtime generators would build
+    using Shared = idsp::SharedWavetable<128>;
+    const idsp::Waveform waveforms[] = {idsp::Waveform::sine, idsp::Waveform::triangle, idsp::Waveform::square, idsp::Waveform::sawtooth, idsp::Waveform::ramp};
+    const char* names[] = {"sine", "triangle", "square", "sawtooth", "ramp"};
+    for (size_t w = 0; w < 5; w++)
+    {
+        for (bool bipolar : {true, false})
+        {
+            const auto& table = Shared::get(waveforms[w], bipolar).table(0);
+            for (size_t i = 0; i < table.size(); i++)
+            {
+                const float p = static_cast<float>(i) / 127.f;
+                float expected;
+                switch (waveforms[w])
+                {
+                    case idsp::Waveform::sine: expected = std::sin(p * idsp::twopi); break;
+                    case idsp::Waveform::triangle: expected = p < 0.75f ? 1.f - 2.f * std::abs(p - 0.25f) : 2.f * (p - 0.75f); break;
+                    case idsp::Waveform::square: expected = p < 0.5f ? 1.f : 0.f; break;
+                    case idsp::Waveform::sawtooth: expected = 1.f - p; break;
+                    default: expected = p; break;
+                }
+                if (bipolar && waveforms[w] != idsp::Waveform::sine)
+                    expected = 2.f * expected - 1.f;
+                if (!bipolar && waveforms[w] == idsp::Waveform::sine)
+                    expected = 0.5f * expected + 0.5f;
+                idsp::test_eq(static_cast<float>(table[i]), expected, std::string("Shared ") + names[w] + (bipolar ? " bipolar" : " unipolar"), 1e-6f);
+            }
+        }
+    }
+
+    // Oscillators reference one table instead of each holding a copy
+    idsp::WavetableOscillator<128> a(idsp::Waveform::sine, true), b(idsp::Waveform::sine, true);
+    idsp::test(sizeof(a) < 128 * sizeof(Sample), "Oscillator doesn't hold its table");
+    idsp::test(&Shared::get(idsp::Waveform::sine, true) == &Shared::get(idsp::Waveform::sine, true), "Table is shared");
+    idsp::test(&Shared::get(idsp::Waveform::sine, true) != &Shared::get(idsp::Waveform::sine, false), "Tables are per waveform");
+    a.set_rate(0.01f);
+    b.set_rate(0.01f);
+    for (size_t i = 0; i < 200; i++)
+        idsp::test_eq(a.process(), b.process(), "Oscillators sharing a table");
+
+    // Mipmapped tables are shared too, and built only once
+    const auto& mipmap = idsp::SharedWavetable<table_size, num_levels>::get(idsp::Waveform::sawtooth, true);
+    idsp::test(&mipmap == &idsp::SharedWavetable<table_size, num_levels>::get(idsp::Waveform::sawtooth, true), "Mipmapped table is shared");
+}
+
+void test_bank()
+{
+    // Every lane matches a WavetableOscillator with the same settings,
+    // through both the frame and the block processors
+    constexpr size_t lanes = 7;
+    const idsp::Waveform waveforms[] = {idsp::Waveform::sine, idsp::Waveform::triangle, idsp::Waveform::square, idsp::Waveform::sawtooth, idsp::Waveform::ramp};
+    idsp::OscillatorBank<lanes> bank(idsp::Waveform::sine, true);
+    std::vector<idsp::WavetableOscillator<128>> reference;
+    for (size_t n = 0; n < lanes; n++)
+    {
+        const bool bipolar = n % 2 == 0;
+        const float rate = 0.0031f * static_cast<float>(n + 1) * (n == 3 ? -1.f : 1.f);
+        const float offset = 0.1f * static_cast<float>(n);
+        reference.emplace_back(waveforms[n % 5], bipolar);
+        reference[n].set_rate(rate);
+        reference[n].set_phase_offset(offset);
+        bank.set_waveform(n, waveforms[n % 5], bipolar);
+        bank.set_rate(n, rate);
+        bank.set_phase_offset(n, offset);
+    }
+
+    std::array<Sample, lanes> frame;
+    for (size_t i = 0; i < 100; i++)
+    {
+        bank.process(frame.data());
+        for (size_t n = 0; n < lanes; n++)
+            idsp::test_eq(static_cast<float>(frame[n]), reference[n].process(), "Bank frame lane " + std::to_string(n));
+    }
+
+    idsp::PolySampleBufferStatic<37, lanes> block;
+    auto& output = block.interface();
+    for (size_t round = 0; round < 20; round++)
+    {
+        bank.process_for<37>(output);
+        for (size_t i = 0; i < 37; i++)
+            for (size_t n = 0; n < lanes; n++)
+                idsp::test_eq(static_cast<float>(block.channel(n)[i]), reference[n].process(), "Bank block lane " + std::to_string(n));
+    }
+    for (size_t n = 0; n < lanes; n++)
+        idsp::test_eq(bank.get_phase(n), reference[n].get_phase(), "Bank phase lane " + std::to_string(n));
+}
+
+template<idsp::Waveform W, bool Bipolar>
+static void test_fixed_raw(float rate, float offset, const std::string& name)
+{
+    idsp::RawOscillator reference(W, Bipolar);
+    idsp::FixedRawOscillator<W, Bipolar> osc;
+    reference.set_rate(rate);
+    osc.set_rate(rate);
+    reference.set_phase_offset(offset);
+    osc.set_phase_offset(offset);
+    for (size_t i = 0; i < 1000; i++)
+        idsp::test_eq(osc.process(), reference.process(), "FixedRawOscillator " + name, 1e-5f);
+}
+
+template<idsp::Waveform W, bool Bipolar>
+static void test_fixed_wavetable(float rate, const std::string& name)
+{
+    idsp::WavetableOscillator<129> reference(W, Bipolar);
+    idsp::FixedWavetableOscillator<W, Bipolar> osc;
+    reference.set_rate(rate);
+    osc.set_rate(rate);
+    for (size_t i = 0; i < 1000; i++)
+        idsp::test_eq(osc.process(), reference.process(), "FixedWavetableOscillator " + name, 1e-5f);
+}
+
+void test_fixed_phase()
+{
+    // The integer phase wraps through overflow in both directions
+    idsp::PhaseAccumulator phase;
+    phase.set_rate(0.75f);
+    phase.advance();
+    phase.advance();
+    idsp::test_eq(phase.get_phase(), 0.5f, "Phase wraps forwards");
+    phase.set_rate(-0.25f);
+    phase.advance();
+    phase.advance();
+    phase.advance();
+    idsp::test_eq(phase.get_phase(), 0.75f, "Phase wraps backwards");
+    idsp::test(idsp::PhaseAccumulator::to_float(0xFFFFFFFF) < 1.f, "Phase stays below one cycle");
+    phase.set_phase_offset(0.5f);
+    idsp::test_eq(phase.get_phase(), 0.25f, "Phase offset");
+    phase.set_phase(0.125f);
+    idsp::test_eq(phase.get_phase(), 0.625f, "Phase set relative to the offset");
+
+    // With exactly representable rates the integer and float phases agree,
+    // so the outputs match the float-phase oscillators
+    const float rate = 1.f / 128.f + 1.f / 1024.f;
+    test_fixed_raw<idsp::Waveform::sine, true>(rate, 0.25f, "sine");
+    test_fixed_raw<idsp::Waveform::triangle, false>(rate, 0.f, "triangle");
+    test_fixed_raw<idsp::Waveform::square, true>(-rate, 0.5f, "square");
+    test_fixed_raw<idsp::Waveform::sawtooth, true>(rate, 0.f, "sawtooth");
+    test_fixed_raw<idsp::Waveform::ramp, false>(-rate, 0.f, "ramp");
+    test_fixed_wavetable<idsp::Waveform::sine, true>(rate, "sine");
+    test_fixed_wavetable<idsp::Waveform::triangle, true>(rate, "triangle");
+    test_fixed_wavetable<idsp::Waveform::sawtooth, false>(rate, "sawtooth");
+}
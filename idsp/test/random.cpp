@@ -0,0 +1,110 @@
+#include "idsp/random.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+
+#include <random>
+
+void test_generator();
+void test_distribution();
+void test_blocks();
+
+int main(int argc, const char* argv[])
+{
+    test_generator();
+    test_distribution();
+    test_blocks();
+    return 0;
+}
+
+void test_generator()
+{
+    // Seeding is deterministic
+    idsp::Xoshiro128 a(1234), b(1234), c(1235);
+    bool same = true, different = true;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const uint32_t x = a();
+        same = same && x == b();
+        different = different && x != c();
+    }
+    idsp::test(same, "Same seed gives the same sequence");
+    idsp::test(different, "Neighbouring seeds give unrelated sequences");
+    a.seed(1234);
+    b.seed(1234);
+    idsp::test_eq(a(), b(), "Reseeding restarts the sequence");
+
+    // Default-constructed generators don't share a stream
+    idsp::Xoshiro128 d, e;
+    idsp::test(d() != e(), "Default generators differ");
+
+    // Small enough for every noise source to carry its own
+    idsp::test(sizeof(idsp::WhiteNoise) <= 16, "WhiteNoise holds 16 bytes of state");
+
+    // Drives the standard distributions
+    std::uniform_int_distribution<int> dice(1, 6);
+    bool in_range = true;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        const int x = dice(a);
+        in_range = in_range && x >= 1 && x <= 6;
+    }
+    idsp::test(in_range, "Standard distribution");
+}
+
+void test_distribution()
+{
+    // Uniform over [0, 1) and [-1, 1): check the range, mean and variance
+    constexpr size_t count = 1 << 20;
+    idsp::WhiteNoise noise(42);
+    double sum = 0, sum_squares = 0;
+    float lowest = 1.f, highest = -1.f;
+    for (size_t i = 0; i < count; i++)
+    {
+        const float x = noise.positive();
+        lowest = idsp::min(lowest, x);
+        highest = idsp::max(highest, x);
+        sum += x;
+        sum_squares += static_cast<double>(x) * x;
+    }
+    const double mean = sum / count;
+    idsp::test(lowest >= 0.f && highest < 1.f, "Positive noise range");
+    idsp::test_eq(mean, 0.5, "Positive noise mean", 2e-3);
+    idsp::test_eq(sum_squares / count - mean * mean, 1.0 / 12.0, "Positive noise variance", 2e-3);
+
+    idsp::test_eq(idsp::Xoshiro128::to_bipolar(0), -1.f, "Bipolar minimum");
+    idsp::test(idsp::Xoshiro128::to_bipolar(UINT32_MAX) < 1.f, "Bipolar maximum");
+}
+
+template<class Noise>
+static void test_block(const std::string& name, Noise& per_sample, Noise& block)
+{
+    // Odd sizes cover partial tiles
+    idsp::SampleBufferStatic<77> buffer;
+    for (size_t round = 0; round < 5; round++)
+    {
+        if (round % 2)
+            block.process(buffer.interface());
+        else
+            block.template process_for<77>(buffer.interface());
+        for (size_t i = 0; i < buffer.size(); i++)
+            idsp::test_eq(buffer[i], Sample(per_sample.bipolar()), name + " block matches per-sample");
+    }
+}
+
+void test_blocks()
+{
+    idsp::WhiteNoise white_a(7), white_b(7);
+    test_block("WhiteNoise", white_a, white_b);
+    idsp::PinkNoise pink_a(7), pink_b(7);
+    test_block("PinkNoise", pink_a, pink_b);
+    idsp::BlueNoise blue_a(7), blue_b(7);
+    test_block("BlueNoise", blue_a, blue_b);
+    for (auto colour : {idsp::NoiseSource::Colour::white, idsp::NoiseSource::Colour::pink, idsp::NoiseSource::Colour::blue})
+    {
+        idsp::NoiseSource a(9), b(9);
+        a.set_noise_colour(colour);
+        b.set_noise_colour(colour);
+        test_block("NoiseSource", a, b);
+    }
+}
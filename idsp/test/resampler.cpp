@@ -0,0 +1,127 @@
+#include "idsp/resampler.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+#include "idsp/ringbuffer.hpp"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+static constexpr size_t buffer_size = 4096;
+
+template<size_t Taps>
+void test_tier();
+
+int main(int argc, const char* argv[])
+{
+    test_tier<4>();
+    test_tier<8>();
+    test_tier<16>();
+    test_tier<32>();
+    return 0;
+}
+
+/** RMS of @a ratio-rate reads of a sine at @a frequency cycles per sample,
+ * away from the ends of the buffer. */
+template<class Interpolator>
+static float read_sine_rms(const Interpolator& interpolator, size_t level, float frequency, float ratio)
+{
+    auto audio = std::make_unique<idsp::SampleBufferStatic<buffer_size>>();
+    idsp::AudioRingBuffer ring(*audio);
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(std::sin(idsp::twopi * frequency * static_cast<float>(i))));
+
+    std::vector<float> positions;
+    for (float position = 100.25f; position < static_cast<float>(buffer_size) - 100.f; position += ratio)
+        positions.push_back(position);
+    std::vector<Sample> output(positions.size());
+    ring.read_at(interpolator, level, positions.data(), output.data(), positions.size());
+    double sum = 0.0;
+    for (auto x : output)
+        sum += static_cast<double>(x) * static_cast<double>(x);
+    return static_cast<float>(std::sqrt(sum / static_cast<double>(output.size())));
+}
+
+template<size_t Taps>
+void test_tier()
+{
+    using Interpolator = idsp::SincInterpolator<Taps>;
+    const std::string tier = std::to_string(Taps) + " taps";
+    auto interpolator = std::make_unique<Interpolator>();
+
+    idsp::test_eq(Interpolator::select_level(0.5f), size_t(0), "Level 0 below the source rate, " + tier);
+    idsp::test_eq(Interpolator::select_level(1.f), size_t(0), "Level 0 at the source rate, " + tier);
+    idsp::test_eq(Interpolator::select_level(1.5f), size_t(1), "Level 1 up to an octave up, " + tier);
+    idsp::test_eq(Interpolator::select_level(4.f), size_t(2), "Level 2 up to two octaves up, " + tier);
+    idsp::test_eq(Interpolator::select_level(-3.f), size_t(2), "Levels follow the magnitude of the rate, " + tier);
+
+    // DC passes at unity at every level and fraction
+    std::vector<Sample> ones(2 * Interpolator::max_taps, Sample(1));
+    for (size_t level = 0; level < 3; level++)
+        for (float fraction = 0.f; fraction < 1.f; fraction += 0.01f)
+            idsp::test_eq(interpolator->read(level, ones.data() + Interpolator::max_taps, fraction), Sample(1), "DC gain, " + tier, 1e-5f);
+
+    // Reads that wrap the ends of the buffer match reads that don't
+    auto audio = std::make_unique<idsp::SampleBufferStatic<buffer_size>>();
+    idsp::AudioRingBuffer ring(*audio);
+    for (size_t i = 0; i < buffer_size; i++)
+        ring.write(Sample(std::sin(0.01f * static_cast<float>(i * i % 1000))));
+    for (size_t level = 0; level < 3; level++)
+    {
+        std::array<float, 64> positions;
+        std::array<Sample, 64> wrapped, unwrapped;
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] = static_cast<float>(buffer_size) - 20.f + 0.75f * static_cast<float>(i);
+        ring.read_at(*interpolator, level, positions.data(), wrapped.data(), positions.size());
+        for (size_t i = 0; i < positions.size(); i++)
+            ring.read_at(*interpolator, level, &positions[i], &unwrapped[i], 1);
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] += static_cast<float>(buffer_size);
+        std::array<Sample, 64> shifted;
+        ring.read_at(*interpolator, level, positions.data(), shifted.data(), positions.size());
+        idsp::test(wrapped == unwrapped, "Block and single reads match across the ends, " + tier);
+        idsp::test(wrapped == shifted, "Reads wrap by whole lengths, " + tier);
+
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] = 1000.f + 0.7f * static_cast<float>(i);
+        ring.read_at(*interpolator, level, positions.data(), wrapped.data(), positions.size());
+        for (size_t i = 0; i < positions.size(); i++)
+            ring.read_at(*interpolator, level, &positions[i], &unwrapped[i], 1);
+        idsp::test(wrapped == unwrapped, "Fast block reads match single reads, " + tier);
+    }
+
+    // Reads wrap by the buffer size, not the length, as the 4-point reads do
+    ring.set_length(buffer_size - 100);
+    for (size_t level = 0; level < 3; level++)
+    {
+        std::array<float, 64> positions;
+        std::array<Sample, 64> wrapped, unwrapped;
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] = 50.f + 0.75f * static_cast<float>(i);
+        ring.read_at(*interpolator, level, positions.data(), unwrapped.data(), positions.size());
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] += static_cast<float>(buffer_size);
+        ring.read_at(*interpolator, level, positions.data(), wrapped.data(), positions.size());
+        idsp::test(wrapped == unwrapped, "Reads past the length wrap by the buffer size, " + tier);
+    }
+
+    // A low tone passes at any fraction, and a tone above the reader's
+    // Nyquist is rejected at its level
+    const float sine_rms = std::sqrt(0.5f);
+    for (size_t level = 0; level < 3; level++)
+    {
+        const float ratio = static_cast<float>(1 << level) * 0.999f;
+        const float passed = read_sine_rms(*interpolator, level, 0.002f, ratio);
+        idsp::test_eq(passed, sine_rms, "Low tone passes at level " + std::to_string(level) + ", " + tier, 0.01f);
+    }
+    if (Taps >= 16)
+    {
+        for (size_t level = 1; level < 3; level++)
+        {
+            const float ratio = static_cast<float>(1 << level);
+            const float aliased = read_sine_rms(*interpolator, level, 0.75f / ratio, ratio);
+            idsp::test(aliased < 0.01f * sine_rms, "Tone above Nyquist rejected by 40 dB at level " + std::to_string(level) + ", " + tier);
+        }
+    }
+}
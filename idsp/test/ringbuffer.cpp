@@ -0,0 +1,323 @@
+#include "idsp/ringbuffer.hpp"
+#include "testers.hpp"
+
+#include "idsp/buffer_types.hpp"
+#include "idsp/midi.hpp"
+
+#include <thread>
+#include <vector>
+
+static constexpr size_t queue_size = 64;
+static constexpr uint32_t num_values = 1000000;
+
+void test_single_thread();
+void test_batch();
+void test_stress();
+void test_midi_queue();
+void test_audio_block();
+void test_masked();
+void test_arena();
+
+int main(int argc, const char* argv[])
+{
+    test_single_thread();
+    test_batch();
+    test_stress();
+    test_midi_queue();
+    test_audio_block();
+    test_masked();
+    test_arena();
+    return 0;
+}
+
+void test_single_thread()
+{
+    idsp::RingBuffer<int, 8> queue;
+    int value = -1;
+    idsp::test(queue.is_empty(), "New queue is empty");
+    idsp::test(!queue.read(value) && value == -1, "Read from empty queue fails");
+
+    for (int i = 0; i < 8; i++)
+        idsp::test(queue.write(i), "Write " + std::to_string(i));
+    idsp::test(queue.is_full(), "Queue is full after capacity writes");
+    idsp::test(!queue.write(8), "Write to full queue is rejected");
+    idsp::test_eq(queue.data_available(), size_t(8), "Full queue data available");
+
+    idsp::test_eq(queue.peek(), 0, "Peek oldest");
+    idsp::test_eq(queue.peek(7), 7, "Peek with offset");
+    for (int i = 0; i < 8; i++)
+        idsp::test_eq(queue.read(), i, "Read back in order");
+    idsp::test(queue.is_empty(), "Queue is empty after reading everything");
+
+    // Positions keep counting past the end of the storage
+    for (int i = 0; i < 100; i++)
+    {
+        queue.write(i);
+        queue.write(i + 1);
+        idsp::test_eq(queue.read(), i, "Wrapped read");
+        idsp::test_eq(queue.read(), i + 1, "Wrapped read");
+    }
+}
+
+void test_batch()
+{
+    idsp::RingBuffer<int, 16> queue;
+    std::vector<int> in(40), out(40);
+    for (size_t i = 0; i < in.size(); i++)
+        in[i] = static_cast<int>(i);
+
+    // Offset the positions so the batches straddle the end of the storage
+    for (int i = 0; i < 11; i++)
+    {
+        queue.write(i);
+        queue.read();
+    }
+
+    idsp::test_eq(queue.write(in.data(), 10), size_t(10), "Batch write");
+    idsp::test_eq(queue.write(in.data() + 10, 30), size_t(6), "Batch write is limited by free space");
+    idsp::test_eq(queue.space_available(), size_t(0), "No space after filling");
+    idsp::test_eq(queue.read(out.data(), 5), size_t(5), "Batch read");
+    idsp::test_eq(queue.read(out.data() + 5, 40), size_t(11), "Batch read is limited by available data");
+    for (size_t i = 0; i < 16; i++)
+        idsp::test_eq(out[i], in[i], "Batch value " + std::to_string(i));
+}
+
+void test_stress()
+{
+    idsp::RingBuffer<uint32_t, queue_size> queue;
+
+    // Producer alternates single and batch writes of a counting sequence
+    std::thread producer([&queue]() {
+        uint32_t next = 0;
+        std::array<uint32_t, 7> batch;
+        while (next < num_values)
+        {
+            const uint32_t previous = next;
+            if (next % 3 == 0)
+            {
+                if (queue.write(next))
+                    next++;
+            }
+            else
+            {
+                const size_t n = idsp::min<size_t>(batch.size(), num_values - next);
+                for (size_t i = 0; i < n; i++)
+                    batch[i] = next + static_cast<uint32_t>(i);
+                next += static_cast<uint32_t>(queue.write(batch.data(), n));
+            }
+            // Let the consumer run if the host has fewer cores than threads
+            if (next == previous)
+                std::this_thread::yield();
+        }
+    });
+
+    // Consumer alternates single and batch reads and checks the sequence
+    uint32_t expected = 0;
+    bool in_order = true;
+    std::array<uint32_t, 5> batch;
+    while (expected < num_values)
+    {
+        if (queue.is_empty())
+            std::this_thread::yield();
+        else if (expected % 2 == 0)
+        {
+            uint32_t value;
+            if (queue.read(value))
+                in_order = value == expected++;
+        }
+        else
+        {
+            const size_t n = queue.read(batch.data(), batch.size());
+            for (size_t i = 0; i < n; i++)
+                in_order = in_order && batch[i] == expected++;
+        }
+    }
+    producer.join();
+
+    idsp::test(in_order, "Values arrive complete and in order, failed at " + std::to_string(expected));
+    idsp::test(queue.is_empty(), "Queue drained");
+}
+
+void test_midi_queue()
+{
+    idsp::Midi14bitInterface midi;
+    idsp::test(midi.set_int_value(1, 64), "Queue MIDI message");
+    idsp::test_eq(midi.messages_to_read(), size_t(1), "MIDI message available");
+    const auto message = midi.get_message();
+    idsp::test(message.cc == 1 && message.msb == 64, "MIDI message contents");
+
+    size_t queued = 0;
+    while (midi.set_bool_value(2, true))
+        queued++;
+    idsp::test_eq(queued, size_t(128), "MIDI queue drops messages when full");
+}
+
+void test_audio_block()
+{
+    // Block calls of odd sizes straddle the end of the buffer and must match
+    // the per-sample calls exactly
+    constexpr size_t length = 37;
+    idsp::SampleBufferStatic<length> buffer_a, buffer_b;
+    idsp::AudioRingBuffer ring_a(buffer_a), ring_b(buffer_b);
+    std::array<Sample, 23> block, expected;
+    Sample next = 1;
+
+    for (size_t round = 0; round < 20; round++)
+    {
+        for (auto& x : block)
+            x = next++;
+        for (size_t i = 0; i < block.size(); i++)
+            expected[i] = ring_a.process(block[i]);
+        idsp::BufferInterface io(block.data(), block.size());
+        ring_b.process(io, io);
+        for (size_t i = 0; i < block.size(); i++)
+            idsp::test_eq(block[i], expected[i], "In-place block process");
+        idsp::test_eq(ring_b.get_index(), ring_a.get_index(), "Block process advances the write index");
+    }
+
+    for (size_t round = 0; round < 20; round++)
+    {
+        const size_t offset = block.size() + round % 10;
+        for (size_t i = 0; i < block.size(); i++)
+        {
+            expected[i] = ring_a.read_offset(offset);
+            ring_a.write(next + static_cast<Sample>(i));
+        }
+        std::array<Sample, 23> input;
+        for (size_t i = 0; i < input.size(); i++)
+            input[i] = next + static_cast<Sample>(i);
+        next += static_cast<Sample>(input.size());
+
+        ring_b.read_block(offset, block.data(), block.size());
+        ring_b.write(idsp::BufferInterface(input.data(), input.size()));
+        for (size_t i = 0; i < block.size(); i++)
+            idsp::test_eq(block[i], expected[i], "Block read at offset " + std::to_string(offset));
+    }
+
+    // Block 4-point reads match the per-sample reads they stand in for
+    std::array<float, 16> offsets;
+    for (size_t i = 0; i < offsets.size(); i++)
+        offsets[i] = 18.25f + 0.3f * static_cast<float>(i % 5);
+    idsp::test(ring_b.can_read_block(offsets.data(), offsets.size()), "Offsets are far enough behind the block");
+    std::array<Sample, 16> smooth;
+    ring_b.read_offset_smooth_wrap(offsets.data(), smooth.data(), smooth.size());
+    for (size_t i = 0; i < offsets.size(); i++)
+    {
+        idsp::test_eq(smooth[i], ring_a.read_offset_smooth_wrap(offsets[i]), "Block smooth read");
+        ring_a.write(Sample(0));
+    }
+    offsets[10] = 12.f;
+    idsp::test(!ring_b.can_read_block(offsets.data(), offsets.size()), "Offset inside the block is rejected");
+
+    // Block reads at positions wrap by the buffer size, as the single reads
+    // do, when the length is set below it
+    idsp::SampleBufferStatic<length> buffer_c;
+    for (size_t i = 0; i < length; i++)
+        buffer_c[i] = static_cast<Sample>(i * i % 17);
+    idsp::AudioRingBuffer ring_c(buffer_c);
+    ring_c.set_length(30);
+    for (float start : {31.f, 40.f})
+    {
+        std::array<float, 16> positions;
+        for (size_t i = 0; i < positions.size(); i++)
+            positions[i] = start + 0.3f * static_cast<float>(i);
+        ring_c.read_at_smooth_safe(positions.data(), smooth.data(), smooth.size());
+        for (size_t i = 0; i < positions.size(); i++)
+            idsp::test_eq(smooth[i], ring_c.read_at_smooth_safe(positions[i]), "Block read past the length");
+    }
+}
+
+template<bool Mirrored>
+static void test_masked_against_reference()
+{
+    // With the full capacity as its length, the masked buffer must read back
+    // exactly what an AudioRingBuffer of the same size does
+    constexpr size_t size = 64;
+    using Masked = idsp::MaskedAudioRingBuffer<size, Mirrored>;
+    const std::string name = Mirrored ? "Mirrored masked " : "Masked ";
+    idsp::SampleBufferStatic<size> reference_buffer;
+    idsp::SampleBufferStatic<Masked::storage_size> masked_buffer;
+    idsp::AudioRingBuffer reference(reference_buffer);
+    Masked masked(masked_buffer);
+
+    std::array<Sample, 29> block;
+    Sample next = 1;
+    for (size_t round = 0; round < 12; round++)
+    {
+        for (size_t i = 0; i < block.size(); i++)
+        {
+            const Sample x = next++;
+            if (round % 2)
+                idsp::test_eq(masked.process(x), reference.process(x), name + "process");
+            else
+            {
+                block[i] = x;
+                reference.write(x);
+            }
+        }
+        if (round % 2 == 0)
+            masked.write(block.data(), block.size());
+        idsp::test_eq(masked.get_index(), reference.get_index(), name + "write index");
+
+        for (size_t offset = 1; offset <= size; offset++)
+            idsp::test_eq(masked.read_offset(offset), reference.read_offset(offset), name + "read_offset " + std::to_string(offset));
+        for (float offset = 2.f; offset < static_cast<float>(size); offset += 0.37f)
+            idsp::test_eq(masked.read_offset_smooth(offset), reference.read_offset_smooth_wrap(offset), name + "read_offset_smooth " + std::to_string(offset), Sample(1e-3));
+        for (float offset = -10.f; offset < 2.f; offset += 0.37f)
+            idsp::test_eq(masked.read_offset_smooth(offset), reference.read_offset_smooth_wrap(offset), name + "negative read_offset_smooth " + std::to_string(offset), Sample(1e-3));
+
+        std::array<Sample, 40> expected, actual;
+        reference.read_block(40, expected.data(), expected.size());
+        masked.read_block(40, actual.data(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++)
+            idsp::test_eq(actual[i], expected[i], name + "read_block");
+    }
+
+    // Shorter lengths delay by exactly that many samples
+    masked.set_length(5);
+    idsp::SampleBufferStatic<16> io;
+    for (size_t i = 0; i < io.size(); i++)
+        io[i] = Sample(1000 + i);
+    masked.process(io.interface(), io.interface());
+    for (size_t i = 5; i < io.size(); i++)
+        idsp::test_eq(io[i], Sample(1000 + i - 5), name + "set_length block process");
+    idsp::test_eq(masked.process(Sample(0)), Sample(1000 + 16 - 5), name + "set_length process");
+}
+
+void test_masked()
+{
+    test_masked_against_reference<false>();
+    test_masked_against_reference<true>();
+    idsp::test_eq(idsp::next_power_of_two(size_t(576)), size_t(1024), "next_power_of_two");
+    idsp::test_eq(idsp::next_power_of_two(size_t(512)), size_t(512), "next_power_of_two of a power of two");
+}
+
+void test_arena()
+{
+    // Buffers are laid out in order, each on a 16-byte boundary
+    idsp::SampleBufferArena<3, 5, 8, 1> arena;
+    const std::array<size_t, 4> sizes {3, 5, 8, 1};
+    idsp::test_eq(arena.size(), size_t(4), "Arena buffer count");
+    for (size_t n = 0; n < sizes.size(); n++)
+    {
+        idsp::test_eq(arena[n].size(), sizes[n], "Arena buffer " + std::to_string(n) + " size");
+        idsp::test_eq(reinterpret_cast<uintptr_t>(arena[n].data()) % 16, uintptr_t(0), "Arena buffer " + std::to_string(n) + " alignment");
+        if (n > 0)
+            idsp::test(arena[n].data() >= arena[n - 1].data() + sizes[n - 1], "Arena buffers don't overlap");
+    }
+    idsp::test(arena[3].data() + 1 <= arena[0].data() + decltype(arena)::total_size, "Arena total size covers every buffer");
+
+    // Neighbouring delay lines keep their own samples
+    idsp::AudioRingBuffer first(arena[0]), second(arena[1]);
+    for (int i = 0; i < 20; i++)
+    {
+        first.write(Sample(1.f));
+        second.write(Sample(-1.f));
+    }
+    bool separate = true;
+    for (size_t i = 0; i < sizes[0]; i++)
+        separate = separate && arena[0][i] == Sample(1.f);
+    for (size_t i = 0; i < sizes[1]; i++)
+        separate = separate && arena[1][i] == Sample(-1.f);
+    idsp::test(separate, "Arena delay lines are separate");
+}